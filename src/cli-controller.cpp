@@ -95,27 +95,63 @@ void CliController::runCli(DataType dataType, GTree* gTree) {
         bool validAlgorithm = false;
         string algorithm;
         while(!validAlgorithm) {
-            cout << "Which algorithm do you want to use? \nThe options are (enter the abbrevation): compare all algorithms (a), naive raptor algorithm (n), raptor first algorithm (r), raptor pq algorithm (q), raptor bound algorithm (b), raptor select algorithm (x), raptor select algorithm with candidates (c), raptor select loop algorithm (l)." << endl;
+            cout << "Which algorithm do you want to use? \nThe options are (enter the abbrevation): compare all algorithms (a), naive raptor algorithm (n), raptor first algorithm (r), raptor pq algorithm (q), raptor pq work stealing algorithm (w), raptor bound algorithm (b), raptor select algorithm (x), raptor select algorithm with candidates (c), raptor select loop algorithm (l)." << endl;
             getline(cin, algorithm);
-            if (algorithm == "a" || algorithm == "n" || algorithm == "r" || algorithm == "q" || algorithm == "b" || algorithm == "x" || algorithm == "c" || algorithm == "l") {
+            if (algorithm == "a" || algorithm == "n" || algorithm == "r" || algorithm == "q" || algorithm == "w" || algorithm == "b" || algorithm == "x" || algorithm == "c" || algorithm == "l") {
                 validAlgorithm = true;
             } else {
                 cout << "Invalid algorithm. Please enter the abbrevation of a valid algorithm." << endl;
             }
         }
 
+        int numberOfMeetingPoints = 1;
+        double minimumDistance = 0;
+        if (algorithm == "q" || algorithm == "w" || algorithm == "b") {
+            cout << "How many meeting points do you want to get? (default: 1)" << endl;
+            string numberOfMeetingPointsInput;
+            getline(cin, numberOfMeetingPointsInput);
+            try {
+                numberOfMeetingPoints = max(1, stoi(numberOfMeetingPointsInput));
+            } catch (invalid_argument& e) {
+                numberOfMeetingPoints = 1;
+            } catch (out_of_range& e) {
+                cout << "The number of meeting points is too large, one meeting point is used." << endl;
+                numberOfMeetingPoints = 1;
+            }
+
+            if (numberOfMeetingPoints > 1) {
+                cout << "Enter the minimum distance between the meeting points in km (default: 0):" << endl;
+                string minimumDistanceInput;
+                getline(cin, minimumDistanceInput);
+                try {
+                    minimumDistance = max(0.0, stod(minimumDistanceInput));
+                } catch (invalid_argument& e) {
+                    minimumDistance = 0;
+                } catch (out_of_range& e) {
+                    cout << "The minimum distance is out of range, no minimum distance is used." << endl;
+                    minimumDistance = 0;
+                }
+            }
+        }
+
         cout << "\nRunning the query..." << endl;
 
         if (algorithm == "a") {
-            AlgorithmComparer::compareAlgorithmsWithoutGTree(dataType, query);
+            if (gTree != nullptr) {
+                AlgorithmComparer::compareAlgorithms(dataType, gTree, query);
+            } else {
+                AlgorithmComparer::compareAlgorithmsWithoutGTree(dataType, query);
+            }
         } else if (algorithm == "n") {
             RaptorAlgorithmTester::testRaptorAlgorithm(query, true);
         } else if (algorithm == "r") {
             RaptorAlgorithmTester::testRaptorFirstAlgorithm(query, true);
         } else if (algorithm == "q") {
-            RaptorPQAlgorithmTester::testRaptorPQAlgorithm(query, true);
+            RaptorPQAlgorithmTester::testRaptorPQAlgorithm(query, true, false, numberOfMeetingPoints, minimumDistance);
+        } else if (algorithm == "w") {
+            RaptorPQAlgorithmTester::testRaptorPQAlgorithm(query, true, true, numberOfMeetingPoints, minimumDistance);
         } else if (algorithm == "b") {
-            RaptorBoundAlgorithmTester::testRaptorBoundAlgorithm(query, true);
+            RaptorBoundAlgorithmTester::testRaptorBoundAlgorithm(query, true, numberOfMeetingPoints, minimumDistance);
         } else if (algorithm == "x") {
             RaptorApproximationAlgorithmTester::testRaptorApproximationAlgorithm(query, false);
         } else if (algorithm == "c") {
@@ -209,9 +245,9 @@ void CliController::runCliEat(DataType dataType) {
         bool validAlgorithm = false;
         string algorithm;
         while(!validAlgorithm) {
-            cout << "Which algorithm do you want to use? \nThe options are (enter the abbrevation): compare all algorithms (a), basic raptor algorithm (r), raptor bound star algorithm (b), raptor pq star algorithm (q)." << endl;
+            cout << "Which algorithm do you want to use? \nThe options are (enter the abbrevation): compare all algorithms (a), basic raptor algorithm (r), raptor bound star algorithm (b), raptor pq star algorithm (q), time dependent contraction hierarchie (t)." << endl;
             getline(cin, algorithm);
-            if (algorithm == "a" || algorithm == "r" || algorithm == "q" || algorithm == "b") {
+            if (algorithm == "a" || algorithm == "r" || algorithm == "q" || algorithm == "b" || algorithm == "t") {
                 validAlgorithm = true;
             } else {
                 cout << "Invalid algorithm. Please enter the abbrevation of a valid algorithm." << endl;
@@ -228,6 +264,8 @@ void CliController::runCliEat(DataType dataType) {
             RaptorEATAlgorithmTester::testRaptorStarPQAlgorithm(query, true);
         } else if (algorithm == "b") {
             RaptorEATAlgorithmTester::testRaptorStarBoundAlgorithm(query, true);
+        } else if (algorithm == "t") {
+            RaptorEATAlgorithmTester::testTDCHAlgorithm(query);
         }
 
         cout << "\nDo you want to run another query? (y/N)" << endl;
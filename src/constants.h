@@ -2,24 +2,54 @@
 #define CMAKE_HEADER_H
 
 #include <string>
+#include <climits>
 
 const string FOLDER_PREFIX = "";
 //const string FOLDER_PREFIX = "../../";
 
 constexpr int SECONDS_PER_DAY = 86400;
 constexpr int MIN_COARSE_GRAPH_VERTEX_DIFF = 10;
-constexpr int KL_ITERATIONS = 100;
-constexpr int KL_MAX_UNUSED_SWAPS = 300;
+constexpr int INITIAL_PARTITION_TRIES = 10;
+constexpr int FM_MAX_PASSES = 10;
+constexpr int FM_MAX_UNUSED_MOVES = 50;
+constexpr double PARTITION_IMBALANCE = 0.03;
+constexpr int PARTITION_SEED = 42;
 
 constexpr int LOWER_BOUND_FACTOR = 1;
 constexpr bool USE_LANDMARKS = true;
+constexpr bool USE_SOURCE_PROFILES = false;
+constexpr bool USE_COMPACT_LABELS = false;
+constexpr int COMPACT_LABEL_UNREACHED = (1 << 24) - 1;
+constexpr int COMPACT_LANDMARK_UNREACHED = 65535;
+constexpr int COMPACT_LANDMARK_RESOLUTION = 60;
 
 constexpr double GTREE_APPROXIMATION_ALPHA = 1;
+constexpr int GTREE_BINARY_VERSION = 1;
+// optional lower bounds of the G-tree per weekday and time bucket, the bucket length plus the horizon must not exceed one day
+constexpr bool USE_GTREE_TIME_BUCKETS = false;
+constexpr int GTREE_TIME_BUCKET_LENGTH = 4 * 3600;
+constexpr int GTREE_TIME_BUCKET_HORIZON = 8 * 3600;
+// map the duration matrices of the binary G-tree file instead of reading them, at most the cache size stays resident
+constexpr bool USE_LAZY_GTREE = false;
+constexpr int GTREE_NODE_CACHE_SIZE_IN_MB = 256;
+// the parameter tuning calculates the durations of several candidate trees at once as long as their matrices fit into the budget
+constexpr int GTREE_TUNING_MEMORY_BUDGET_IN_MB = 8000;
 
 constexpr int NUMBER_OF_DAYS = 4;
 
 constexpr bool USE_FOOTPATHS = true;
+constexpr bool REORDER_STOPS = false;
+constexpr int HILBERT_CURVE_ORDER = 16;
 
 constexpr int NUMBER_OF_LANDMARKS = 25;
 
+constexpr int WORK_STEALING_BATCH_SIZE = 8;
+
+constexpr int PHAST_SOURCE_BLOCK_SIZE = 16;
+constexpr int PHAST_INFINITY = INT_MAX / 2;
+
+constexpr int SECONDS_PER_WEEK = 7 * SECONDS_PER_DAY;
+constexpr int TDCH_WITNESS_SEARCH_LIMIT = 50;
+constexpr double TDCH_CORE_FRACTION = 0.02;
+
 #endif //CMAKE_HEADER_H
\ No newline at end of file
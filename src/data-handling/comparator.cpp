@@ -26,4 +26,12 @@ bool TripDepartureTimePairComparator::compareByDepartureTime(TripDepartureTimePa
 
 bool FootPathComparator::compareByArrivalStop(FootPath footPath1, FootPath footPath2) {
     return footPath1.arrivalStopId < footPath2.arrivalStopId;
+}
+
+bool FootPathComparator::compareByDepartureStop(FootPath footPath1, FootPath footPath2) {
+    if (footPath1.departureStopId == footPath2.departureStopId) {
+        return footPath1.arrivalStopId < footPath2.arrivalStopId;
+    }
+
+    return footPath1.departureStopId < footPath2.departureStopId;
 }
\ No newline at end of file
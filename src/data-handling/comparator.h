@@ -37,6 +37,7 @@ class FootPathComparator {
         ~FootPathComparator(){};
 
         static bool compareByArrivalStop(FootPath footPath1, FootPath footPath2);
+        static bool compareByDepartureStop(FootPath footPath1, FootPath footPath2);
 };
 
 
@@ -41,6 +41,8 @@ vector<FootPath> Importer::footPaths = vector<FootPath>(0);
 vector<FootPath> Importer::footPathsBackward = vector<FootPath>(0);
 vector<int> Importer::indexOfFirstFootPathOfAStop = vector<int>(0);
 vector<int> Importer::indexOfFirstFootPathOfAStopBackward = vector<int>(0);
+vector<int> Importer::externalStopIds = vector<int>(0);
+vector<int> Importer::internalStopIds = vector<int>(0);
 
 /*
     Import the data from the GTFS files and prepare it for the algorithms.
@@ -70,6 +72,9 @@ void Importer::import(string folderName, bool prepareData, DataType dataType) {
         clearAndSortTrips();
         generateSortedConnections();
         loadOrGenerateFootPaths(dataType);
+        if (REORDER_STOPS) {
+            reorderStopsRoutesAndTrips();
+        }
     }
 
     // Stop the timer and calculate the duration
@@ -715,6 +720,181 @@ void Importer::exportFootPaths(DataType dataType) {
     file.close();
 }
 
+/*
+    Renumber the stops along a hilbert curve over their coordinates, so that stops which are close to each other get close ids and
+    the stop indexed arrays of the algorithms are accessed with a better cache locality. The routes are ordered by the new id of
+    their first stop and the trips by their route and departure time, so that the stop times of a route are stored contiguously.
+    The files keep the stop ids of the import, they are mapped with getExternalStopId and getInternalStopId.
+*/
+void Importer::reorderStopsRoutesAndTrips() {
+    int numberOfStops = stops.size();
+
+    double minLat = 90, maxLat = -90, minLon = 180, maxLon = -180;
+    for (int i = 0; i < numberOfStops; i++) {
+        minLat = min(minLat, stops[i].lat);
+        maxLat = max(maxLat, stops[i].lat);
+        minLon = min(minLon, stops[i].lon);
+        maxLon = max(maxLon, stops[i].lon);
+    }
+    double latRange = max(maxLat - minLat, 1e-9);
+    double lonRange = max(maxLon - minLon, 1e-9);
+    int maxCoordinate = (1 << HILBERT_CURVE_ORDER) - 1;
+
+    vector<pair<long long, int>> hilbertIndexStopIdPairs = vector<pair<long long, int>>(numberOfStops);
+    for (int i = 0; i < numberOfStops; i++) {
+        int x = (stops[i].lon - minLon) / lonRange * maxCoordinate;
+        int y = (stops[i].lat - minLat) / latRange * maxCoordinate;
+        hilbertIndexStopIdPairs[i] = make_pair(getHilbertIndex(x, y), i);
+    }
+    sort(hilbertIndexStopIdPairs.begin(), hilbertIndexStopIdPairs.end());
+
+    externalStopIds = vector<int>(numberOfStops);
+    internalStopIds = vector<int>(numberOfStops);
+    for (int i = 0; i < numberOfStops; i++) {
+        externalStopIds[i] = hilbertIndexStopIdPairs[i].second;
+        internalStopIds[hilbertIndexStopIdPairs[i].second] = i;
+    }
+
+    // renumber the stops
+    vector<Stop> newStops = vector<Stop>(numberOfStops);
+    vector<vector<RouteSequencePair>> newRoutesOfAStop = vector<vector<RouteSequencePair>>(numberOfStops);
+    for (int i = 0; i < numberOfStops; i++) {
+        newStops[i] = stops[externalStopIds[i]];
+        newStops[i].id = i;
+        newRoutesOfAStop[i] = routesOfAStop[externalStopIds[i]];
+    }
+    stops = newStops;
+    routesOfAStop = newRoutesOfAStop;
+
+    for (int i = 0; i < stopTimes.size(); i++) {
+        stopTimes[i].stopId = internalStopIds[stopTimes[i].stopId];
+    }
+    for (int i = 0; i < connections.size(); i++) {
+        connections[i].departureStopId = internalStopIds[connections[i].departureStopId];
+        connections[i].arrivalStopId = internalStopIds[connections[i].arrivalStopId];
+    }
+    for (int i = 0; i < stopsOfARoute.size(); i++) {
+        for (int j = 0; j < stopsOfARoute[i].size(); j++) {
+            stopsOfARoute[i][j] = internalStopIds[stopsOfARoute[i][j]];
+        }
+    }
+
+    for (int i = 0; i < footPaths.size(); i++) {
+        footPaths[i].departureStopId = internalStopIds[footPaths[i].departureStopId];
+        footPaths[i].arrivalStopId = internalStopIds[footPaths[i].arrivalStopId];
+    }
+    sort(footPaths.begin(), footPaths.end(), FootPathComparator::compareByDepartureStop);
+    footPathsBackward = footPaths;
+    sort(footPathsBackward.begin(), footPathsBackward.end(), FootPathComparator::compareByArrivalStop);
+
+    indexOfFirstFootPathOfAStop = vector<int>(numberOfStops, footPaths.size());
+    indexOfFirstFootPathOfAStopBackward = vector<int>(numberOfStops, footPathsBackward.size());
+    for (int i = footPaths.size() - 1; i >= 0; i--) {
+        indexOfFirstFootPathOfAStop[footPaths[i].departureStopId] = i;
+        indexOfFirstFootPathOfAStopBackward[footPathsBackward[i].arrivalStopId] = i;
+    }
+
+    // order the routes by the new id of their first stop
+    vector<int> oldRouteIds = vector<int>(routes.size());
+    for (int i = 0; i < routes.size(); i++) {
+        oldRouteIds[i] = i;
+    }
+    stable_sort(oldRouteIds.begin(), oldRouteIds.end(), [](int routeId1, int routeId2) {
+        return stopsOfARoute[routeId1][0] < stopsOfARoute[routeId2][0];
+    });
+
+    vector<int> newRouteIds = vector<int>(routes.size());
+    vector<Route> newRoutes = vector<Route>(routes.size());
+    vector<vector<int>> newTripsOfARoute = vector<vector<int>>(routes.size());
+    vector<vector<int>> newStopsOfARoute = vector<vector<int>>(routes.size());
+    for (int i = 0; i < routes.size(); i++) {
+        newRouteIds[oldRouteIds[i]] = i;
+        newRoutes[i] = routes[oldRouteIds[i]];
+        newRoutes[i].id = i;
+        newTripsOfARoute[i] = tripsOfARoute[oldRouteIds[i]];
+        newStopsOfARoute[i] = stopsOfARoute[oldRouteIds[i]];
+    }
+    routes = newRoutes;
+    tripsOfARoute = newTripsOfARoute;
+    stopsOfARoute = newStopsOfARoute;
+
+    for (int i = 0; i < numberOfStops; i++) {
+        for (int j = 0; j < routesOfAStop[i].size(); j++) {
+            routesOfAStop[i][j].routeId = newRouteIds[routesOfAStop[i][j].routeId];
+        }
+    }
+
+    // order the trips by their route and departure time, trips without a route are kept at the end
+    vector<int> oldTripIds = vector<int>(0);
+    vector<int> newTripIds = vector<int>(trips.size(), -1);
+    for (int i = 0; i < routes.size(); i++) {
+        for (int j = 0; j < tripsOfARoute[i].size(); j++) {
+            int tripId = tripsOfARoute[i][j];
+            trips[tripId].routeId = i;
+            newTripIds[tripId] = oldTripIds.size();
+            oldTripIds.push_back(tripId);
+            tripsOfARoute[i][j] = newTripIds[tripId];
+        }
+    }
+    for (int i = 0; i < trips.size(); i++) {
+        if (newTripIds[i] == -1) {
+            newTripIds[i] = oldTripIds.size();
+            oldTripIds.push_back(i);
+        }
+    }
+
+    vector<Trip> newTrips = vector<Trip>(trips.size());
+    vector<StopTime> newStopTimes = vector<StopTime>(0);
+    newStopTimes.reserve(stopTimes.size());
+    vector<int> newIndexOfFirstStopTimeOfATrip = vector<int>(trips.size(), 0);
+    for (int i = 0; i < trips.size(); i++) {
+        int oldTripId = oldTripIds[i];
+        newTrips[i] = trips[oldTripId];
+        newTrips[i].id = i;
+
+        int indexOfFirstStopTime = indexOfFirstStopTimeOfATrip[oldTripId];
+        if (indexOfFirstStopTime >= stopTimes.size() || stopTimes[indexOfFirstStopTime].tripId != oldTripId) {
+            continue;
+        }
+        newIndexOfFirstStopTimeOfATrip[i] = newStopTimes.size();
+        for (int j = indexOfFirstStopTime; j < stopTimes.size() && stopTimes[j].tripId == oldTripId; j++) {
+            StopTime stopTime = stopTimes[j];
+            stopTime.tripId = i;
+            newStopTimes.push_back(stopTime);
+        }
+    }
+    trips = newTrips;
+    stopTimes = newStopTimes;
+    indexOfFirstStopTimeOfATrip = newIndexOfFirstStopTimeOfATrip;
+
+    for (int i = 0; i < connections.size(); i++) {
+        connections[i].tripId = newTripIds[connections[i].tripId];
+    }
+
+    cout << "Reordered " << stops.size() << " stops, " << routes.size() << " routes and " << trips.size() << " trips." << endl;
+}
+
+/*
+    Calculate the position of a cell on the hilbert curve that fills the grid of the given order.
+*/
+long long Importer::getHilbertIndex(int x, int y) {
+    long long hilbertIndex = 0;
+    int gridSize = 1 << HILBERT_CURVE_ORDER;
+    for (int s = gridSize / 2; s > 0; s /= 2) {
+        int rx = (x & s) > 0;
+        int ry = (y & s) > 0;
+        hilbertIndex += (long long) s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = gridSize - 1 - x;
+                y = gridSize - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return hilbertIndex;
+}
+
 /*
     Get the stop times of a trip ordered by their sequence.
 */
@@ -791,6 +971,26 @@ int Importer::getStopId(string stopName) {
     return -1;
 }
 
+/*
+    Get the stop id of a stop in the files, they keep the stop ids of the import before the stops were renumbered.
+*/
+int Importer::getExternalStopId(int stopId) {
+    if (stopId < 0 || externalStopIds.empty()) {
+        return stopId;
+    }
+    return externalStopIds[stopId];
+}
+
+/*
+    Get the stop id of a stop that is read from a file.
+*/
+int Importer::getInternalStopId(int externalStopId) {
+    if (externalStopId < 0 || internalStopIds.empty()) {
+        return externalStopId;
+    }
+    return internalStopIds[externalStopId];
+}
+
 /*
     Get the data type as a string.
 */
@@ -120,6 +120,9 @@ class Importer {
         static string getStopName(int stopId);
         static int getStopId(string stopName);
 
+        static int getExternalStopId(int stopId);
+        static int getInternalStopId(int externalStopId);
+
         static string getDataTypeString(DataType dataType);
 
     private:
@@ -129,6 +132,10 @@ class Importer {
         static map<string, int> stopIdOldToNew;
         static map<string, int> tripIdOldToNew;
 
+        // The stop ids of the files (external) and the renumbered stop ids (internal)
+        static vector<int> externalStopIds;
+        static vector<int> internalStopIds;
+
         static vector<string> splitCsvLine(string &line);
 
         static void importCalendars(string folderPath, DataType dataType);
@@ -146,6 +153,8 @@ class Importer {
         static void generateFootPaths();
         static void exportFootPaths(DataType dataType);
         static void importFootPaths(DataType dataType);
+        static void reorderStopsRoutesAndTrips();
+        static long long getHilbertIndex(int x, int y);
 };
 
 #endif //CMAKE_IMPORTER_H
\ No newline at end of file
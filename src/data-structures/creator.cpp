@@ -12,12 +12,19 @@
 #include <cmath>
 #include <algorithm>
 #include <fstream>
+#include <queue>
 
 using namespace std;
 
 Graph Creator::networkGraph = Graph();
+TimeDependentGraph Creator::timeDependentGraph = TimeDependentGraph();
+CustomizableCH Creator::customizableCH = CustomizableCH();
 
 void Creator::loadOrCreateNetworkGraph(DataType dataType) {
+    if (networkGraph.importGraphWithCHBinary(dataType)) {
+        return;
+    }
+
     string dataTypeString = Importer::getDataTypeString(dataType);
     string folderPath = FOLDER_PREFIX + "graphs/" + dataTypeString + "/";
     string fileName = folderPath + "graph-withCH";
@@ -38,6 +45,28 @@ void Creator::loadOrCreateNetworkGraph(DataType dataType) {
     }
 
     file.close();
+
+    networkGraph.exportGraphWithCHBinary(dataType);
+}
+
+/*
+    Returns the customizable contraction hierarchie, its topology is created from the order of the network graph with the first call.
+*/
+CustomizableCH* Creator::getCustomizableCH() {
+    if (!customizableCH.isCreated()) {
+        customizableCH.createTopology(networkGraph.getStopIdsSortedByLevel());
+    }
+    return &customizableCH;
+}
+
+/*
+    Returns the time dependent contraction hierarchie, it is created with the first call.
+*/
+TimeDependentGraph* Creator::getTimeDependentGraph() {
+    if (!timeDependentGraph.isCreated()) {
+        timeDependentGraph.createContractionHierarchie();
+    }
+    return &timeDependentGraph;
 }
 
 /*
@@ -170,6 +199,73 @@ void Creator::createNetworkGraph() {
     cout << "Network graph creation duration: " << duration << " milliseconds\n" << endl;
 }
 
+/*
+    Create the adjacency list of the network graph that only contains the connections which depart in the time window of the weekday. 
+    The window can reach into the next day. Like in the network graph the foot paths are always available and every edge gets a back edge.
+*/
+vector<vector<Edge>> Creator::createTimeWindowAdjacencyList(int weekday, int startTime, int endTime) {
+    vector<vector<Edge>> adjacencyList = vector<vector<Edge>>(Importer::stops.size(), vector<Edge>(0));
+
+    // keep the minimal weight of every edge and its back edge
+    auto addEdge = [&adjacencyList](int sourceStopId, int targetStopId, int weight) {
+        for (int direction = 0; direction < 2; direction++) {
+            int fromStopId = direction == 0 ? sourceStopId : targetStopId;
+            int toStopId = direction == 0 ? targetStopId : sourceStopId;
+            bool foundEdge = false;
+            for (int i = 0; i < adjacencyList[fromStopId].size(); i++) {
+                if (adjacencyList[fromStopId][i].targetStopId == toStopId) {
+                    adjacencyList[fromStopId][i].ewgt = min(adjacencyList[fromStopId][i].ewgt, weight);
+                    foundEdge = true;
+                    break;
+                }
+            }
+            if (!foundEdge) {
+                Edge edge;
+                edge.targetStopId = toStopId;
+                edge.ewgt = weight;
+                adjacencyList[fromStopId].push_back(edge);
+            }
+        }
+    };
+
+    for (int i = 0; i < Importer::connections.size(); i++) {
+        Connection &connection = Importer::connections[i];
+        int connectionArrivalTime = connection.arrivalTime;
+        if (connectionArrivalTime < connection.departureTime) {
+            connectionArrivalTime += SECONDS_PER_DAY;
+        }
+
+        int firstDepartureTimeOfTrip = Importer::stopTimes[Importer::indexOfFirstStopTimeOfATrip[connection.tripId]].departureTime;
+
+        // the connection departs once on the weekday and once on the next day, the trip is available like in the csa
+        for (int dayOffset = 0; dayOffset < 2; dayOffset++) {
+            int departureTime = connection.departureTime + dayOffset * SECONDS_PER_DAY;
+            if (departureTime < startTime || departureTime >= endTime) {
+                continue;
+            }
+
+            int weekdayOfTrip = (weekday + dayOffset) % 7;
+            if (firstDepartureTimeOfTrip > connection.departureTime) {
+                weekdayOfTrip = (weekdayOfTrip + 6) % 7;
+            }
+
+            if (Importer::isTripAvailable(connection.tripId, weekdayOfTrip)) {
+                addEdge(connection.departureStopId, connection.arrivalStopId, connectionArrivalTime - connection.departureTime);
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < Importer::footPaths.size(); i++) {
+        FootPath &footPath = Importer::footPaths[i];
+        if (footPath.departureStopId != footPath.arrivalStopId) {
+            addEdge(footPath.departureStopId, footPath.arrivalStopId, footPath.duration);
+        }
+    }
+
+    return adjacencyList;
+}
+
 /*
     Use the network graph to create the network g-tree.
 */
@@ -227,56 +323,112 @@ GTree* Creator::createNetworkGTree(DataType dataType, int numberOfChildrenPerNod
 }
 
 /*
-    Partitionate the graph into a number of partitions. Use the multilevel graph partitioning algorithm.
+    Partitionate the graph into a number of partitions. Use the multilevel graph partitioning algorithm. The graphs of a level are 
+    bisected in parallel and every bisection uses its own seeded random generator, so the result doesn't depend on the threads.
 */
-vector<Graph> Creator::partitionateGraph(Graph graph, int numberOfPartitions, int maxNumberOfVerticesInGraph) {
-    vector<Graph> previousGraphs = vector<Graph>(0);
-    previousGraphs.push_back(graph);
+vector<Graph> Creator::partitionateGraph(Graph &graph, int numberOfPartitions, int maxNumberOfVerticesInGraph) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    vector<PartitionGraph> previousGraphs = vector<PartitionGraph>(0);
+    previousGraphs.push_back(createPartitionGraph(graph));
 
     while(previousGraphs.size() < numberOfPartitions) {
-        vector<Graph> newGraphs = vector<Graph>(0);
+        vector<vector<PartitionGraph>> partitionatedGraphsOfGraphs = vector<vector<PartitionGraph>>(previousGraphs.size());
 
+        #pragma omp parallel for schedule(dynamic)
         for (int j = 0; j < previousGraphs.size(); j++) {
-            vector<Graph> coarsedGraphs = coarseGraph(previousGraphs[j], maxNumberOfVerticesInGraph);
-            // cout << "Coarsed graph" << endl;
-            partitionateCoarsedGraph(coarsedGraphs[coarsedGraphs.size()-1], KL_ITERATIONS);
-            // cout << "Partitionated graph" << endl;
+            mt19937 randomGenerator = mt19937(PARTITION_SEED + previousGraphs.size() + j);
+            vector<PartitionGraph> coarsedGraphs = coarseGraph(previousGraphs[j], maxNumberOfVerticesInGraph, randomGenerator);
+            partitionateCoarsedGraph(coarsedGraphs[coarsedGraphs.size()-1], randomGenerator);
             refineGraphs(coarsedGraphs);
-            // cout << "Refinded graph" << endl;
-            vector<Graph> partitionatedGraphs = splitPartitionatedGraph(coarsedGraphs[0]);
-            for(int k = 0; k < partitionatedGraphs.size(); k++) {
-                newGraphs.push_back(partitionatedGraphs[k]);
+            partitionatedGraphsOfGraphs[j] = splitPartitionatedGraph(coarsedGraphs[0]);
+        }
+
+        vector<PartitionGraph> newGraphs = vector<PartitionGraph>(0);
+        for (int j = 0; j < partitionatedGraphsOfGraphs.size(); j++) {
+            for(int k = 0; k < partitionatedGraphsOfGraphs[j].size(); k++) {
+                newGraphs.push_back(move(partitionatedGraphsOfGraphs[j][k]));
             }
         }
 
-        previousGraphs = newGraphs;
+        previousGraphs = move(newGraphs);
+    }
+
+    // create the graphs of the partitions with the vertices of the original graph
+    vector<Graph> graphs = vector<Graph>(previousGraphs.size(), Graph());
+    vector<int> partitionOfVertex = vector<int>(graph.vertices.size(), -1);
+    for (int i = 0; i < previousGraphs.size(); i++) {
+        PartitionGraph &partitionGraph = previousGraphs[i];
+        for (int j = 0; j < partitionGraph.getNumberOfVertices(); j++) {
+            graphs[i].vertices.push_back(graph.vertices[partitionGraph.vertexIndices[j]]);
+            partitionOfVertex[partitionGraph.vertexIndices[j]] = i;
+            vector<Edge> adjacencyList = vector<Edge>(0);
+            for (int k = partitionGraph.edgeOffsets[j]; k < partitionGraph.edgeOffsets[j + 1]; k++) {
+                Edge edge;
+                edge.targetStopId = partitionGraph.edgeTargets[k];
+                edge.ewgt = partitionGraph.edgeWeights[k];
+                adjacencyList.push_back(edge);
+            }
+            graphs[i].adjacencyList.push_back(adjacencyList);
+        }
     }
 
-    return previousGraphs;
+    int edgeCut = createPartitionGraph(graph).getEdgeCut(partitionOfVertex);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    cout << "Partitionated the graph with an edge cut of " << edgeCut << " in " << duration << " milliseconds." << endl;
+
+    return graphs;
 }
 
 /*
-    Coarse the graph by contracting vertices. Use the "Heavy edge matching" algorithm.
+    Create the compressed sparse row graph of a graph for the partitioner.
 */
-vector<Graph> Creator::coarseGraph(Graph &graph, int maxNumberOfVerticesInGraph) {
-    vector<Graph> coarsedGraphs = vector<Graph>(0);
-    coarsedGraphs.push_back(graph);
+PartitionGraph Creator::createPartitionGraph(Graph &graph) {
+    PartitionGraph partitionGraph = PartitionGraph();
+    int numberOfVertices = graph.vertices.size();
+
+    partitionGraph.vertexIndices = vector<int>(numberOfVertices);
+    partitionGraph.vertexWeights = vector<int>(numberOfVertices);
+    partitionGraph.contractedEdgeWeights = vector<int>(numberOfVertices);
+    partitionGraph.edgeOffsets = vector<int>(numberOfVertices + 1, 0);
+
+    for (int i = 0; i < numberOfVertices; i++) {
+        partitionGraph.vertexIndices[i] = i;
+        partitionGraph.vertexWeights[i] = graph.vertices[i].vwgt;
+        partitionGraph.contractedEdgeWeights[i] = graph.vertices[i].cewgt;
+        for (int j = 0; j < graph.adjacencyList[i].size(); j++) {
+            partitionGraph.edgeTargets.push_back(graph.adjacencyList[i][j].targetStopId);
+            partitionGraph.edgeWeights.push_back(graph.adjacencyList[i][j].ewgt);
+        }
+        partitionGraph.edgeOffsets[i + 1] = partitionGraph.edgeTargets.size();
+    }
+
+    return partitionGraph;
+}
 
-    while(coarsedGraphs[coarsedGraphs.size()-1].vertices.size() > maxNumberOfVerticesInGraph){
-        Graph* previousGraph = &coarsedGraphs[coarsedGraphs.size()-1];
-        Graph coarsedGraph = Graph();
+/*
+    Coarse the graph by contracting vertices. Use the "Heavy edge matching" algorithm. The graph is moved into the first level.
+*/
+vector<PartitionGraph> Creator::coarseGraph(PartitionGraph &graph, int maxNumberOfVerticesInGraph, mt19937 &randomGenerator) {
+    vector<PartitionGraph> coarsedGraphs = vector<PartitionGraph>(0);
+    coarsedGraphs.push_back(move(graph));
+
+    while(coarsedGraphs[coarsedGraphs.size()-1].getNumberOfVertices() > maxNumberOfVerticesInGraph){
+        PartitionGraph* previousGraph = &coarsedGraphs[coarsedGraphs.size()-1];
+        PartitionGraph coarsedGraph = PartitionGraph();
+        int numberOfVerticesInPreviousGraph = previousGraph->getNumberOfVertices();
 
         // map vertices to vertices
-        vector<int> visitingOrder = vector<int>(previousGraph->vertices.size());
+        vector<int> visitingOrder = vector<int>(numberOfVerticesInPreviousGraph);
         for (int i = 0; i < visitingOrder.size(); i++) {
             visitingOrder[i] = i;
         }
-        random_shuffle(visitingOrder.begin(), visitingOrder.end());
-
-        vector<int> matched = vector<int>(previousGraph->vertices.size(), 0);
+        shuffle(visitingOrder.begin(), visitingOrder.end(), randomGenerator);
 
-        previousGraph->matchings = vector<int>(previousGraph->vertices.size(), -1);
-        previousGraph->indexToCoarserGraphIndex = map<int, int>();
+        vector<int> matched = vector<int>(numberOfVerticesInPreviousGraph, 0);
+        vector<int> matchings = vector<int>(numberOfVerticesInPreviousGraph, -1);
 
         for(int i = 0; i < visitingOrder.size(); i++) {
             int vertexIndex = visitingOrder[i];
@@ -284,11 +436,11 @@ vector<Graph> Creator::coarseGraph(Graph &graph, int maxNumberOfVerticesInGraph)
                 int maxEdgeWeight = 0;
                 int maxEdgeWeightIndex = -1;
 
-                for (int j = 0; j < previousGraph->adjacencyList[vertexIndex].size(); j++) {
-                    int mappedVertexIndex = previousGraph->adjacencyList[vertexIndex][j].targetStopId;
-                    if (matched[mappedVertexIndex] == 0) {
-                        if (previousGraph->adjacencyList[vertexIndex][j].ewgt > maxEdgeWeight) {
-                            maxEdgeWeight = previousGraph->adjacencyList[vertexIndex][j].ewgt;
+                for (int j = previousGraph->edgeOffsets[vertexIndex]; j < previousGraph->edgeOffsets[vertexIndex + 1]; j++) {
+                    int mappedVertexIndex = previousGraph->edgeTargets[j];
+                    if (matched[mappedVertexIndex] == 0 && mappedVertexIndex != vertexIndex) {
+                        if (previousGraph->edgeWeights[j] > maxEdgeWeight) {
+                            maxEdgeWeight = previousGraph->edgeWeights[j];
                             maxEdgeWeightIndex = mappedVertexIndex;
                         }
                     }
@@ -297,15 +449,15 @@ vector<Graph> Creator::coarseGraph(Graph &graph, int maxNumberOfVerticesInGraph)
                 if(maxEdgeWeightIndex != -1) {
                     matched[vertexIndex] = 1;
                     matched[maxEdgeWeightIndex] = -1;
-                    previousGraph->matchings[vertexIndex] = maxEdgeWeightIndex;
-                    previousGraph->matchings[maxEdgeWeightIndex] = vertexIndex;
+                    matchings[vertexIndex] = maxEdgeWeightIndex;
+                    matchings[maxEdgeWeightIndex] = vertexIndex;
                 }
             }
         }
 
         // contract vertices
         int indexInCoarsedGraph = 0;
-        int numberOfVerticesInPreviousGraph = previousGraph->vertices.size();
+        previousGraph->indexToCoarserGraphIndex = vector<int>(numberOfVerticesInPreviousGraph, -1);
         for (int i = 0; i < numberOfVerticesInPreviousGraph; i++){
             if (matched[i] != -1){
                 previousGraph->indexToCoarserGraphIndex[i] = indexInCoarsedGraph;
@@ -315,200 +467,337 @@ vector<Graph> Creator::coarseGraph(Graph &graph, int maxNumberOfVerticesInGraph)
 
         for (int i = 0; i < numberOfVerticesInPreviousGraph; i++){
             if (matched[i] == -1) {
-                previousGraph->indexToCoarserGraphIndex[i] = previousGraph->indexToCoarserGraphIndex[previousGraph->matchings[i]];
+                previousGraph->indexToCoarserGraphIndex[i] = previousGraph->indexToCoarserGraphIndex[matchings[i]];
             }
         }
 
-        // Create the coarser graph
-        coarsedGraph.adjacencyList = vector<vector<Edge>>(indexInCoarsedGraph, vector<Edge>(0));
+        // Create the coarser graph, the weights of parallel edges are summed up in a dense vector
+        vector<int> weightToTarget = vector<int>(indexInCoarsedGraph, 0);
+        vector<bool> isTarget = vector<bool>(indexInCoarsedGraph, false);
+        vector<int> targets = vector<int>(0);
+        coarsedGraph.edgeOffsets = vector<int>(1, 0);
         for (int i = 0; i < numberOfVerticesInPreviousGraph; i++){
             if (matched[i] != -1){
                 int indexInCoarsedGraphOfCurrentVertex = previousGraph->indexToCoarserGraphIndex[i];
-                int mappedVertexIndex = previousGraph->matchings[i];
-                map<int, int> targetStopIdToWeight = map<int, int>();
-                int numberOfOutgoingEdges = previousGraph->adjacencyList[i].size();
-                for (int j = 0; j < numberOfOutgoingEdges; j++) {
-                    int targetStopId = previousGraph->indexToCoarserGraphIndex[previousGraph->adjacencyList[i][j].targetStopId];
-                    int edgeWeight = previousGraph->adjacencyList[i][j].ewgt;
-                    if (targetStopIdToWeight.find(targetStopId) == targetStopIdToWeight.end()) {
-                        targetStopIdToWeight[targetStopId] = edgeWeight;
-                    } else {
-                        targetStopIdToWeight[targetStopId] += edgeWeight;
+                int mappedVertexIndex = matchings[i];
+                targets.clear();
+
+                for (int k = 0; k < 2; k++) {
+                    int vertexIndex = k == 0 ? i : mappedVertexIndex;
+                    if (k == 1 && matched[i] != 1) {
+                        break;
                     }
-                }
-                if(matched[i] == 1){
-                    int numberOfOutgoingEdges = previousGraph->adjacencyList[mappedVertexIndex].size();
-                    for (int j = 0; j < numberOfOutgoingEdges; j++) {
-                        int targetStopId = previousGraph->indexToCoarserGraphIndex[previousGraph->adjacencyList[mappedVertexIndex][j].targetStopId];
-                        int edgeWeight = previousGraph->adjacencyList[mappedVertexIndex][j].ewgt;
-                        if (targetStopIdToWeight.find(targetStopId) == targetStopIdToWeight.end()) {
-                            targetStopIdToWeight[targetStopId] = edgeWeight;
-                        } else {
-                            targetStopIdToWeight[targetStopId] += edgeWeight;
+                    for (int j = previousGraph->edgeOffsets[vertexIndex]; j < previousGraph->edgeOffsets[vertexIndex + 1]; j++) {
+                        int targetIndex = previousGraph->indexToCoarserGraphIndex[previousGraph->edgeTargets[j]];
+                        if (!isTarget[targetIndex]) {
+                            isTarget[targetIndex] = true;
+                            targets.push_back(targetIndex);
                         }
+                        weightToTarget[targetIndex] += previousGraph->edgeWeights[j];
                     }
                 }
+                sort(targets.begin(), targets.end());
 
-                int weightSum = 0;
-                for (auto it = targetStopIdToWeight.begin(); it != targetStopIdToWeight.end(); it++) {
-                    if (it->first == indexInCoarsedGraphOfCurrentVertex) {
-                        continue;
+                int contractedEdgeWeight = weightToTarget[indexInCoarsedGraphOfCurrentVertex];
+                for (int j = 0; j < targets.size(); j++) {
+                    if (targets[j] != indexInCoarsedGraphOfCurrentVertex) {
+                        coarsedGraph.edgeTargets.push_back(targets[j]);
+                        coarsedGraph.edgeWeights.push_back(weightToTarget[targets[j]]);
                     }
-                    Edge edge;
-                    edge.targetStopId = it->first;
-                    edge.ewgt = it->second;
-                    coarsedGraph.adjacencyList[indexInCoarsedGraphOfCurrentVertex].push_back(edge);
-                    weightSum += it->second;
+                    weightToTarget[targets[j]] = 0;
+                    isTarget[targets[j]] = false;
                 }
+                coarsedGraph.edgeOffsets.push_back(coarsedGraph.edgeTargets.size());
 
-                Vertex vertex;
                 if(matched[i] == 1) {
-                    vertex.vwgt = previousGraph->vertices[i].vwgt + previousGraph->vertices[mappedVertexIndex].vwgt;
-                    vertex.cewgt = previousGraph->vertices[i].cewgt + targetStopIdToWeight[indexInCoarsedGraphOfCurrentVertex];
+                    coarsedGraph.vertexWeights.push_back(previousGraph->vertexWeights[i] + previousGraph->vertexWeights[mappedVertexIndex]);
+                    coarsedGraph.contractedEdgeWeights.push_back(previousGraph->contractedEdgeWeights[i] + contractedEdgeWeight);
                 } else {
-                    vertex.vwgt = previousGraph->vertices[i].vwgt;
-                    vertex.cewgt = previousGraph->vertices[i].cewgt;
+                    coarsedGraph.vertexWeights.push_back(previousGraph->vertexWeights[i]);
+                    coarsedGraph.contractedEdgeWeights.push_back(previousGraph->contractedEdgeWeights[i]);
                 }
-                vertex.nedges = coarsedGraph.adjacencyList[indexInCoarsedGraphOfCurrentVertex].size();
-                vertex.adjwgt = weightSum;
-                coarsedGraph.vertices.push_back(vertex);
             }
         }
 
-        // cout << "Number of vertices in coarsed graph: " << coarsedGraph.vertices.size() << endl;
-
         // Break if the coarsed graph is not coarser than the previous graph
-        if(coarsedGraph.vertices.size() > previousGraph->vertices.size() * 0.99){
+        if(coarsedGraph.getNumberOfVertices() > numberOfVerticesInPreviousGraph * 0.99){
             break;
         }
-        coarsedGraphs.push_back(coarsedGraph);
+        coarsedGraphs.push_back(move(coarsedGraph));
     }
 
     return coarsedGraphs;
 }
 
 /*
-    Partitionate the coarsed graph. Use the Kernighan-Lin algorithm.
+    Partitionate the coarsed graph. Refine several random bisections and use the one with the smallest edge cut.
 */
-void Creator::partitionateCoarsedGraph(Graph &graph, int klIterations) {
-    vector<vector<int>> partitions = vector<vector<int>>(0);
-    vector<int> edgeCutOfPartitions = vector<int>(0);
+void Creator::partitionateCoarsedGraph(PartitionGraph &graph, mt19937 &randomGenerator) {
+    int numberOfVertices = graph.getNumberOfVertices();
+    int totalWeight = 0;
+    for (int i = 0; i < numberOfVertices; i++) {
+        totalWeight += graph.vertexWeights[i];
+    }
 
-    for (int i = 0; i < klIterations; i++){
-        int numberOfUnusedSwaps = 0;
-        int swaps = 0;
+    vector<int> bestPartition = vector<int>(numberOfVertices, 0);
+    int minEdgeCut = INT_MAX;
 
-        vector<int> partition = vector<int>(graph.vertices.size(), 0);
+    for (int i = 0; i < INITIAL_PARTITION_TRIES; i++){
+        // generate random partition with half of the vertex weight in each part
+        vector<int> partition = vector<int>(numberOfVertices, 0);
+        vector<int> visitingOrder = vector<int>(numberOfVertices);
+        for (int j = 0; j < visitingOrder.size(); j++) {
+            visitingOrder[j] = j;
+        }
+        shuffle(visitingOrder.begin(), visitingOrder.end(), randomGenerator);
+        int weightOfSecondPart = 0;
+        for (int j = 0; j < numberOfVertices && 2 * weightOfSecondPart < totalWeight; j++) {
+            partition[visitingOrder[j]] = 1;
+            weightOfSecondPart += graph.vertexWeights[visitingOrder[j]];
+        }
 
-        // set initial partition
-        if (graph.partition.size() > 0) {
-            partition = graph.partition;
-        } else {
-            // generate random partition
-            vector<int> visitingOrder = vector<int>(graph.vertices.size());
-            for (int i = 0; i < visitingOrder.size(); i++) {
-                visitingOrder[i] = i;
+        int edgeCut = refinePartition(graph, partition);
+        if (edgeCut < minEdgeCut) {
+            minEdgeCut = edgeCut;
+            bestPartition = partition;
+        }
+    }
+
+    // set partition
+    graph.partition = bestPartition;
+}
+
+/*
+    Refine the graphs by projecting the partition of the coarser graph to the finer graph and refining it on every level.
+*/
+void Creator::refineGraphs(vector<PartitionGraph> &graphs) {
+    for(int i = graphs.size()-2; i>=0; i--){
+        PartitionGraph* previousGraph = &graphs[i+1];
+        PartitionGraph* graph = &graphs[i];
+
+        // set the partition of the graph
+        int numberOfVertices = graph->getNumberOfVertices();
+        graph->partition = vector<int>(numberOfVertices, 0);
+        for (int j = 0; j < numberOfVertices; j++) {
+            graph->partition[j] = previousGraph->partition[graph->indexToCoarserGraphIndex[j]];
+        }
+
+        // refine the partition of the graph
+        refinePartition(*graph, graph->partition);
+    }
+}
+
+/*
+    Refine a bisection with the Fiduccia-Mattheyses algorithm and return its edge cut. Only boundary vertices are kept in the gain 
+    queues of the two parts. A pass moves the unlocked vertex with the highest gain that keeps the parts balanced until 
+    FM_MAX_UNUSED_MOVES moves didn't improve the cut, then the moves after the best state are rolled back. The edge weights are 
+    summed up durations, so the gains are kept in priority queues with lazy deletion instead of a bucket array.
+*/
+int Creator::refinePartition(PartitionGraph &graph, vector<int> &partition) {
+    int numberOfVertices = graph.getNumberOfVertices();
+
+    int totalWeight = 0;
+    int minVertexWeight = INT_MAX;
+    int maxVertexWeight = 0;
+    vector<int> partWeights = vector<int>(2, 0);
+    for (int i = 0; i < numberOfVertices; i++) {
+        totalWeight += graph.vertexWeights[i];
+        minVertexWeight = min(minVertexWeight, graph.vertexWeights[i]);
+        maxVertexWeight = max(maxVertexWeight, graph.vertexWeights[i]);
+        partWeights[partition[i]] += graph.vertexWeights[i];
+    }
+
+    // coarse vertices may need more than the allowed imbalance, but no part may become empty
+    int maxPartWeight = max((int) ceil(totalWeight / 2.0 * (1 + PARTITION_IMBALANCE)), (totalWeight + 1) / 2 + maxVertexWeight / 2);
+    maxPartWeight = min(maxPartWeight, totalWeight - minVertexWeight);
+
+    // the gain of a vertex is the decrease of the edge cut if it is moved to the other part
+    vector<int> gains = vector<int>(numberOfVertices, 0);
+    vector<bool> isBoundaryVertex = vector<bool>(numberOfVertices, false);
+    int edgeCut = 0;
+    for (int i = 0; i < numberOfVertices; i++) {
+        for (int j = graph.edgeOffsets[i]; j < graph.edgeOffsets[i + 1]; j++) {
+            if (partition[i] != partition[graph.edgeTargets[j]]) {
+                gains[i] += graph.edgeWeights[j];
+                edgeCut += graph.edgeWeights[j];
+                isBoundaryVertex[i] = true;
+            } else {
+                gains[i] -= graph.edgeWeights[j];
             }
-            random_shuffle(visitingOrder.begin(), visitingOrder.end());
-            for (int i = 0; i < graph.vertices.size() / 2; i++) {
-                partition[visitingOrder[i]] = 1;
+        }
+    }
+    edgeCut /= 2;
+
+    for (int pass = 0; pass < FM_MAX_PASSES; pass++) {
+        vector<bool> locked = vector<bool>(numberOfVertices, false);
+        vector<priority_queue<pair<int, int>>> gainQueues = vector<priority_queue<pair<int, int>>>(2);
+        for (int i = 0; i < numberOfVertices; i++) {
+            // an overweight part can't always be balanced with boundary vertices, e.g. if the graph isn't connected
+            if (isBoundaryVertex[i] || partWeights[partition[i]] > maxPartWeight) {
+                gainQueues[partition[i]].push(make_pair(gains[i], i));
             }
         }
 
-        vector<bool> swappedVertex = vector<bool>(graph.vertices.size(), false);
+        vector<int> moves = vector<int>(0);
+        int currentEdgeCut = edgeCut;
+        int bestEdgeCut = edgeCut;
+        bool bestIsBalanced = partWeights[0] <= maxPartWeight && partWeights[1] <= maxPartWeight;
+        int numberOfBestMoves = 0;
+        int numberOfUnusedMoves = 0;
+
+        while (numberOfUnusedMoves < FM_MAX_UNUSED_MOVES) {
+            // find the vertex with the highest gain whose move keeps the target part balanced, the vertices that are too heavy
+            // for the target part are skipped and queued again after the move
+            int vertexToMove = -1;
+            vector<pair<int, int>> skippedEntries = vector<pair<int, int>>(0);
+            for (int part = 0; part < 2; part++) {
+                while (!gainQueues[part].empty()) {
+                    pair<int, int> entry = gainQueues[part].top();
+                    int vertex = entry.second;
+                    if (locked[vertex] || partition[vertex] != part || entry.first != gains[vertex] || (!isBoundaryVertex[vertex] && partWeights[part] <= maxPartWeight)) {
+                        gainQueues[part].pop();
+                        continue;
+                    }
+                    if (partWeights[1 - part] + graph.vertexWeights[vertex] > maxPartWeight) {
+                        skippedEntries.push_back(entry);
+                        gainQueues[part].pop();
+                        continue;
+                    }
+                    if (vertexToMove == -1 || gains[vertex] > gains[vertexToMove]) {
+                        vertexToMove = vertex;
+                    }
+                    break;
+                }
+            }
 
-        while(numberOfUnusedSwaps < KL_MAX_UNUSED_SWAPS && swaps < graph.vertices.size()) {
-            // calculate edge cut for each vertex and find max gain vertex
-            vector<int> externalDegree = vector<int>(graph.vertices.size(), 0);
-            vector<int> internalDegree = vector<int>(graph.vertices.size(), 0);
-            vector<int> partSizes = vector<int>(2, 0);
-            vector<int> maxGain = vector<int>(2, 0);
-            vector<int> maxGainVertex = vector<int>(2, -1);
-            for (int j = 0; j < graph.vertices.size(); j++) {
-                if(swappedVertex[j]){
-                    continue;
+            if (vertexToMove == -1) {
+                break;
+            }
+
+            // move the vertex and update the gains of its neighbors
+            int fromPart = partition[vertexToMove];
+            gainQueues[fromPart].pop();
+            for (int i = 0; i < skippedEntries.size(); i++) {
+                gainQueues[partition[skippedEntries[i].second]].push(skippedEntries[i]);
+            }
+            partition[vertexToMove] = 1 - fromPart;
+            locked[vertexToMove] = true;
+            partWeights[fromPart] -= graph.vertexWeights[vertexToMove];
+            partWeights[1 - fromPart] += graph.vertexWeights[vertexToMove];
+            currentEdgeCut -= gains[vertexToMove];
+            gains[vertexToMove] = -gains[vertexToMove];
+            moves.push_back(vertexToMove);
+
+            isBoundaryVertex[vertexToMove] = false;
+            for (int j = graph.edgeOffsets[vertexToMove]; j < graph.edgeOffsets[vertexToMove + 1]; j++) {
+                int neighbor = graph.edgeTargets[j];
+                if (partition[neighbor] == partition[vertexToMove]) {
+                    gains[neighbor] -= 2 * graph.edgeWeights[j];
+                } else {
+                    gains[neighbor] += 2 * graph.edgeWeights[j];
+                    isBoundaryVertex[vertexToMove] = true;
                 }
-                for (int k = 0; k < graph.adjacencyList[j].size(); k++) {
-                    if (partition[j] != partition[graph.adjacencyList[j][k].targetStopId]) {
-                        externalDegree[j] += graph.adjacencyList[j][k].ewgt;
-                    } else {
-                        internalDegree[j] += graph.adjacencyList[j][k].ewgt;
+                isBoundaryVertex[neighbor] = false;
+                for (int k = graph.edgeOffsets[neighbor]; k < graph.edgeOffsets[neighbor + 1]; k++) {
+                    if (partition[graph.edgeTargets[k]] != partition[neighbor]) {
+                        isBoundaryVertex[neighbor] = true;
+                        break;
                     }
                 }
-                internalDegree[j] += graph.vertices[j].cewgt;
-                int gain = externalDegree[j] - internalDegree[j];
-                if (gain > maxGain[partition[j]]) {
-                    maxGain[partition[j]] = gain;
-                    maxGainVertex[partition[j]] = j;
-                }
-                if (partition[j] == 0) {
-                    partSizes[0] += graph.vertices[j].vwgt;
-                } else {
-                    partSizes[1] += graph.vertices[j].vwgt;
+                if (!locked[neighbor] && isBoundaryVertex[neighbor]) {
+                    gainQueues[partition[neighbor]].push(make_pair(gains[neighbor], neighbor));
                 }
             }
 
-            int largerPart = 0;
-            if (partSizes[1] > partSizes[0]) {
-                largerPart = 1;
-            }
-
-            // swap max gain vertex
-            if(maxGain[largerPart] > 0){
-                partition[maxGainVertex[largerPart]] = 1 - partition[maxGainVertex[largerPart]];
-                numberOfUnusedSwaps = 0;
-            } else {
-                numberOfUnusedSwaps++;
+            bool isBalanced = partWeights[0] <= maxPartWeight && partWeights[1] <= maxPartWeight;
+            if ((isBalanced && !bestIsBalanced) || (isBalanced == bestIsBalanced && currentEdgeCut < bestEdgeCut)) {
+                bestEdgeCut = currentEdgeCut;
+                bestIsBalanced = isBalanced;
+                numberOfBestMoves = moves.size();
+                numberOfUnusedMoves = 0;
+            } else if (bestIsBalanced) {
+                // the moves of an unbalanced partition go to the lighter part, so they are continued until it is balanced
+                numberOfUnusedMoves++;
             }
-            swaps++;
         }
 
-        // calculate edge cut of partition
-        int edgeCut = 0;
-        for (int j = 0; j < graph.vertices.size(); j++) {
-            for (int k = 0; k < graph.adjacencyList[j].size(); k++) {
-                if (partition[j] != partition[graph.adjacencyList[j][k].targetStopId]) {
-                    edgeCut += graph.adjacencyList[j][k].ewgt;
+        // roll back the moves after the best state
+        for (int i = moves.size() - 1; i >= numberOfBestMoves; i--) {
+            int vertex = moves[i];
+            int fromPart = partition[vertex];
+            partition[vertex] = 1 - fromPart;
+            partWeights[fromPart] -= graph.vertexWeights[vertex];
+            partWeights[1 - fromPart] += graph.vertexWeights[vertex];
+            gains[vertex] = -gains[vertex];
+            isBoundaryVertex[vertex] = false;
+            for (int j = graph.edgeOffsets[vertex]; j < graph.edgeOffsets[vertex + 1]; j++) {
+                int neighbor = graph.edgeTargets[j];
+                if (partition[neighbor] == partition[vertex]) {
+                    gains[neighbor] -= 2 * graph.edgeWeights[j];
+                } else {
+                    gains[neighbor] += 2 * graph.edgeWeights[j];
+                    isBoundaryVertex[vertex] = true;
+                }
+                isBoundaryVertex[neighbor] = false;
+                for (int k = graph.edgeOffsets[neighbor]; k < graph.edgeOffsets[neighbor + 1]; k++) {
+                    if (partition[graph.edgeTargets[k]] != partition[neighbor]) {
+                        isBoundaryVertex[neighbor] = true;
+                        break;
+                    }
                 }
             }
         }
 
-        partitions.push_back(partition);
-        edgeCutOfPartitions.push_back(edgeCut);
-    }
-
-    // find best partition
-    int minEdgeCut = edgeCutOfPartitions[0];
-    int minEdgeCutIndex = 0;
-    for (int i = 1; i < edgeCutOfPartitions.size(); i++) {
-        if (edgeCutOfPartitions[i] < minEdgeCut) {
-            minEdgeCut = edgeCutOfPartitions[i];
-            minEdgeCutIndex = i;
+        edgeCut = bestEdgeCut;
+        if (numberOfBestMoves == 0) {
+            break;
         }
     }
 
-    // set partition
-    graph.partition = partitions[minEdgeCutIndex];
+    return edgeCut;
 }
 
 /*
-    Refine the graphs by setting the partition of the coarser graph as initial partition and partitionate the finer graph.
+    Split the partitionated compressed sparse row graph into two graphs.
 */
-void Creator::refineGraphs(vector<Graph> &graphs) {
-    for(int i = graphs.size()-2; i>=0; i--){
-        Graph* previousGraph = &graphs[i+1];
-        Graph* graph = &graphs[i];
-
-        // set the partition of the graph
-        int numberOfVertices = graph->vertices.size();
-        graph->partition = vector<int>(numberOfVertices, 0);
-        for (int j = 0; j < numberOfVertices; j++) {
-            graph->partition[j] = previousGraph->partition[graph->indexToCoarserGraphIndex[j]];
+vector<PartitionGraph> Creator::splitPartitionatedGraph(PartitionGraph &graph) {
+    int numberOfVertices = graph.getNumberOfVertices();
+    int numberOfPartitions = 0;
+    for (int i = 0; i < graph.partition.size(); i++) {
+        if (graph.partition[i] > numberOfPartitions) {
+            numberOfPartitions = graph.partition[i];
         }
+    }
+    numberOfPartitions++;
 
-        // refine the partition of the graph
-        partitionateCoarsedGraph(*graph, 1);
+    vector<PartitionGraph> graphs = vector<PartitionGraph>(numberOfPartitions, PartitionGraph());
+
+    vector<int> oldToNewIndex = vector<int>(numberOfVertices, 0);
+    for (int i = 0; i < numberOfVertices; i++) {
+        PartitionGraph &partitionGraph = graphs[graph.partition[i]];
+        oldToNewIndex[i] = partitionGraph.vertexWeights.size();
+        partitionGraph.vertexIndices.push_back(graph.vertexIndices[i]);
+        partitionGraph.vertexWeights.push_back(graph.vertexWeights[i]);
+        partitionGraph.contractedEdgeWeights.push_back(graph.contractedEdgeWeights[i]);
+    }
+
+    for (int i = 0; i < numberOfPartitions; i++) {
+        graphs[i].edgeOffsets = vector<int>(1, 0);
+    }
+
+    for (int i = 0; i < numberOfVertices; i++) {
+        int partition = graph.partition[i];
+        for (int j = graph.edgeOffsets[i]; j < graph.edgeOffsets[i + 1]; j++) {
+            if(graph.partition[graph.edgeTargets[j]] != partition){
+                continue;
+            }
+            graphs[partition].edgeTargets.push_back(oldToNewIndex[graph.edgeTargets[j]]);
+            graphs[partition].edgeWeights.push_back(graph.edgeWeights[j]);
+        }
+        graphs[partition].edgeOffsets.push_back(graphs[partition].edgeTargets.size());
     }
+
+    return graphs;
 }
 
 /*
@@ -526,11 +815,11 @@ vector<Graph> Creator::splitPartitionatedGraph(Graph &graph) {
     vector<Graph> graphs = vector<Graph>(numberOfPartitions, Graph());
 
     vector<int> indices = vector<int>(numberOfPartitions, 0);
-    vector<map<int, int>> oldToNewIndex = vector<map<int, int>>(numberOfPartitions, map<int, int>());
+    vector<int> oldToNewIndex = vector<int>(graph.vertices.size(), 0);
 
     for (int i = 0; i < graph.vertices.size(); i++) {
         int partition = graph.partition[i];
-        oldToNewIndex[partition][i] = indices[partition];
+        oldToNewIndex[i] = indices[partition];
         indices[partition]++;
         graphs[partition].vertices.push_back(graph.vertices[i]);
         vector<Edge> adjacencyList = vector<Edge>(0);
@@ -550,7 +839,7 @@ vector<Graph> Creator::splitPartitionatedGraph(Graph &graph) {
     for (int i = 0; i < graphs.size(); i++) {
         for (int j = 0; j < graphs[i].adjacencyList.size(); j++) {
             for (int k = 0; k < graphs[i].adjacencyList[j].size(); k++) {
-                graphs[i].adjacencyList[j][k].targetStopId = oldToNewIndex[i][graphs[i].adjacencyList[j][k].targetStopId];
+                graphs[i].adjacencyList[j][k].targetStopId = oldToNewIndex[graphs[i].adjacencyList[j][k].targetStopId];
             }
         }
     }
@@ -563,57 +852,54 @@ vector<Graph> Creator::splitPartitionatedGraph(Graph &graph) {
 */
 GTree* Creator::createGTree(Graph &originalGraph, vector<Graph> &graphs, int numberOfChildrenPerNode, int depth, bool withDistances) {
     GTree* gTree = new GTree();
-    gTree->nodeOfStopId = vector<GNode*>(Importer::stops.size(), nullptr);
 
-    vector<GNode*> previousLevelNodes = vector<GNode*>(0);
+    // the nodes are created bottom up and get their ids in breadth first order at the end
+    vector<GNode> createdNodes = vector<GNode>(0);
+    vector<int> previousLevelNodes = vector<int>(0);
+
+    // the node of each stop on the current level replaces the searches in the stop ids of the nodes
+    vector<int> nodeOfStopId = vector<int>(originalGraph.adjacencyList.size(), -1);
 
     // measure the time
     auto start = std::chrono::high_resolution_clock::now(); 
 
     // create leaf nodes using the graphs
     for (int i = 0;  i < graphs.size(); i++) {
-        GNode* node = new GNode();
-        node->parent = nullptr;
-        node->stopIds = vector<int>(0);
-        node->borderStopIds = vector<int>(0);
-        node->borderDurations = map<pair<int, int>, int>();
+        GNode node = GNode();
+        node.stopIds = vector<int>(0);
+        node.borderStopIds = vector<int>(0);
 
         for (int j = 0; j < graphs[i].vertices.size(); j++) {
             int stopId = graphs[i].vertices[j].stopId;
-            node->stopIds.push_back(stopId);
-            gTree->nodeOfStopId[stopId] = node;
+            node.stopIds.push_back(stopId);
+            nodeOfStopId[stopId] = i;
+        }
+
+        for (int j = 0; j < node.stopIds.size(); j++) {
+            int stopId = node.stopIds[j];
             for (int k = 0; k < originalGraph.adjacencyList[stopId].size(); k++) {
                 int targetStopId = originalGraph.adjacencyList[stopId][k].targetStopId;
-                if (find(node->stopIds.begin(), node->stopIds.end(), targetStopId) == node->stopIds.end()) {
-                    node->borderStopIds.push_back(stopId);
+                if (nodeOfStopId[targetStopId] != i) {
+                    node.borderStopIds.push_back(stopId);
                     break;
                 }
             }
         }
-
-        // calculate the durations between the stops of the node
-        if (withDistances) {
-            for (int j = 0; j < node->stopIds.size(); j++) {
-                vector<int> distances = originalGraph.getDistances(node->stopIds[j], node->stopIds);
-                for (int k = 0; k < node->stopIds.size(); k++) {
-                    node->borderDurations[make_pair(node->stopIds[j], node->stopIds[k])] = distances[node->stopIds[k]];
-                }
-            }
-        }
         
         // print the progress after every 5% of the graphs
         if (graphs.size() > 10) {
             if (i % (graphs.size() / 10) == 0){
-                cout << "Number of vertices: " << node->stopIds.size() << endl;
+                cout << "Number of vertices: " << node.stopIds.size() << endl;
                 auto end = std::chrono::high_resolution_clock::now();
                 auto duration = std::chrono::duration_cast<std::chrono::minutes>(end - start).count();
                 cout << "Created " << i + 1 << "/" << graphs.size() << " of the leaf nodes in " << duration << " minutes." << endl;
             }
         } else {
-            cout << "Number of vertices: " << node->stopIds.size() << endl;
+            cout << "Number of vertices: " << node.stopIds.size() << endl;
         }
 
-        previousLevelNodes.push_back(node);
+        createdNodes.push_back(node);
+        previousLevelNodes.push_back(createdNodes.size() - 1);
     }
 
     cout << "Created leaf nodes." << endl;
@@ -623,34 +909,24 @@ GTree* Creator::createGTree(Graph &originalGraph, vector<Graph> &graphs, int num
     // create the rest of the nodes
     while (previousLevelNodes.size() > 1) {
         auto start = std::chrono::high_resolution_clock::now();
-        vector<GNode*> currentLevelNodes = vector<GNode*>(0);
+        vector<int> currentLevelNodes = vector<int>(0);
 
         int numberOfNodes = previousLevelNodes.size()/numberOfChildrenPerNode;
         
         for (int j = 0; j < numberOfNodes; j++) {
-            GNode* node = new GNode();
+            GNode node = GNode();
             
-            node->parent = nullptr;
-            node->children = vector<GNode*>(0);
-            node->stopIds = vector<int>(0);
-            node->borderStopIds = vector<int>(0);
+            node.childNodeIds = vector<int>(0);
+            node.stopIds = vector<int>(0);
+            node.borderStopIds = vector<int>(0);
 
             for (int k = 0; k < numberOfChildrenPerNode; k++) {
-                GNode* child = previousLevelNodes[j*numberOfChildrenPerNode+k];
-                node->children.push_back(child);
-                child->parent = node;
-                for (int l = 0; l < child->borderStopIds.size(); l++) {
-                    node->stopIds.push_back(child->borderStopIds[l]);
-                }
-            }
-
-            // calculate the border durations of the children
-            if (withDistances) {
-                for (int k = 0; k < node->stopIds.size(); k++) {
-                    vector<int> distances = originalGraph.getDistances(node->stopIds[k], node->stopIds);
-                    for (int l = 0; l < node->stopIds.size(); l++) {
-                        node->borderDurations[make_pair(node->stopIds[k], node->stopIds[l])] = distances[node->stopIds[l]];
-                    }
+                int childIndex = previousLevelNodes[j*numberOfChildrenPerNode+k];
+                GNode &child = createdNodes[childIndex];
+                node.childNodeIds.push_back(childIndex);
+                child.parentNodeId = createdNodes.size();
+                for (int l = 0; l < child.borderStopIds.size(); l++) {
+                    node.stopIds.push_back(child.borderStopIds[l]);
                 }
             }
 
@@ -659,40 +935,37 @@ GTree* Creator::createGTree(Graph &originalGraph, vector<Graph> &graphs, int num
             // print the progress after every 5% of the graphs
             if (numberOfNodes > 10) {
                 if (j % (numberOfNodes / 10) == 0){
-                    cout << "Number of vertices: " << node->stopIds.size() << endl;
+                    cout << "Number of vertices: " << node.stopIds.size() << endl;
                     auto end = std::chrono::high_resolution_clock::now();
                     auto duration = std::chrono::duration_cast<std::chrono::minutes>(end - start).count();
                     cout << "Created " << j + 1 << "/" << numberOfNodes << " of the level " << level << " nodes in " << duration << " minutes." << endl;
                 }
             } else {
-                cout << "Number of vertices: " << node->stopIds.size() << endl;
+                cout << "Number of vertices: " << node.stopIds.size() << endl;
             }
 
-            currentLevelNodes.push_back(node);
+            createdNodes.push_back(node);
+            currentLevelNodes.push_back(createdNodes.size() - 1);
         }
 
-        // find new border stops
+        // find new border stops, a stop is a border stop if it has a neighbor in another node of the level
         if (currentLevelNodes.size() > 1){
+            fill(nodeOfStopId.begin(), nodeOfStopId.end(), -1);
             for (int j = 0; j < currentLevelNodes.size(); j++){
-                GNode* node = currentLevelNodes[j];
-                for (int k = 0; k < node->stopIds.size(); k++) {
-                    int stopId = node->stopIds[k];
-                    bool foundBorderStop = false;
+                GNode &node = createdNodes[currentLevelNodes[j]];
+                for (int k = 0; k < node.stopIds.size(); k++) {
+                    nodeOfStopId[node.stopIds[k]] = j;
+                }
+            }
+
+            for (int j = 0; j < currentLevelNodes.size(); j++){
+                GNode &node = createdNodes[currentLevelNodes[j]];
+                for (int k = 0; k < node.stopIds.size(); k++) {
+                    int stopId = node.stopIds[k];
                     for (int l = 0; l < originalGraph.adjacencyList[stopId].size(); l++) {
                         int targetStopId = originalGraph.adjacencyList[stopId][l].targetStopId;
-                        for (int m = 0; m < currentLevelNodes.size(); m++){
-                            if (j == m){
-                                continue;
-                            }
-                            GNode* otherNode = currentLevelNodes[m];
-                            if (find(otherNode->stopIds.begin(), otherNode->stopIds.end(), targetStopId) != otherNode->stopIds.end()){
-                                node->borderStopIds.push_back(stopId);
-                                
-                                foundBorderStop = true;
-                                break;
-                            }
-                        }
-                        if (foundBorderStop){
+                        if (nodeOfStopId[targetStopId] != -1 && nodeOfStopId[targetStopId] != j) {
+                            node.borderStopIds.push_back(stopId);
                             break;
                         }
                     }
@@ -706,22 +979,65 @@ GTree* Creator::createGTree(Graph &originalGraph, vector<Graph> &graphs, int num
         level++;
     }
 
-    gTree->root = previousLevelNodes[0];
+    // set the ids of the nodes in breadth first order starting at the root
+    vector<int> nodeIdOfCreatedNode = vector<int>(createdNodes.size(), -1);
+    vector<int> nodes = vector<int>(0);
+    nodes.push_back(previousLevelNodes[0]);
+    for (int i = 0; i < nodes.size(); i++) {
+        nodeIdOfCreatedNode[nodes[i]] = i;
+        for (int j = 0; j < createdNodes[nodes[i]].childNodeIds.size(); j++) {
+            nodes.push_back(createdNodes[nodes[i]].childNodeIds[j]);
+        }
+    }
+
+    gTree->rootNodeId = 0;
+    gTree->nodes = vector<GNode>(nodes.size());
+    for (int i = 0; i < nodes.size(); i++) {
+        GNode &node = gTree->nodes[i];
+        node = move(createdNodes[nodes[i]]);
+        node.nodeId = i;
+        if (i == 0) {
+            node.parentNodeId = -1;
+        } else {
+            node.parentNodeId = nodeIdOfCreatedNode[node.parentNodeId];
+        }
+        for (int j = 0; j < node.childNodeIds.size(); j++) {
+            node.childNodeIds[j] = nodeIdOfCreatedNode[node.childNodeIds[j]];
+        }
+    }
+
+    gTree->buildLocalIndices();
 
-    // set the ids of the nodes
-    int nodeId = 0;
-    gTree->nodeOfNodeId = vector<GNode*>(0);
-    vector<GNode*> nodes = vector<GNode*>(0);
-    nodes.push_back(gTree->root);
-    while(nodes.size() > 0){
-        GNode* node = nodes[0];
-        nodes.erase(nodes.begin());
-        node->nodeId = nodeId;
-        nodeId++;
-        gTree->nodeOfNodeId.push_back(node);
-        for (int i = 0; i < node->children.size(); i++) {
-            nodes.push_back(node->children[i]);
+    // every stop of the graph has to be in exactly one leaf
+    vector<int> numberOfLeafsOfStopId = vector<int>(originalGraph.adjacencyList.size(), 0);
+    for (int i = 0; i < gTree->nodes.size(); i++) {
+        if (!gTree->nodes[i].childNodeIds.empty()) {
+            continue;
+        }
+        for (int j = 0; j < gTree->nodes[i].stopIds.size(); j++) {
+            numberOfLeafsOfStopId[gTree->nodes[i].stopIds[j]]++;
+        }
+    }
+    int numberOfInvalidStops = 0;
+    for (int i = 0; i < originalGraph.vertices.size(); i++) {
+        int stopId = originalGraph.vertices[i].stopId;
+        if (numberOfLeafsOfStopId[stopId] != 1 || gTree->nodeIdOfStopId[stopId] == -1) {
+            numberOfInvalidStops++;
+        }
+    }
+    if (numberOfInvalidStops > 0) {
+        cout << "The G-tree is invalid. " << numberOfInvalidStops << " stops are not in exactly one leaf." << endl;
+    }
+
+    // calculate the durations between all stops of every node
+    if (withDistances) {
+        vector<int> stopIds = vector<int>(0);
+        for (int i = 0; i < graphs.size(); i++) {
+            for (int j = 0; j < graphs[i].vertices.size(); j++) {
+                stopIds.push_back(graphs[i].vertices[j].stopId);
+            }
         }
+        gTree->calculateBorderDistancesOfStopIds(stopIds);
     }
 
     return gTree;
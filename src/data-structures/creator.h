@@ -5,6 +5,7 @@
 #include "g-tree.h"
 
 #include <vector>
+#include <random>
 
 
 class Creator {
@@ -13,16 +14,24 @@ class Creator {
         ~Creator(){};
 
         static Graph networkGraph;
+        static TimeDependentGraph timeDependentGraph;
+        static TimeDependentGraph* getTimeDependentGraph();
+        static CustomizableCH customizableCH;
+        static CustomizableCH* getCustomizableCH();
         static void loadOrCreateNetworkGraph(DataType dataType);
+        static void createNetworkGraph();
+        static vector<vector<Edge>> createTimeWindowAdjacencyList(int weekday, int startTime, int endTime);
         
         static GTree* createNetworkGTree(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf, bool withDistances = true);
 
     private:
-        static void createNetworkGraph();
-        static vector<Graph> partitionateGraph(Graph graph, int numberOfPartitions, int maxNumberOfVerticesInGraph);
-        static vector<Graph> coarseGraph(Graph &graph, int maxNumberOfVerticesInGraph);
-        static void partitionateCoarsedGraph(Graph &graph, int klIterations);
-        static void refineGraphs(vector<Graph> &graphs);
+        static vector<Graph> partitionateGraph(Graph &graph, int numberOfPartitions, int maxNumberOfVerticesInGraph);
+        static PartitionGraph createPartitionGraph(Graph &graph);
+        static vector<PartitionGraph> coarseGraph(PartitionGraph &graph, int maxNumberOfVerticesInGraph, mt19937 &randomGenerator);
+        static void partitionateCoarsedGraph(PartitionGraph &graph, mt19937 &randomGenerator);
+        static void refineGraphs(vector<PartitionGraph> &graphs);
+        static int refinePartition(PartitionGraph &graph, vector<int> &partition);
+        static vector<PartitionGraph> splitPartitionatedGraph(PartitionGraph &graph);
         static vector<Graph> splitPartitionatedGraph(Graph &graph);
         static GTree* createGTree(Graph &originalGraph, vector<Graph> &graphs, int numberOfChildrenPerNode, int depth, bool withDistances = true);
 };
@@ -12,215 +12,338 @@
 #include <fstream>
 #include <chrono>
 #include <omp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace std;
 
 /*
-    Calculate the minimal duration to a target node from a source stop. Fill the map with the border stop durations of the nodes on the path if they are not already filled.
+    Initialize the local indices of the stops of the node.
 */
-int GTree::getMinimalDurationToNode(int sourceStopId, int targetNodeId, map<int, vector<pair<int, int>>> &nodeToBorderStopDurations) {
+void GNode::initializeIndexOfStopId() {
+    indexOfStopId.clear();
+    for (int i = 0; i < stopIds.size(); i++) {
+        indexOfStopId[stopIds[i]] = i;
+    }
+}
+
+/*
+    Initialize the local indices of the stops and the duration matrix of the node.
+*/
+void GNode::initializeDurations() {
+    initializeIndexOfStopId();
+    durations = vector<unsigned int>(stopIds.size() * stopIds.size(), 0);
+}
+
+/*
+    Get the duration between two stops of the node by their local indices.
+*/
+int GNode::getDuration(int sourceIndex, int targetIndex) {
+    return durations[sourceIndex * stopIds.size() + targetIndex];
+}
+
+/*
+    Set the duration between two stops of the node by their local indices.
+*/
+void GNode::setDuration(int sourceIndex, int targetIndex, int duration) {
+    durations[sourceIndex * stopIds.size() + targetIndex] = duration;
+}
+
+/*
+    Get the duration matrix of a time bucket. Without a time bucket the time independent matrix is returned.
+*/
+vector<unsigned int>& GNode::getDurations(int timeBucket) {
+    if (timeBucket == -1 || timeBucket >= timeBucketDurations.size()) {
+        return durations;
+    }
+    return timeBucketDurations[timeBucket];
+}
+
+/*
+    Calculate the minimal duration to a target node from a source stop. Fill the vector with the border stop durations of the nodes on the path if they are not already filled.
+    The path goes up from the leaf of the source stop to the child of the lowest common ancestor, to its sibling and down to the target node.
+    The durations of a time bucket are only lower bounds for journeys within the horizon, so they are capped by it.
+*/
+int GTree::getMinimalDurationToNode(int sourceStopId, int targetNodeId, vector<vector<int>> &nodeToBorderStopDurations, int timeBucket) {
     int minDuration = INT_MAX;
-    
-    // get the path from the source stop to the target node in the G-tree
-    vector<int> path = getNodePath(sourceStopId, targetNodeId);
 
     // default case: the source stop is in the target node
     if(isVertexInNode(sourceStopId, targetNodeId)) {
         return 0;
     }
 
-    // fill the map with the border stop durations of the first node if it is not already filled
-    int sourceNodeId = path[0];
-    if (nodeToBorderStopDurations.find(sourceNodeId) == nodeToBorderStopDurations.end()) {
-        vector<pair<int, int>> distancesToBorderStops = vector<pair<int, int>>(0);
-        for (int i = 0; i < nodeOfNodeId[path[0]]->borderStopIds.size(); i++) {
-            int borderStopId = nodeOfNodeId[path[0]]->borderStopIds[i];
-            int distanceToBorderStop = nodeOfStopId[sourceStopId]->borderDurations[make_pair(sourceStopId, borderStopId)];
-            distancesToBorderStops.push_back(make_pair(distanceToBorderStop, borderStopId));
+    // fill the vector with the border stop durations of the leaf if it is not already filled
+    int sourceNodeId = nodeIdOfStopId[sourceStopId];
+    if (nodeToBorderStopDurations[sourceNodeId].empty()) {
+        GNode &sourceNode = nodes[sourceNodeId];
+        const unsigned int* sourceDurations = getDurationMatrix(sourceNodeId, timeBucket);
+        int rowOffset = indexOfStopIdInLeaf[sourceStopId] * sourceNode.stopIds.size();
+        vector<int> distancesToBorderStops = vector<int>(sourceNode.borderIndices.size());
+        for (int i = 0; i < sourceNode.borderIndices.size(); i++) {
+            distancesToBorderStops[i] = sourceDurations[rowOffset + sourceNode.borderIndices[i]];
         }
         nodeToBorderStopDurations[sourceNodeId] = distancesToBorderStops;
     }
 
-    // fill the map with the border stop durations of the other nodes on the path if they are not already filled
-    int previousNodeId = path[0];
-    for(int i = 1; i < path.size(); i++) {
-        int currentNodeId = path[i];
-        if (nodeToBorderStopDurations.find(currentNodeId) == nodeToBorderStopDurations.end()) {
-            vector<pair<int, int>> distancesToBorderStopsOfPreviousNode = nodeToBorderStopDurations[previousNodeId];
-            vector<pair<int, int>> distancesToBorderStopsOfCurrentNode = vector<pair<int, int>>(0);
-            int parentNodeId;
-            // case 1: the node is a parent of the previous node
-            if (nodeOfNodeId[previousNodeId]->parent->nodeId == currentNodeId) {
-                parentNodeId = currentNodeId;
-            }
-            // case 2: the node is a sibling of the previous node
-            else if (nodeOfNodeId[previousNodeId]->parent->nodeId == nodeOfNodeId[currentNodeId]->parent->nodeId) {
-                parentNodeId = nodeOfNodeId[currentNodeId]->parent->nodeId;
-            }
-            // case 3: the node is a child of the previous node
-            else {
-                parentNodeId = previousNodeId;
-            }
+    int lowestCommonAncestorDepth = depthOfNodeId[getLowestCommonAncestor(sourceNodeId, targetNodeId)];
 
-            // calculate the duration by adding the border stop durations of the previous node to the border stop durations of the current node
-            for (int j = 0; j < nodeOfNodeId[currentNodeId]->borderStopIds.size(); j++) {
-                int borderStopId = nodeOfNodeId[currentNodeId]->borderStopIds[j];
-                int minDistanceToCurrentBorderStop = INT_MAX;
-                for (int k = 0; k < distancesToBorderStopsOfPreviousNode.size(); k++) {
-                    int distanceToPreviousBorderStop = distancesToBorderStopsOfPreviousNode[k].first;
-                    int previousBorderStopId = distancesToBorderStopsOfPreviousNode[k].second;
-                    int distanceBetweenBorderStops = nodeOfNodeId[parentNodeId]->borderDurations[make_pair(previousBorderStopId, borderStopId)];
-                    if (distanceToPreviousBorderStop == INT_MAX || distanceBetweenBorderStops == INT_MAX) {
-                        continue;
-                    }
-                    int distanceToBorderStopOfCurrentNode = distanceToPreviousBorderStop + distanceBetweenBorderStops;
-                    if (distanceToBorderStopOfCurrentNode < minDistanceToCurrentBorderStop) {
-                        minDistanceToCurrentBorderStop = distanceToBorderStopOfCurrentNode;
-                    }
-                }
-                distancesToBorderStopsOfCurrentNode.push_back(make_pair(minDistanceToCurrentBorderStop, borderStopId));
-            }
+    // the nodes on the upward path are parents of the previous node
+    int previousNodeId = sourceNodeId;
+    for (int depth = depthOfNodeId[sourceNodeId] - 1; depth > lowestCommonAncestorDepth; depth--) {
+        int currentNodeId = getAncestorOfNode(sourceNodeId, depth);
+        if (nodeToBorderStopDurations[currentNodeId].empty()) {
+            GNode &previousNode = nodes[previousNodeId];
+            nodeToBorderStopDurations[currentNodeId] = getMinPlusProduct(nodeToBorderStopDurations[previousNodeId], currentNodeId, previousNode.borderIndicesInParent, nodes[currentNodeId].borderIndices, timeBucket);
+        }
+        previousNodeId = currentNodeId;
+    }
 
-            nodeToBorderStopDurations[currentNodeId] = distancesToBorderStopsOfCurrentNode;
+    // the first node on the downward path is a sibling of the previous node, the other nodes are children of the previous node
+    for (int depth = lowestCommonAncestorDepth + 1; depth <= depthOfNodeId[targetNodeId]; depth++) {
+        int currentNodeId = getAncestorOfNode(targetNodeId, depth);
+        if (nodeToBorderStopDurations[currentNodeId].empty()) {
+            GNode &previousNode = nodes[previousNodeId];
+            GNode &currentNode = nodes[currentNodeId];
+            if (depth == lowestCommonAncestorDepth + 1) {
+                nodeToBorderStopDurations[currentNodeId] = getMinPlusProduct(nodeToBorderStopDurations[previousNodeId], currentNode.parentNodeId, previousNode.borderIndicesInParent, currentNode.borderIndicesInParent, timeBucket);
+            } else {
+                nodeToBorderStopDurations[currentNodeId] = getMinPlusProduct(nodeToBorderStopDurations[previousNodeId], previousNodeId, previousNode.borderIndices, currentNode.borderIndicesInParent, timeBucket);
+            }
         }
         previousNodeId = currentNodeId;
     }
 
     // get the minimal duration to the target node
-    vector<pair<int, int>> distancesToBorderStops = nodeToBorderStopDurations[targetNodeId];
+    vector<int> &distancesToBorderStops = nodeToBorderStopDurations[targetNodeId];
     for (int i = 0; i < distancesToBorderStops.size(); i++) {
-        int distanceToBorderStop = distancesToBorderStops[i].first;
+        int distanceToBorderStop = distancesToBorderStops[i];
         if (distanceToBorderStop < minDuration) {
             minDuration = distanceToBorderStop;
         }
     }
 
+    if (timeBucket != -1) {
+        minDuration = min(minDuration, GTREE_TIME_BUCKET_HORIZON);
+    }
     return minDuration;
 }
 
 /*
-    Calculate the minimal duration to a target stop from a source stop. Fill the map with the border stop durations of the nodes on the path if they are not already filled.
+    Calculate the minimal duration to a target stop from a source stop. Fill the vector with the border stop durations of the nodes on the path if they are not already filled.
 
+    The durations of a time bucket are capped by its horizon.
 */
-int GTree::getMinimalDurationToStop(int sourceStopId, int targetStopId, map<int, vector<pair<int, int>>> &nodeToBorderStopDurations) {
+int GTree::getMinimalDurationToStop(int sourceStopId, int targetStopId, vector<vector<int>> &nodeToBorderStopDurations, int timeBucket) {
     int minDuration = INT_MAX;
 
+    int targetNodeId = nodeIdOfStopId[targetStopId];
+    GNode &targetNode = nodes[targetNodeId];
+    const unsigned int* targetDurations = getDurationMatrix(targetNodeId, timeBucket);
+    int numberOfStops = targetNode.stopIds.size();
+    int targetIndex = indexOfStopIdInLeaf[targetStopId];
+
     // default case: the source stop is in the same node as the target stop
-    if (nodeOfStopId[sourceStopId]->nodeId == nodeOfStopId[targetStopId]->nodeId) {
-        return nodeOfStopId[sourceStopId]->borderDurations[make_pair(sourceStopId, targetStopId)];
-    }
+    if (nodeIdOfStopId[sourceStopId] == targetNodeId) {
+        minDuration = targetDurations[indexOfStopIdInLeaf[sourceStopId] * numberOfStops + targetIndex];
+    } else {
+        // fill the vector with the border stop durations of the target node if it is not already filled
+        if (nodeToBorderStopDurations[targetNodeId].empty()) {
+            getMinimalDurationToNode(sourceStopId, targetNodeId, nodeToBorderStopDurations, timeBucket);
+        }
 
-    int targetNodeId = nodeOfStopId[targetStopId]->nodeId;
+        vector<int> &distancesToBorderStops = nodeToBorderStopDurations[targetNodeId];
 
-    // fill the map with the border stop durations of the target node if it is not already filled
-    if (nodeToBorderStopDurations.find(targetNodeId) == nodeToBorderStopDurations.end()) {
-        getMinimalDurationToNode(sourceStopId, targetNodeId, nodeToBorderStopDurations);
+        // get the minimal duration to the target stop
+        for (int i = 0; i < distancesToBorderStops.size(); i++) {
+            int distanceToBorderStop = distancesToBorderStops[i];
+            int distanceToTargetStop = targetDurations[targetNode.borderIndices[i] * numberOfStops + targetIndex];
+            if (distanceToBorderStop == INT_MAX || distanceToTargetStop == INT_MAX) {
+                continue;
+            }
+            int duration = distanceToBorderStop + distanceToTargetStop;
+
+            if (duration < minDuration) {
+                minDuration = duration;
+            }
+        }
     }
 
-    vector<pair<int, int>> distancesToBorderStops = nodeToBorderStopDurations[targetNodeId];
+    if (timeBucket != -1) {
+        minDuration = min(minDuration, GTREE_TIME_BUCKET_HORIZON);
+    }
+    return minDuration;
+}
 
-    // get the minimal duration to the target stop
-    for (int i = 0; i < distancesToBorderStops.size(); i++) {
-        int distanceToBorderStop = distancesToBorderStops[i].first;
-        int borderStopId = distancesToBorderStops[i].second;
-        int distanceToTargetStop = nodeOfStopId[targetStopId]->borderDurations[make_pair(borderStopId, targetStopId)];
-        if (distanceToBorderStop == INT_MAX || distanceToTargetStop == INT_MAX) {
+/*
+    Calculate the min-plus product of the durations to the row stops and the duration matrix of a node restricted to the rows and columns. 
+    Every row is read contiguously, the result contains the minimal duration to each column stop.
+*/
+vector<int> GTree::getMinPlusProduct(vector<int> &durations, int nodeId, vector<int> &rowIndices, vector<int> &columnIndices, int timeBucket) {
+    GNode &node = nodes[nodeId];
+    const unsigned int* nodeDurations = getDurationMatrix(nodeId, timeBucket);
+    int numberOfStops = node.stopIds.size();
+    vector<int> minDurations = vector<int>(columnIndices.size(), INT_MAX);
+
+    for (int i = 0; i < rowIndices.size(); i++) {
+        int durationToRowStop = durations[i];
+        if (durationToRowStop == INT_MAX) {
             continue;
         }
-        int duration = distanceToBorderStop + distanceToTargetStop;
-
-        if (duration < minDuration) {
-            minDuration = duration;
+        const unsigned int* row = &nodeDurations[rowIndices[i] * numberOfStops];
+        for (int j = 0; j < columnIndices.size(); j++) {
+            int durationBetweenStops = row[columnIndices[j]];
+            if (durationBetweenStops == INT_MAX) {
+                continue;
+            }
+            int duration = durationToRowStop + durationBetweenStops;
+            if (duration < minDurations[j]) {
+                minDurations[j] = duration;
+            }
         }
     }
 
-    return minDuration;
+    return minDurations;
 }
 
 /*
-    Get the path from a source stop to a target stop in the G-tree.
+    Get the duration matrix of a node for a time bucket. The matrices of a mapped tree are read from the file, the node is marked as 
+    recently used.
 */
-vector<int> GTree::getNodePath(int stopId, int nodeId) {
-    int rootId = root->nodeId;
-    vector<int> path;
-    vector<int> upwardPath;
-    vector<int> downwardPath;
-
-    upwardPath.push_back(nodeOfStopId[stopId]->nodeId);
-    downwardPath.push_back(nodeId);
-
-    while (upwardPath.back() != downwardPath.back()) {
-        int upwardPathLastNodeId = upwardPath.back();
-        int downwardPathLastNodeId = downwardPath.back();
-        if(upwardPathLastNodeId != rootId && 
-            downwardPathLastNodeId != rootId && 
-            nodeOfNodeId[upwardPathLastNodeId]->parent->nodeId == nodeOfNodeId[downwardPathLastNodeId]->parent->nodeId) {
-            break;
-        } 
-        if(upwardPathLastNodeId < downwardPathLastNodeId) {
-            downwardPath.push_back(nodeOfNodeId[downwardPathLastNodeId]->parent->nodeId);
-        } else {
-            upwardPath.push_back(nodeOfNodeId[upwardPathLastNodeId]->parent->nodeId);
-        }
+const unsigned int* GTree::getDurationMatrix(int nodeId, int timeBucket) {
+    if (!isMapped() || (timeBucket != -1 && timeBucket < numberOfTimeBuckets)) {
+        return nodes[nodeId].getDurations(timeBucket).data();
     }
+    touchNode(nodeId);
+    return mappedDurations + durationOffsets[nodeId];
+}
 
-    for (int i = 0; i < upwardPath.size(); i++) {
-        path.push_back(upwardPath[i]);
+/*
+    Mark the matrix of a node as the most recently used one. If the resident matrices exceed the cache size, the pages of the least 
+    recently used matrices are released. They are loaded again from the file when they are used, so released matrices stay valid.
+*/
+void GTree::touchNode(int nodeId) {
+    #pragma omp critical(gTreeNodeCache)
+    {
+        if (isNodeResident[nodeId]) {
+            numberOfNodeCacheHits++;
+            residentNodeIds.splice(residentNodeIds.begin(), residentNodeIds, residentNodePositions[nodeId]);
+        } else {
+            numberOfNodeCacheMisses++;
+            residentNodeIds.push_front(nodeId);
+            residentNodePositions[nodeId] = residentNodeIds.begin();
+            isNodeResident[nodeId] = true;
+            residentDurationBytes += (durationOffsets[nodeId + 1] - durationOffsets[nodeId]) * sizeof(unsigned int);
+
+            long long maxResidentDurationBytes = (long long) GTREE_NODE_CACHE_SIZE_IN_MB * 1000000;
+            long pageSize = sysconf(_SC_PAGESIZE);
+            while (residentDurationBytes > maxResidentDurationBytes && residentNodeIds.size() > 1) {
+                int evictedNodeId = residentNodeIds.back();
+                residentNodeIds.pop_back();
+                isNodeResident[evictedNodeId] = false;
+                residentDurationBytes -= (durationOffsets[evictedNodeId + 1] - durationOffsets[evictedNodeId]) * sizeof(unsigned int);
+
+                // release only the pages that lie completely inside the matrix, pages that are shared with other matrices stay resident
+                long long begin = (char*) (mappedDurations + durationOffsets[evictedNodeId]) - mappedFile;
+                long long end = (char*) (mappedDurations + durationOffsets[evictedNodeId + 1]) - mappedFile;
+                begin = (begin + pageSize - 1) / pageSize * pageSize;
+                end -= end % pageSize;
+                if (end > begin) {
+                    madvise(mappedFile + begin, end - begin, MADV_DONTNEED);
+                }
+            }
+        }
     }
+}
 
-    for (int i = downwardPath.size() - 1; i >= 0; i--) {
-        if (path.back() == downwardPath[i]) {  
-            continue;
-        }
-        path.push_back(downwardPath[i]);
+/*
+    Unmap the binary file of a mapped tree.
+*/
+void GTree::unmapDurations() {
+    if (mappedFile != nullptr) {
+        munmap(mappedFile, mappedFileSize);
     }
+    mappedFile = nullptr;
+    mappedFileSize = 0;
+    mappedDurations = nullptr;
+    residentNodeIds.clear();
+    residentDurationBytes = 0;
+}
 
-    return path;
+/*
+    Check if the duration matrices are mapped from the binary file.
+*/
+bool GTree::isMapped() {
+    return mappedDurations != nullptr;
 }
 
 /*
-    Check if a stop is in a node.
+    Get the size of the duration matrices of all nodes and time buckets. The size only depends on the stops of the nodes, so it is 
+    known before the matrices are calculated.
 */
-bool GTree::isVertexInNode(int stopId, int nodeId) {
-    if (nodeOfStopId[stopId]->nodeId == nodeId || nodeId == root->nodeId) {
-        return true;
+long long GTree::getSizeOfDurationsInBytes() {
+    long long numberOfEntries = 0;
+    for (int i = 0; i < nodes.size(); i++) {
+        numberOfEntries += (long long) nodes[i].stopIds.size() * nodes[i].stopIds.size();
     }
+    return numberOfEntries * (1 + numberOfTimeBuckets) * sizeof(unsigned int);
+}
 
-    vector<int> upwardPath;
+/*
+    Print the hits and misses of the resident node matrices of a mapped tree.
+*/
+void GTree::printNodeCacheStatistics() {
+    long long numberOfAccesses = numberOfNodeCacheHits + numberOfNodeCacheMisses;
+    double hitRate = numberOfAccesses > 0 ? (double) numberOfNodeCacheHits / numberOfAccesses : 0;
+    cout << "G-tree node cache: " << numberOfNodeCacheHits << " hits, " << numberOfNodeCacheMisses << " misses (hit rate " << hitRate << "), ";
+    cout << residentNodeIds.size() << " resident nodes with " << residentDurationBytes / 1000000 << " MB." << endl;
+}
 
-    upwardPath.push_back(nodeOfStopId[stopId]->nodeId);
+GTree::~GTree() {
+    unmapDurations();
+}
 
-    while (upwardPath.back() != root->nodeId) {
-        int upwardPathLastNodeId = upwardPath.back();
-        if (upwardPathLastNodeId == nodeId) {
-            return true;
-        }
-        upwardPath.push_back(nodeOfNodeId[upwardPathLastNodeId]->parent->nodeId);
+/*
+    Get the lowest common ancestor of two nodes. It is the node with the minimal depth between their first occurrences in the euler tour.
+*/
+int GTree::getLowestCommonAncestor(int nodeId1, int nodeId2) {
+    int left = eulerIndexOfNodeId[nodeId1];
+    int right = eulerIndexOfNodeId[nodeId2];
+    if (left > right) {
+        swap(left, right);
     }
 
-    return false;
+    int k = 31 - __builtin_clz(right - left + 1);
+    int candidate1 = eulerTourSparseTable[k][left];
+    int candidate2 = eulerTourSparseTable[k][right - (1 << k) + 1];
+    return depthOfNodeId[candidate1] <= depthOfNodeId[candidate2] ? candidate1 : candidate2;
 }
 
 /*
-    Save the information of the tree in a json file such that it can be loaded.
+    Get the ancestor of a node at the given depth.
 */
-void GTree::exportTreeAsJson(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf, int numberOfFiles) {
-    cout << "Exporting G-tree as json file..." << endl;
+int GTree::getAncestorOfNode(int nodeId, int depth) {
+    return rootPaths[rootPathOffsetOfNodeId[nodeId] + depth];
+}
 
-    vector<GNode*> nodes = vector<GNode*>(0);
-    vector<GNode*> tmpNodes = vector<GNode*>(0);
-    nodes.push_back(this->root);
-    tmpNodes.push_back(this->root);
+/*
+    Check if a stop is in a node. This is the case if the node is an ancestor of the leaf of the stop.
+*/
+bool GTree::isVertexInNode(int stopId, int nodeId) {
+    int leafNodeId = nodeIdOfStopId[stopId];
+    return depthOfNodeId[nodeId] <= depthOfNodeId[leafNodeId] && getAncestorOfNode(leafNodeId, depthOfNodeId[nodeId]) == nodeId;
+}
 
-    // get all nodes of the tree
-    while(tmpNodes.size() > 0){
-        GNode* node = tmpNodes[0];
-        tmpNodes.erase(tmpNodes.begin());
-        for (int i = 0; i < node->children.size(); i++) {
-            nodes.push_back(node->children[i]);
-            tmpNodes.push_back(node->children[i]);
-        }
+/*
+    Save the information of the tree in a json file such that it can be loaded.
+*/
+void GTree::exportTreeAsJson(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf, int numberOfFiles) {
+    if (isMapped()) {
+        cout << "A mapped G-tree can't be exported." << endl;
+        return;
     }
+    cout << "Exporting G-tree as json file..." << endl;
 
     // calculate the number of nodes per file
     int nodesPerFile = ((nodes.size() - 1) / (numberOfFiles - 1)) + 1;
@@ -259,38 +382,45 @@ void GTree::exportTreeAsJson(DataType dataType, int numberOfChildrenPerNode, int
         }
 
         for (int nodeIndex = lowerNodeIndex; nodeIndex < upperNodeIndex && nodeIndex < nodes.size(); nodeIndex++) {
-            GNode* node = nodes[nodeIndex];
+            GNode &node = nodes[nodeIndex];
 
             file << "    {\n";
-            file << "      \"nodeId\": " << node->nodeId << ",\n";
-            if (node->nodeId == 0) {
+            file << "      \"nodeId\": " << node.nodeId << ",\n";
+            if (node.parentNodeId == -1) {
                 file << "      \"parent\": null,\n";
             } else {
-                file << "      \"parent\": " << node->parent->nodeId << ",\n";
+                file << "      \"parent\": " << node.parentNodeId << ",\n";
             }
 
             file << "      \"stopIds\": [";
-            for (int i = 0; i < node->stopIds.size(); i++) {
-                file << node->stopIds[i];
-                if (i < node->stopIds.size() - 1) {
+            for (int i = 0; i < node.stopIds.size(); i++) {
+                file << Importer::getExternalStopId(node.stopIds[i]);
+                if (i < node.stopIds.size() - 1) {
                     file << ", ";
                 }
             }
             file << "],\n";
 
             file << "      \"borderStopIds\": [";
-            for (int i = 0; i < node->borderStopIds.size(); i++) {
-                file << node->borderStopIds[i];
-                if (i < node->borderStopIds.size() - 1) {
+            for (int i = 0; i < node.borderStopIds.size(); i++) {
+                file << Importer::getExternalStopId(node.borderStopIds[i]);
+                if (i < node.borderStopIds.size() - 1) {
                     file << ", ";
                 }
             }
             file << "],\n";
 
+            // durations of 0 are skipped because they are the default of the duration matrix
             file << "      \"borderDurations\": [\n";
-            for (auto const& entry : node->borderDurations) {
-                file << "        {\"source\": " << entry.first.first << ", \"target\": " << entry.first.second << ", \"duration\": " << entry.second << "}";
-                file << ",\n";
+            for (int i = 0; i < node.stopIds.size(); i++) {
+                for (int j = 0; j < node.stopIds.size(); j++) {
+                    int duration = node.getDuration(i, j);
+                    if (duration == 0) {
+                        continue;
+                    }
+                    file << "        {\"source\": " << Importer::getExternalStopId(node.stopIds[i]) << ", \"target\": " << Importer::getExternalStopId(node.stopIds[j]) << ", \"duration\": " << duration << "}";
+                    file << ",\n";
+                }
             }
             file << "      ]\n";
 
@@ -337,101 +467,452 @@ void GTree::importTreeFromJson(DataType dataType, int numberOfChildrenPerNode, i
 
         if (fileId == 0) {
             int numberOfNodes = root["numberOfNodes"].asInt();
-            this->nodeOfNodeId = vector<GNode*>(numberOfNodes, nullptr);
+            this->nodes = vector<GNode>(numberOfNodes);
         }
         
-        Json::Value nodes = root["nodes"];
+        Json::Value jsonNodes = root["nodes"];
 
-        for (int i = 0; i < nodes.size(); i++) {
-            Json::Value node = nodes[i];
-            GNode* gNode = new GNode();
-            gNode->nodeId = node["nodeId"].asInt();
+        for (int i = 0; i < jsonNodes.size(); i++) {
+            Json::Value node = jsonNodes[i];
+            GNode &gNode = this->nodes[node["nodeId"].asInt()];
+            gNode.nodeId = node["nodeId"].asInt();
 
             if (node["parent"].isNull()) {
-                gNode->parent = nullptr;
+                gNode.parentNodeId = -1;
             } else {
-                gNode->parent = nodeOfNodeId[node["parent"].asInt()];
+                gNode.parentNodeId = node["parent"].asInt();
             }
 
             for (int j = 0; j < node["stopIds"].size(); j++) {
-                gNode->stopIds.push_back(node["stopIds"][j].asInt());
+                gNode.stopIds.push_back(Importer::getInternalStopId(node["stopIds"][j].asInt()));
             }
 
             for (int j = 0; j < node["borderStopIds"].size(); j++) {
-                gNode->borderStopIds.push_back(node["borderStopIds"][j].asInt());
+                gNode.borderStopIds.push_back(Importer::getInternalStopId(node["borderStopIds"][j].asInt()));
             }
 
+            gNode.initializeDurations();
             for (int j = 0; j < node["borderDurations"].size(); j++) {
                 Json::Value borderDuration = node["borderDurations"][j];
-                gNode->borderDurations[make_pair(borderDuration["source"].asInt(), borderDuration["target"].asInt())] = borderDuration["duration"].asInt();
+                int sourceStopId = Importer::getInternalStopId(borderDuration["source"].asInt());
+                int targetStopId = Importer::getInternalStopId(borderDuration["target"].asInt());
+                gNode.setDuration(gNode.indexOfStopId[sourceStopId], gNode.indexOfStopId[targetStopId], borderDuration["duration"].asInt());
             }
 
-            gNode->children = vector<GNode*>(0);
+            gNode.childNodeIds = vector<int>(0);
+        }
+
+        file.close();
+    }
+
+    this->rootNodeId = 0;
+
+    for (int i = this->nodes.size()-1; i > 0; i--) {
+        GNode &node = this->nodes[i];
+        if (node.parentNodeId != -1) {
+            this->nodes[node.parentNodeId].childNodeIds.push_back(i);
+        }
+    }
+
+    buildLocalIndices();
+
+    cout << "G-tree imported.\n" << endl;
+}
+
+/*
+    Get the path of the binary file of the G-tree.
+*/
+string GTree::getBinaryFileName(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf) {
+    string dataTypeString = Importer::getDataTypeString(dataType);
+    string fileName = FOLDER_PREFIX + "graphs/" + dataTypeString + "/g-tree-" + to_string(numberOfChildrenPerNode) + "-" + to_string(maxNumberOfVerticesPerLeaf);
+    if (USE_FOOTPATHS) {
+        fileName += "-with-footpaths";
+    }
+    fileName += ".bin";
+    return fileName;
+}
+
+/*
+    Save the G-tree as binary file. The file starts with a header of 32 bit integers (version, parameters, number of nodes, number of stops
+    and the total numbers of stop ids and border stop ids), followed by the 64 bit offsets of the duration matrices, the parent node ids,
+    the offsets and the (external) ids of the stops and border stops and finally the row-major duration matrices of all nodes.
+*/
+void GTree::exportTreeAsBinary(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf) {
+    if (isMapped()) {
+        cout << "A mapped G-tree can't be exported." << endl;
+        return;
+    }
+    cout << "Exporting G-tree as binary file..." << endl;
+    string fileName = getBinaryFileName(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf);
+
+    remove(fileName.c_str());
 
-            this->nodeOfNodeId[gNode->nodeId] = gNode;
+    ofstream file;
+    file.open(fileName, ios::binary);
+
+    if (!file.is_open()) {
+        cout << "Could not open file " << fileName << endl;
+        return;
+    }
+
+    int numberOfNodes = nodes.size();
+    vector<long long> durationOffsets = vector<long long>(numberOfNodes + 1, 0);
+    vector<int> parentNodeIds = vector<int>(numberOfNodes);
+    vector<int> stopIdOffsets = vector<int>(numberOfNodes + 1, 0);
+    vector<int> borderStopIdOffsets = vector<int>(numberOfNodes + 1, 0);
+    vector<int> allStopIds = vector<int>(0);
+    vector<int> allBorderStopIds = vector<int>(0);
+
+    for (int i = 0; i < numberOfNodes; i++) {
+        GNode &node = nodes[i];
+        parentNodeIds[i] = node.parentNodeId;
+        durationOffsets[i + 1] = durationOffsets[i] + node.durations.size();
+        stopIdOffsets[i + 1] = stopIdOffsets[i] + node.stopIds.size();
+        borderStopIdOffsets[i + 1] = borderStopIdOffsets[i] + node.borderStopIds.size();
+        for (int j = 0; j < node.stopIds.size(); j++) {
+            allStopIds.push_back(Importer::getExternalStopId(node.stopIds[j]));
+        }
+        for (int j = 0; j < node.borderStopIds.size(); j++) {
+            allBorderStopIds.push_back(Importer::getExternalStopId(node.borderStopIds[j]));
         }
+    }
+
+    int header[8] = {GTREE_BINARY_VERSION, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf, numberOfNodes, (int) Importer::stops.size(), 
+        (int) allStopIds.size(), (int) allBorderStopIds.size(), 0};
+    file.write((char*) header, sizeof(header));
+    file.write((char*) durationOffsets.data(), durationOffsets.size() * sizeof(long long));
+
+    vector<vector<int>*> arrays = {&parentNodeIds, &stopIdOffsets, &borderStopIdOffsets, &allStopIds, &allBorderStopIds};
+    for (int i = 0; i < arrays.size(); i++) {
+        file.write((char*) arrays[i]->data(), arrays[i]->size() * sizeof(int));
+    }
+
+    for (int i = 0; i < numberOfNodes; i++) {
+        file.write((char*) nodes[i].durations.data(), nodes[i].durations.size() * sizeof(unsigned int));
+    }
+
+    file.close();
+
+    cout << "G-tree exported.\n" << endl;
+}
+
+/*
+    Import the G-tree from the binary file. The duration matrices are read directly into the nodes. If mapDurations is true, the matrices 
+    stay in the file, which is mapped into memory, and their pages are only loaded when they are used. Returns false if the file doesn't 
+    exist or doesn't match the parameters.
+*/
+bool GTree::importTreeFromBinary(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf, bool mapDurations) {
+    string fileName = getBinaryFileName(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf);
+
+    ifstream file;
+    file.open(fileName, ios::binary);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    cout << "Importing G-tree from binary file..." << endl;
 
+    int header[8];
+    file.read((char*) header, sizeof(header));
+
+    if (!file || header[0] != GTREE_BINARY_VERSION || header[1] != numberOfChildrenPerNode || header[2] != maxNumberOfVerticesPerLeaf || header[4] != Importer::stops.size()) {
+        cout << "The G-tree could not be imported. The file " << fileName << " doesn't match the version or the parameters." << endl;
         file.close();
+        return false;
+    }
+
+    unmapDurations();
+
+    int numberOfNodes = header[3];
+    durationOffsets = vector<long long>(numberOfNodes + 1);
+    vector<int> parentNodeIds = vector<int>(numberOfNodes);
+    vector<int> stopIdOffsets = vector<int>(numberOfNodes + 1);
+    vector<int> borderStopIdOffsets = vector<int>(numberOfNodes + 1);
+    vector<int> allStopIds = vector<int>(header[5]);
+    vector<int> allBorderStopIds = vector<int>(header[6]);
+
+    file.read((char*) durationOffsets.data(), durationOffsets.size() * sizeof(long long));
+
+    vector<vector<int>*> arrays = {&parentNodeIds, &stopIdOffsets, &borderStopIdOffsets, &allStopIds, &allBorderStopIds};
+    for (int i = 0; i < arrays.size(); i++) {
+        file.read((char*) arrays[i]->data(), arrays[i]->size() * sizeof(int));
     }
 
-    this->nodeOfStopId = vector<GNode*>(Importer::stops.size(), nullptr);
-    this->root = this->nodeOfNodeId[0];
+    this->nodes = vector<GNode>(numberOfNodes);
+    this->rootNodeId = 0;
+
+    for (int i = 0; i < numberOfNodes; i++) {
+        GNode &node = nodes[i];
+        node.nodeId = i;
+        node.parentNodeId = parentNodeIds[i];
+        if (node.parentNodeId != -1) {
+            nodes[node.parentNodeId].childNodeIds.push_back(i);
+        }
 
-    for (int i = this->nodeOfNodeId.size()-1; i > 0; i--) {
-        GNode* node = this->nodeOfNodeId[i];
-        if (node->parent != nullptr) {
-            node->parent->children.push_back(node);
+        node.stopIds = vector<int>(allStopIds.begin() + stopIdOffsets[i], allStopIds.begin() + stopIdOffsets[i + 1]);
+        for (int j = 0; j < node.stopIds.size(); j++) {
+            node.stopIds[j] = Importer::getInternalStopId(node.stopIds[j]);
+        }
+        node.borderStopIds = vector<int>(allBorderStopIds.begin() + borderStopIdOffsets[i], allBorderStopIds.begin() + borderStopIdOffsets[i + 1]);
+        for (int j = 0; j < node.borderStopIds.size(); j++) {
+            node.borderStopIds[j] = Importer::getInternalStopId(node.borderStopIds[j]);
+        }
+
+        node.initializeIndexOfStopId();
+        if (durationOffsets[i + 1] - durationOffsets[i] != (long long) node.stopIds.size() * node.stopIds.size()) {
+            cout << "The G-tree could not be imported. The duration matrix of node " << i << " in " << fileName << " has the wrong size." << endl;
+            this->nodes.clear();
+            file.close();
+            return false;
+        }
+        if (!mapDurations) {
+            node.durations = vector<unsigned int>(durationOffsets[i + 1] - durationOffsets[i]);
+            file.read((char*) node.durations.data(), (durationOffsets[i + 1] - durationOffsets[i]) * sizeof(unsigned int));
         }
+    }
+
+    if (!file) {
+        cout << "Could not read file " << fileName << endl;
+        this->nodes.clear();
+        file.close();
+        return false;
+    }
 
-        if (node->children.size() == 0) {
-            for (int j = 0; j < node->stopIds.size(); j++) {
-                this->nodeOfStopId[node->stopIds[j]] = node;
+    long long durationsPosition = file.tellg();
+    file.close();
+
+    if (mapDurations) {
+        int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+        struct stat fileStatus;
+        if (fileDescriptor == -1 || fstat(fileDescriptor, &fileStatus) == -1 
+            || fileStatus.st_size < durationsPosition + durationOffsets[numberOfNodes] * (long long) sizeof(unsigned int)) {
+            cout << "Could not map file " << fileName << endl;
+            if (fileDescriptor != -1) {
+                close(fileDescriptor);
             }
+            this->nodes.clear();
+            return false;
         }
+
+        void* mapping = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+        close(fileDescriptor);
+        if (mapping == MAP_FAILED) {
+            cout << "Could not map file " << fileName << endl;
+            this->nodes.clear();
+            return false;
+        }
+
+        // the queries only touch few nodes, so the kernel shouldn't read ahead
+        madvise(mapping, fileStatus.st_size, MADV_RANDOM);
+
+        mappedFile = (char*) mapping;
+        mappedFileSize = fileStatus.st_size;
+        mappedDurations = (const unsigned int*) (mappedFile + durationsPosition);
+        residentNodeIds.clear();
+        residentNodePositions = vector<list<int>::iterator>(numberOfNodes);
+        isNodeResident = vector<bool>(numberOfNodes, false);
+        residentDurationBytes = 0;
+        numberOfNodeCacheHits = 0;
+        numberOfNodeCacheMisses = 0;
     }
 
+    buildLocalIndices();
+
     cout << "G-tree imported.\n" << endl;
+    return true;
 }
 
+/*
+    Calculate the rows of the given stops in the duration matrices of all nodes that contain them.
+*/
 void GTree::calculateBorderDistancesOfStopIds(vector<int> stopIds) {
+    if (isMapped()) {
+        cout << "The durations of a mapped G-tree can't be calculated." << endl;
+        return;
+    }
     auto start = std::chrono::high_resolution_clock::now();
     std::cout << "Max threads: " << omp_get_max_threads() << "\n";
+
+    vector<bool> isSourceStopId = vector<bool>(Importer::stops.size(), false);
+    for (int i = 0; i < stopIds.size(); i++) {
+        isSourceStopId[stopIds[i]] = true;
+    }
+
+    calculateDurationsOfNodes(Creator::networkGraph.adjacencyList, isSourceStopId, -1);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    cout << "Calculated the distances of " << stopIds.size() << " stops in " << duration << " milliseconds." << endl;
+}
+
+/*
+    Calculate the duration matrices of all time buckets. The matrices of a bucket contain the minimal ride times of the connections 
+    that depart between the begin of the bucket and its end plus the horizon, so they are lower bounds for all journeys within the 
+    horizon that start in the bucket.
+*/
+void GTree::calculateTimeBucketDurations() {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    int numberOfTimeBucketsPerDay = SECONDS_PER_DAY / GTREE_TIME_BUCKET_LENGTH;
+    numberOfTimeBuckets = 7 * numberOfTimeBucketsPerDay;
+
+    long long numberOfEntries = 0;
+    for (int i = 0; i < nodes.size(); i++) {
+        int numberOfStops = nodes[i].stopIds.size();
+        nodes[i].timeBucketDurations = vector<vector<unsigned int>>(numberOfTimeBuckets, vector<unsigned int>(numberOfStops * numberOfStops, 0));
+        numberOfEntries += (long long) numberOfTimeBuckets * numberOfStops * numberOfStops;
+    }
+
+    vector<bool> isSourceStopId = vector<bool>(Importer::stops.size(), true);
+    for (int i = 0; i < numberOfTimeBuckets; i++) {
+        int weekday = i / numberOfTimeBucketsPerDay;
+        int startTime = (i % numberOfTimeBucketsPerDay) * GTREE_TIME_BUCKET_LENGTH;
+        vector<vector<Edge>> adjacencyList = Creator::createTimeWindowAdjacencyList(weekday, startTime, startTime + GTREE_TIME_BUCKET_LENGTH + GTREE_TIME_BUCKET_HORIZON);
+        calculateDurationsOfNodes(adjacencyList, isSourceStopId, i);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    cout << "Calculated the durations of " << numberOfTimeBuckets << " time buckets in " << duration << " milliseconds (" << numberOfEntries * sizeof(unsigned int) / 1000000 << " MB)." << endl;
+}
+
+/*
+    Get the time bucket of a source time on a weekday. Returns -1 if the tree has no time buckets.
+*/
+int GTree::getTimeBucket(int sourceTime, int weekday) {
+    if (numberOfTimeBuckets == 0) {
+        return -1;
+    }
+    int numberOfTimeBucketsPerDay = SECONDS_PER_DAY / GTREE_TIME_BUCKET_LENGTH;
+    int dayOfSourceTime = (weekday + sourceTime / SECONDS_PER_DAY) % 7;
+    return dayOfSourceTime * numberOfTimeBucketsPerDay + (sourceTime % SECONDS_PER_DAY) / GTREE_TIME_BUCKET_LENGTH;
+}
+
+/*
+    Calculate the rows of the source stops in the duration matrices of a time bucket with the given adjacency list. The nodes are 
+    independent and processed in parallel. Every search from a source stop of a node stops as soon as all stops of the node are settled.
+*/
+void GTree::calculateDurationsOfNodes(vector<vector<Edge>> &adjacencyList, vector<bool> &isSourceStopId, int timeBucket) {
+    // process the large nodes first to balance the work of the threads
+    vector<int> nodeIds = vector<int>(nodes.size());
+    for (int i = 0; i < nodes.size(); i++) {
+        nodeIds[i] = i;
+    }
+    sort(nodeIds.begin(), nodeIds.end(), [this](int left, int right) {
+        return nodes[left].stopIds.size() > nodes[right].stopIds.size();
+    });
+
     #pragma omp parallel
     {
-        #pragma omp for
-        for (int i = 0; i < stopIds.size(); i++) {
-            int stopId = stopIds[i];
-            vector<int> targetStopIds = vector<int>(0);
-            GNode* node = nodeOfStopId[stopId];
-            while (node != nullptr) {
-                if (find(node->stopIds.begin(), node->stopIds.end(), stopId) != node->stopIds.end()) {
-                    for (int j = 0; j < node->stopIds.size(); j++) {
-                        if (node->stopIds[j] != stopId && find(targetStopIds.begin(), targetStopIds.end(), node->stopIds[j]) == targetStopIds.end()){
-                            targetStopIds.push_back(node->stopIds[j]);
-                        }
-                    }
-                } else {
-                    break;
+        // every thread reuses its own dijkstra state
+        DijkstraContext dijkstraContext = DijkstraContext(adjacencyList.size());
+
+        #pragma omp for schedule(dynamic)
+        for (int i = 0; i < nodeIds.size(); i++) {
+            GNode &node = nodes[nodeIds[i]];
+            vector<unsigned int> &durations = node.getDurations(timeBucket);
+            int numberOfStops = node.stopIds.size();
+            for (int j = 0; j < numberOfStops; j++) {
+                if (!isSourceStopId[node.stopIds[j]]) {
+                    continue;
+                }
+                dijkstraContext.calculateDistances(adjacencyList, node.stopIds[j], node.stopIds);
+                for (int k = 0; k < numberOfStops; k++) {
+                    durations[j * numberOfStops + k] = dijkstraContext.getDistance(node.stopIds[k]);
                 }
-                node = node->parent;
             }
+        }
+    }
+}
 
-            vector<int> distances = Creator::networkGraph.getDistances(stopId, targetStopIds);
+/*
+    Build the local indices of the nodes. The border stops get their indices in the duration matrices of the node and of its parent 
+    and every stop gets its leaf and its index in the leaf.
+*/
+void GTree::buildLocalIndices() {
+    nodeIdOfStopId = vector<int>(Importer::stops.size(), -1);
+    indexOfStopIdInLeaf = vector<int>(Importer::stops.size(), -1);
+
+    for (int i = 0; i < nodes.size(); i++) {
+        // the matrices of a mapped tree stay in the file
+        if (!isMapped() && nodes[i].durations.size() != nodes[i].stopIds.size() * nodes[i].stopIds.size()) {
+            nodes[i].initializeDurations();
+        }
+    }
 
-            node = nodeOfStopId[stopId];
-            while (node != nullptr) {
-                if (find(node->stopIds.begin(), node->stopIds.end(), stopId) != node->stopIds.end()) {
-                    for (int j = 0; j < node->stopIds.size(); j++) {
-                        node->borderDurations[make_pair(stopId, node->stopIds[j])] = distances[node->stopIds[j]];
-                    }
-                } else {
-                    break;
-                }
-                node = node->parent;
+    for (int i = 0; i < nodes.size(); i++) {
+        GNode &node = nodes[i];
+        node.borderIndices = vector<int>(node.borderStopIds.size());
+        node.borderIndicesInParent = vector<int>(node.borderStopIds.size(), -1);
+        for (int j = 0; j < node.borderStopIds.size(); j++) {
+            node.borderIndices[j] = node.indexOfStopId[node.borderStopIds[j]];
+            if (node.parentNodeId != -1) {
+                node.borderIndicesInParent[j] = nodes[node.parentNodeId].indexOfStopId[node.borderStopIds[j]];
+            }
+        }
+
+        if (node.childNodeIds.size() == 0) {
+            for (int j = 0; j < node.stopIds.size(); j++) {
+                nodeIdOfStopId[node.stopIds[j]] = i;
+                indexOfStopIdInLeaf[node.stopIds[j]] = j;
             }
         }
     }
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::minutes>(end - start).count();
-    cout << "Calculated " << stopIds.size() << " distances in " << duration << " minutes." << endl;
+
+    buildNodeHierarchy();
+}
+
+/*
+    Build the depths and root paths of the nodes and the euler tour with its sparse table for the lowest common ancestor queries.
+*/
+void GTree::buildNodeHierarchy() {
+    depthOfNodeId = vector<int>(nodes.size(), 0);
+    rootPathOffsetOfNodeId = vector<int>(nodes.size(), 0);
+    rootPaths = vector<int>(0);
+    eulerTour = vector<int>(0);
+    eulerIndexOfNodeId = vector<int>(nodes.size(), -1);
+    eulerTourSparseTable = vector<vector<int>>(0);
+
+    if (nodes.empty()) {
+        return;
+    }
+
+    // depth first search with the index of the next child of every node on the stack
+    vector<pair<int, int>> stack = vector<pair<int, int>>(1, make_pair(rootNodeId, 0));
+    vector<int> currentPath = vector<int>(0);
+    while (!stack.empty()) {
+        int nodeId = stack.back().first;
+        int childIndex = stack.back().second;
+        GNode &node = nodes[nodeId];
+
+        if (childIndex == 0) {
+            depthOfNodeId[nodeId] = currentPath.size();
+            currentPath.push_back(nodeId);
+            rootPathOffsetOfNodeId[nodeId] = rootPaths.size();
+            rootPaths.insert(rootPaths.end(), currentPath.begin(), currentPath.end());
+            eulerIndexOfNodeId[nodeId] = eulerTour.size();
+        }
+        eulerTour.push_back(nodeId);
+
+        if (childIndex < node.childNodeIds.size()) {
+            stack.back().second++;
+            stack.push_back(make_pair(node.childNodeIds[childIndex], 0));
+        } else {
+            currentPath.pop_back();
+            stack.pop_back();
+        }
+    }
+
+    eulerTourSparseTable.push_back(eulerTour);
+    for (int k = 1; (1 << k) <= eulerTour.size(); k++) {
+        vector<int> &previousRow = eulerTourSparseTable[k - 1];
+        vector<int> row = vector<int>(eulerTour.size() - (1 << k) + 1);
+        for (int i = 0; i < row.size(); i++) {
+            int candidate1 = previousRow[i];
+            int candidate2 = previousRow[i + (1 << (k - 1))];
+            row[i] = depthOfNodeId[candidate1] <= depthOfNodeId[candidate2] ? candidate1 : candidate2;
+        }
+        eulerTourSparseTable.push_back(row);
+    }
 }
\ No newline at end of file
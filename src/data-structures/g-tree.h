@@ -3,23 +3,44 @@
 
 #include <vector>
 #include <map>
+#include <list>
 #include <string>
 #include <../data-handling/importer.h>
+#include <../data-structures/graph.h>
 
 using namespace std;
 
 class GNode {
     public:
-        explicit GNode() {};
+        explicit GNode() {
+            this->nodeId = -1;
+            this->parentNodeId = -1;
+        };
         ~GNode(){};
 
         int nodeId;
-        GNode* parent;
-        vector<GNode*> children;
+        int parentNodeId;
+        vector<int> childNodeIds;
         vector<int> stopIds;
 
         vector<int> borderStopIds;
-        map<pair<int, int>, int> borderDurations;
+
+        // the local indices of the border stops in the duration matrix of the node and of its parent
+        vector<int> borderIndices;
+        vector<int> borderIndicesInParent;
+
+        // row-major duration matrix between the stops of the node, durations that are not calculated are 0
+        vector<unsigned int> durations;
+        map<int, int> indexOfStopId;
+
+        // optional duration matrices with the same layout for every time bucket
+        vector<vector<unsigned int>> timeBucketDurations;
+
+        void initializeIndexOfStopId();
+        void initializeDurations();
+        int getDuration(int sourceIndex, int targetIndex);
+        void setDuration(int sourceIndex, int targetIndex, int duration);
+        vector<unsigned int>& getDurations(int timeBucket);
 };
 
 /*
@@ -28,25 +49,77 @@ class GNode {
 class GTree {
     public:
         explicit GTree() {
-            this->root = new GNode();
-            this->nodeOfStopId = vector<GNode*>(0);
-            this->nodeOfNodeId = vector<GNode*>(0);
+            this->rootNodeId = 0;
+            this->numberOfTimeBuckets = 0;
+            this->nodes = vector<GNode>(0);
+            this->nodeIdOfStopId = vector<int>(0);
+            this->indexOfStopIdInLeaf = vector<int>(0);
+            this->numberOfNodeCacheHits = 0;
+            this->numberOfNodeCacheMisses = 0;
+            this->mappedFile = nullptr;
+            this->mappedFileSize = 0;
+            this->mappedDurations = nullptr;
+            this->residentDurationBytes = 0;
         };
-        ~GTree(){};
+        ~GTree();
 
-        GNode* root;
-        vector<GNode*> nodeOfStopId;
-        vector<GNode*> nodeOfNodeId;
+        int rootNodeId;
+        int numberOfTimeBuckets;
+        vector<GNode> nodes;
+        vector<int> nodeIdOfStopId;
+        vector<int> indexOfStopIdInLeaf;
 
-        int getMinimalDurationToNode(int sourceStopId, int targetNodeId, map<int, vector<pair<int, int>>> &nodeToBorderStopDurations);
-        int getMinimalDurationToStop(int sourceStopId, int targetStopId, map<int, vector<pair<int, int>>> &nodeToBorderStopDurations);
+        // the depth of every node and its path from the root, the node at depth d is stored at rootPaths[rootPathOffsetOfNodeId[i] + d]
+        vector<int> depthOfNodeId;
+        vector<int> rootPathOffsetOfNodeId;
+        vector<int> rootPaths;
+
+        // the hits and misses of the resident node matrices of a mapped tree
+        long long numberOfNodeCacheHits;
+        long long numberOfNodeCacheMisses;
+
+        int getMinimalDurationToNode(int sourceStopId, int targetNodeId, vector<vector<int>> &nodeToBorderStopDurations, int timeBucket = -1);
+        int getMinimalDurationToStop(int sourceStopId, int targetStopId, vector<vector<int>> &nodeToBorderStopDurations, int timeBucket = -1);
         void exportTreeAsJson(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf, int numberOfFiles);
         void importTreeFromJson(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf, int numberOfFiles);
+        void exportTreeAsBinary(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf);
+        bool importTreeFromBinary(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf, bool mapDurations = false);
+        bool isMapped();
+        long long getSizeOfDurationsInBytes();
+        void printNodeCacheStatistics();
+        static string getBinaryFileName(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf);
         void calculateBorderDistancesOfStopIds(vector<int> stopIds);
+        void calculateTimeBucketDurations();
+        int getTimeBucket(int sourceTime, int weekday);
+        void buildLocalIndices();
+        int getLowestCommonAncestor(int nodeId1, int nodeId2);
 
     private:
-        vector<int> getNodePath(int stopId, int nodeId);
+        // euler tour of the tree with a sparse table over it, entry (k, i) is the node with minimal depth in the tour range [i, i + 2^k)
+        vector<int> eulerTour;
+        vector<int> eulerIndexOfNodeId;
+        vector<vector<int>> eulerTourSparseTable;
+
+        // the mapped binary file, the matrix of node i starts at mappedDurations + durationOffsets[i]
+        char* mappedFile;
+        size_t mappedFileSize;
+        const unsigned int* mappedDurations;
+        vector<long long> durationOffsets;
+
+        // least recently used order of the node matrices that are resident, the most recent node is at the front
+        list<int> residentNodeIds;
+        vector<list<int>::iterator> residentNodePositions;
+        vector<bool> isNodeResident;
+        long long residentDurationBytes;
+
+        void buildNodeHierarchy();
+        int getAncestorOfNode(int nodeId, int depth);
         bool isVertexInNode(int stopId, int nodeId);
+        const unsigned int* getDurationMatrix(int nodeId, int timeBucket);
+        void touchNode(int nodeId);
+        void unmapDurations();
+        vector<int> getMinPlusProduct(vector<int> &durations, int nodeId, vector<int> &rowIndices, vector<int> &columnIndices, int timeBucket);
+        void calculateDurationsOfNodes(vector<vector<Edge>> &adjacencyList, vector<bool> &isSourceStopId, int timeBucket);
 };
 
 #endif //CMAKE_G_TREE_H
\ No newline at end of file
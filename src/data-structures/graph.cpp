@@ -2,9 +2,11 @@
 
 #include <../constants.h>
 #include <../data-handling/importer.h>
+#include <../data-handling/calculator.h>
 
 #include <limits.h>
 
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <queue>
@@ -12,6 +14,9 @@
 #include <iostream>
 #include <chrono>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <set>
 
 using namespace std;
 
@@ -19,53 +24,125 @@ using namespace std;
     Use Dijkstra's algorithm to calculate the minimal distance to a target node from a source stop.
 */
 vector<int> Graph::getDistances(int sourceStopId, vector<int> targetStopIds) {
-    vector<int> distances = vector<int>(this->vertices.size(), INT_MAX);
-    vector<bool> visited = vector<bool>(this->vertices.size(), false);
-    
-    distances[sourceStopId] = 0;
-    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    DijkstraContext context = DijkstraContext(this->vertices.size());
+    context.calculateDistances(this->adjacencyList, sourceStopId, targetStopIds);
 
-    int targetStopCounter = 0;
-    vector<bool> targetStopIdsFound = vector<bool>(targetStopIds.size(), false);
-    
-    pq.push(make_pair(0, sourceStopId));
+    vector<int> distances = vector<int>(this->vertices.size());
+    for (int i = 0; i < distances.size(); i++) {
+        distances[i] = context.getDistance(i);
+    }
+    return distances;
+}
 
-    while(!pq.empty()) {
-        int u = pq.top().second;
-        pq.pop();
+void RadixHeap::push(int key, int value) {
+    buckets[getBucketIndex(key)].push_back(make_pair(key, value));
+    size++;
+}
 
-        if (visited[u]) {
-            continue;
+/*
+    Returns the element with the smallest key. If the first bucket is empty, the next non empty bucket is redistributed around
+    its minimum key, which moves every element of it into a lower bucket.
+*/
+pair<int, int> RadixHeap::pop() {
+    if (buckets[0].empty()) {
+        int i = 1;
+        while (buckets[i].empty()) {
+            i++;
         }
 
-        for (int i = 0; i < targetStopIds.size(); i++) {
-            if (targetStopIds[i] == u) {
-                if (!targetStopIdsFound[i]) {
-                    targetStopIdsFound[i] = true;
-                    targetStopCounter++;
-                }
-                break;
-            }
+        int minimumKey = INT_MAX;
+        for (int j = 0; j < buckets[i].size(); j++) {
+            minimumKey = min(minimumKey, buckets[i][j].first);
         }
+        lastPoppedKey = minimumKey;
 
-        if (targetStopCounter == targetStopIds.size()) {
-            break;
+        for (int j = 0; j < buckets[i].size(); j++) {
+            buckets[getBucketIndex(buckets[i][j].first)].push_back(buckets[i][j]);
         }
+        buckets[i].clear();
+    }
 
-        for (int i = 0; i < this->adjacencyList[u].size(); i++) {
-            int v = this->adjacencyList[u][i].targetStopId;
-            int weight = this->adjacencyList[u][i].ewgt;
+    pair<int, int> element = buckets[0].back();
+    buckets[0].pop_back();
+    size--;
+    return element;
+}
 
-            if (distances[v] > distances[u] + weight) {
-                distances[v] = distances[u] + weight;
-                pq.push(make_pair(distances[v], v));
-            }
+bool RadixHeap::empty() {
+    return size == 0;
+}
+
+void RadixHeap::clear() {
+    for (int i = 0; i < 33; i++) {
+        buckets[i].clear();
+    }
+    size = 0;
+    lastPoppedKey = 0;
+}
+
+int RadixHeap::getBucketIndex(int key) {
+    if (key == lastPoppedKey) {
+        return 0;
+    }
+    return 32 - __builtin_clz(key ^ lastPoppedKey);
+}
+
+/*
+    Calculate the distances from the source stop until all target stops are settled. The targets are marked with the timestamp
+    of the search, so a settled vertex is checked in constant time.
+*/
+void DijkstraContext::calculateDistances(vector<vector<Edge>> &adjacencyList, int sourceStopId, vector<int> &targetStopIds) {
+    currentTimestamp++;
+    heap.clear();
+
+    int numberOfRemainingTargets = 0;
+    for (int i = 0; i < targetStopIds.size(); i++) {
+        if (targetTimestamps[targetStopIds[i]] != currentTimestamp) {
+            targetTimestamps[targetStopIds[i]] = currentTimestamp;
+            numberOfRemainingTargets++;
         }
+    }
 
-        visited[u] = true;
+    distances[sourceStopId] = 0;
+    distanceTimestamps[sourceStopId] = currentTimestamp;
+    heap.push(0, sourceStopId);
+
+    while (!heap.empty() && numberOfRemainingTargets > 0) {
+        pair<int, int> element = heap.pop();
+        int distance = element.first;
+        int u = element.second;
+
+        if (distance > distances[u]) {
+            continue;
+        }
+
+        if (targetTimestamps[u] == currentTimestamp) {
+            // a settled target is unmarked, so it is only counted once
+            targetTimestamps[u] = 0;
+            numberOfRemainingTargets--;
+        }
+
+        for (int i = 0; i < adjacencyList[u].size(); i++) {
+            int v = adjacencyList[u][i].targetStopId;
+            int newDistance = distance + adjacencyList[u][i].ewgt;
+
+            if (distanceTimestamps[v] != currentTimestamp || newDistance < distances[v]) {
+                distances[v] = newDistance;
+                distanceTimestamps[v] = currentTimestamp;
+                heap.push(newDistance, v);
+            }
+        }
     }
+}
 
-    return distances;
+/*
+    Returns the distance of the last search. It is only exact for the source and the target stops.
+*/
+int DijkstraContext::getDistance(int stopId) {
+    if (distanceTimestamps[stopId] != currentTimestamp) {
+        return INT_MAX;
+    }
+    return distances[stopId];
 }
 
 
@@ -92,11 +169,12 @@ void Graph::exportGraph(DataType dataType) {
     // header
     file << to_string(numberOfVertices) << " " << to_string(numberOfEdges / 2) << " " << "001" << endl;
 
-    // vertices
-    for(int i = 0; i < this->vertices.size(); i++) {
+    // vertices in the order of the external stop ids
+    for(int externalStopId = 0; externalStopId < this->vertices.size(); externalStopId++) {
+        int i = Importer::getInternalStopId(externalStopId);
         string line;
         for (int j = 0; j < this->adjacencyList[i].size(); j++) {
-            int targetStopId = this->adjacencyList[i][j].targetStopId + 1;
+            int targetStopId = Importer::getExternalStopId(this->adjacencyList[i][j].targetStopId) + 1;
             int edgeWeight = this->adjacencyList[i][j].ewgt;
             if (edgeWeight == 0) {
                 edgeWeight = 1;
@@ -136,12 +214,13 @@ void Graph::exportGraphWithCH(DataType dataType) {
     // header
     file << to_string(numberOfVertices) << " " << to_string(numberOfEdges) << endl;
 
-    // vertices
-    for(int i = 0; i < this->vertices.size(); i++) {
+    // vertices in the order of the external stop ids
+    for(int externalStopId = 0; externalStopId < this->vertices.size(); externalStopId++) {
+        int i = Importer::getInternalStopId(externalStopId);
         string line;
         line += to_string(this->vertices[i].level) + " ";
         for (int j = 0; j < this->adjacencyList[i].size(); j++) {
-            int targetStopId = this->adjacencyList[i][j].targetStopId + 1;
+            int targetStopId = Importer::getExternalStopId(this->adjacencyList[i][j].targetStopId) + 1;
             int edgeWeight = this->adjacencyList[i][j].ewgt;
             if (edgeWeight == 0) {
                 edgeWeight = 1;
@@ -181,7 +260,7 @@ void Graph::importPartition(DataType dataType, int numberOfPartitions) {
     this->partition = vector<int>(numberOfVertices);
 
     for (int i = 0; i < numberOfVertices; i++) {
-        file >> this->partition[i];
+        file >> this->partition[Importer::getInternalStopId(i)];
     }
 
     file.close();
@@ -218,7 +297,8 @@ void Graph::importGraphWithCH(DataType dataType) {
 
     this->stopIdsSortedByLevel = vector<int>(numberOfVertices);
 
-    for (int i = 0; i < numberOfVertices; i++) {
+    for (int externalStopId = 0; externalStopId < numberOfVertices; externalStopId++) {
+        int i = Importer::getInternalStopId(externalStopId);
         Vertex vertex;
 
         this->adjacencyList[i] = vector<Edge>();
@@ -238,7 +318,7 @@ void Graph::importGraphWithCH(DataType dataType) {
         stopIdsSortedByLevel[vertex.level] = i;
 
         while (ss >> numberString) {
-            int targetStopId = stoi(numberString) - 1;
+            int targetStopId = Importer::getInternalStopId(stoi(numberString) - 1);
             ss >> numberString;
             int edgeWeight = stoi(numberString);
             Edge edge;
@@ -254,9 +334,16 @@ void Graph::importGraphWithCH(DataType dataType) {
     }
 
     file.close();
+
+    chGraph = CHGraph(this->vertices, this->adjacencyList);
     cout << "Graph with CH imported.\n" << endl;
 }
 
+/*
+    Creates the contraction hierarchie in batches. In each iteration all uncontracted vertices whose edge difference is a local minimum
+    among their uncontracted neighbors form an independent set. The vertices of this set are contracted in parallel. Like in the serial
+    version, the edge differences of the neighbors are only marked as outdated and recalculated once the vertex gets selected.
+*/
 void Graph::createContractionHierarchie() {
     cout << "Creating contraction hierarchie..." << endl;
     auto start = chrono::high_resolution_clock::now();
@@ -265,6 +352,148 @@ void Graph::createContractionHierarchie() {
 
     vector<int> edgeDifferences = vector<int>(this->vertices.size(), 0);
 
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < this->vertices.size(); i++) {
+        edgeDifferences[i] = this->calculateEdgeDifferenceAndGetShortcuts(i).first;
+    }
+
+    vector<char> isOutdated = vector<char>(this->vertices.size(), 0);
+
+    vector<int> uncontractedStopIds = vector<int>(this->vertices.size());
+    for (int i = 0; i < this->vertices.size(); i++) {
+        uncontractedStopIds[i] = i;
+    }
+
+    int currentLevel = 0;
+    int numberOfBatches = 0;
+
+    while (!uncontractedStopIds.empty()) {
+        // select the vertices that have a smaller edge difference than all of their uncontracted neighbors (ties are broken by the id)
+        vector<char> isSelected = vector<char>(uncontractedStopIds.size(), 0);
+
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int i = 0; i < uncontractedStopIds.size(); i++) {
+            int vertexIndex = uncontractedStopIds[i];
+            bool isLocalMinimum = true;
+
+            for (int j = 0; j < this->adjacencyList[vertexIndex].size(); j++) {
+                int neighborStopId = this->adjacencyList[vertexIndex][j].targetStopId;
+
+                if (neighborStopId == vertexIndex || this->vertices[neighborStopId].level != -1) {
+                    continue;
+                }
+
+                if (make_pair(edgeDifferences[neighborStopId], neighborStopId) < make_pair(edgeDifferences[vertexIndex], vertexIndex)) {
+                    isLocalMinimum = false;
+                    break;
+                }
+            }
+
+            isSelected[i] = isLocalMinimum;
+        }
+
+        // the selected vertices are marked before the witness searches, so that they don't use vertices of the same batch
+        for (int i = 0; i < uncontractedStopIds.size(); i++) {
+            if (isSelected[i]) {
+                this->vertices[uncontractedStopIds[i]].level = INT_MAX;
+            }
+        }
+
+        vector<vector<Shortcut>> shortcutsPerVertex = vector<vector<Shortcut>>(uncontractedStopIds.size());
+
+        // outdated edge differences are recalculated together with the shortcuts, a vertex is postponed if its edge difference increased
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int i = 0; i < uncontractedStopIds.size(); i++) {
+            int vertexIndex = uncontractedStopIds[i];
+            if (!isSelected[i]) {
+                continue;
+            }
+
+            pair<int, vector<Shortcut>> edgeDifferenceAndShortcuts = this->calculateEdgeDifferenceAndGetShortcuts(vertexIndex);
+
+            if (isOutdated[vertexIndex]) {
+                if (edgeDifferenceAndShortcuts.first > edgeDifferences[vertexIndex]) {
+                    isSelected[i] = 0;
+                }
+                edgeDifferences[vertexIndex] = edgeDifferenceAndShortcuts.first;
+                isOutdated[vertexIndex] = 0;
+            }
+
+            if (isSelected[i]) {
+                shortcutsPerVertex[i] = edgeDifferenceAndShortcuts.second;
+            }
+        }
+
+        vector<int> independentSet = vector<int>();
+        vector<int> remainingStopIds = vector<int>();
+        for (int i = 0; i < uncontractedStopIds.size(); i++) {
+            int vertexIndex = uncontractedStopIds[i];
+            if (isSelected[i]) {
+                this->vertices[vertexIndex].level = currentLevel;
+                stopIdsSortedByLevel.push_back(vertexIndex);
+                independentSet.push_back(vertexIndex);
+                currentLevel++;
+            } else {
+                this->vertices[vertexIndex].level = -1;
+                remainingStopIds.push_back(vertexIndex);
+            }
+        }
+
+        // add the shortcuts, vertices of the same batch may create the same shortcut
+        for (int i = 0; i < shortcutsPerVertex.size(); i++) {
+            for (int j = 0; j < shortcutsPerVertex[i].size(); j++) {
+                Shortcut shortcut = shortcutsPerVertex[i][j];
+                vector<Edge>* edges = &this->adjacencyList[shortcut.sourceStopId];
+
+                bool addEdge = true;
+                for (int k = 0; k < edges->size(); k++) {
+                    if ((*edges)[k].targetStopId == shortcut.targetStopId) {
+                        if ((*edges)[k].ewgt > shortcut.ewgt) {
+                            (*edges)[k].ewgt = shortcut.ewgt;
+                        }
+                        addEdge = false;
+                        break;
+                    }
+                }
+
+                if (addEdge) {
+                    Edge edge;
+                    edge.targetStopId = shortcut.targetStopId;
+                    edge.ewgt = shortcut.ewgt;
+                    edges->push_back(edge);
+                }
+            }
+        }
+
+        for (int i = 0; i < independentSet.size(); i++) {
+            int vertexIndex = independentSet[i];
+            for (int j = 0; j < this->adjacencyList[vertexIndex].size(); j++) {
+                isOutdated[this->adjacencyList[vertexIndex][j].targetStopId] = 1;
+            }
+        }
+
+        uncontractedStopIds = remainingStopIds;
+        numberOfBatches++;
+    }
+
+    chGraph = CHGraph(this->vertices, this->adjacencyList);
+
+    auto end = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+    cout << "Contraction hierarchie created in " << duration.count() << "ms (" << numberOfBatches << " batches).\n" << endl;
+}
+
+/*
+    Creates the contraction hierarchie by contracting one vertex at a time.
+*/
+void Graph::createContractionHierarchieSerial() {
+    cout << "Creating contraction hierarchie..." << endl;
+    auto start = chrono::high_resolution_clock::now();
+
+    stopIdsSortedByLevel = vector<int>();
+
+    vector<int> edgeDifferences = vector<int>(this->vertices.size(), 0);
+
     priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
 
     #pragma omp parallel for
@@ -307,6 +536,8 @@ void Graph::createContractionHierarchie() {
         currentLevel++;
     }
 
+    chGraph = CHGraph(this->vertices, this->adjacencyList);
+
     auto end = chrono::high_resolution_clock::now();
     auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
     cout << "Contraction hierarchie created in " << duration.count() << "ms.\n" << endl;
@@ -432,80 +663,1236 @@ map<int, vector<int>> Graph::getDistancesWithPhast(vector<int> sourceStopIds) {
     auto start = chrono::high_resolution_clock::now();
     map<int, vector<int>> distances;
 
+    int numberOfVertices = this->vertices.size();
+
     for (int i = 0; i < sourceStopIds.size(); i++) {
-        int sourceStopId = sourceStopIds[i];
-        distances[sourceStopId] = vector<int>(this->vertices.size(), INT_MAX);
-        distances[sourceStopId][sourceStopId] = 0;
+        distances[sourceStopIds[i]] = vector<int>(numberOfVertices, INT_MAX);
     }
 
-    // perform upward searches from the source stops
     #pragma omp parallel for
     for (int i = 0; i < sourceStopIds.size(); i++) {
         int sourceStopId = sourceStopIds[i];
-        
+        vector<int> distancesPerLevel = vector<int>(numberOfVertices, INT_MAX);
+        distancesPerLevel[this->vertices[sourceStopId].level] = 0;
+
+        // perform an upward search from the source stop
         priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
-        pq.push(make_pair(0, sourceStopId));
+        pq.push(make_pair(0, this->vertices[sourceStopId].level));
 
         while(!pq.empty()) {
             int u = pq.top().second;
             pq.pop();
 
-            for (int j = 0; j < this->adjacencyList[u].size(); j++) {
-                int v = this->adjacencyList[u][j].targetStopId;
+            for (int j = chGraph.upwardEdgeOffsets[u]; j < chGraph.upwardEdgeOffsets[u + 1]; j++) {
+                int v = chGraph.upwardEdgeTargetLevels[j];
+                int weight = chGraph.upwardEdgeWeights[j];
 
-                if (this->vertices[v].level <= this->vertices[u].level) {
-                    continue;
+                if (distancesPerLevel[v] > distancesPerLevel[u] + weight) {
+                    distancesPerLevel[v] = distancesPerLevel[u] + weight;
+                    pq.push(make_pair(distancesPerLevel[v], v));
                 }
+            }
+        }
 
-                int weight = this->adjacencyList[u][j].ewgt;
+        // perform the downward scan from the highest level
+        for (int level = numberOfVertices - 2; level >= 0; level--) {
+            for (int j = chGraph.downwardEdgeOffsets[level]; j < chGraph.downwardEdgeOffsets[level + 1]; j++) {
+                int targetDistance = distancesPerLevel[chGraph.downwardEdgeTargetLevels[j]];
+
+                if (targetDistance == INT_MAX) {
+                    continue;
+                }
 
-                if (distances[sourceStopId][v] > distances[sourceStopId][u] + weight) {
-                    distances[sourceStopId][v] = distances[sourceStopId][u] + weight;
-                    pq.push(make_pair(distances[sourceStopId][v], v));
+                if (distancesPerLevel[level] > targetDistance + chGraph.downwardEdgeWeights[j]) {
+                    distancesPerLevel[level] = targetDistance + chGraph.downwardEdgeWeights[j];
                 }
             }
         }
+
+        vector<int>* distancesOfSource = &distances.at(sourceStopId);
+        for (int level = 0; level < numberOfVertices; level++) {
+            (*distancesOfSource)[chGraph.stopIdsSortedByLevel[level]] = (int) distancesPerLevel[level] * LOWER_BOUND_FACTOR;
+        }
     }
 
-    // perform downward scans from the highest level
-    for (int i = stopIdsSortedByLevel.size() - 2; i >= 0; i--) {
-        int vertexIndex = stopIdsSortedByLevel[i];
-        int level = this->vertices[vertexIndex].level;
+    auto end = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+    // cout << "Phast completed in " << duration.count() << "ms.\n" << endl;
 
-        for (int j = 0; j < this->adjacencyList[vertexIndex].size(); j++) {
-            int targetStopId = this->adjacencyList[vertexIndex][j].targetStopId;
+    return distances;
+}
 
-            if (this->vertices[targetStopId].level < level) {
-                continue;
-            }
+/*
+    Calculate the phast distances from several sources and return them as dense matrix. The distances are stored in blocks
+    of PHAST_SOURCE_BLOCK_SIZE sources in the order of the levels, so the downward scan reads the labels sequentially and
+    relaxes all sources of a block with simd instructions. The blocks are scanned in parallel.
+*/
+PhastDistances Graph::getDistanceMatrixWithPhast(vector<int> sourceStopIds) {
+    int numberOfVertices = this->vertices.size();
+    int numberOfSourceStopIds = sourceStopIds.size();
+    int numberOfBlocks = (numberOfSourceStopIds + PHAST_SOURCE_BLOCK_SIZE - 1) / PHAST_SOURCE_BLOCK_SIZE;
+    int blockSize = numberOfVertices * PHAST_SOURCE_BLOCK_SIZE;
+
+    // unreachable vertices keep a distance that can't overflow when an edge weight is added
+    vector<int> distancesPerLevel = vector<int>(numberOfBlocks * blockSize, PHAST_INFINITY);
 
-            int weight = this->adjacencyList[vertexIndex][j].ewgt;
+    // perform upward searches from the source stops
+    #pragma omp parallel for
+    for (int i = 0; i < numberOfSourceStopIds; i++) {
+        int* distances = &distancesPerLevel[(i / PHAST_SOURCE_BLOCK_SIZE) * blockSize + i % PHAST_SOURCE_BLOCK_SIZE];
+        int sourceLevel = this->vertices[sourceStopIds[i]].level;
+        distances[sourceLevel * PHAST_SOURCE_BLOCK_SIZE] = 0;
 
-            for (int k = 0; k < sourceStopIds.size(); k++) {
-                int sourceStopId = sourceStopIds[k];
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+        pq.push(make_pair(0, sourceLevel));
 
-                if (distances[sourceStopId][targetStopId] == INT_MAX) {
-                    continue;
+        while(!pq.empty()) {
+            int u = pq.top().second;
+            pq.pop();
+
+            int distanceU = distances[u * PHAST_SOURCE_BLOCK_SIZE];
+
+            for (int j = chGraph.upwardEdgeOffsets[u]; j < chGraph.upwardEdgeOffsets[u + 1]; j++) {
+                int v = chGraph.upwardEdgeTargetLevels[j];
+                int weight = chGraph.upwardEdgeWeights[j];
+                int* distanceV = &distances[v * PHAST_SOURCE_BLOCK_SIZE];
+
+                if (*distanceV > distanceU + weight) {
+                    *distanceV = distanceU + weight;
+                    pq.push(make_pair(*distanceV, v));
                 }
+            }
+        }
+    }
+
+    // perform downward scans from the highest level
+    #pragma omp parallel for
+    for (int block = 0; block < numberOfBlocks; block++) {
+        int* distances = &distancesPerLevel[block * blockSize];
 
-                if (distances[sourceStopId][vertexIndex] > distances[sourceStopId][targetStopId] + weight) {
-                    distances[sourceStopId][vertexIndex] = distances[sourceStopId][targetStopId] + weight;
+        for (int level = numberOfVertices - 1; level >= 0; level--) {
+            int* vertexDistances = distances + level * PHAST_SOURCE_BLOCK_SIZE;
+
+            for (int j = chGraph.downwardEdgeOffsets[level]; j < chGraph.downwardEdgeOffsets[level + 1]; j++) {
+                int* targetDistances = distances + chGraph.downwardEdgeTargetLevels[j] * PHAST_SOURCE_BLOCK_SIZE;
+                int weight = chGraph.downwardEdgeWeights[j];
+
+                #pragma omp simd
+                for (int k = 0; k < PHAST_SOURCE_BLOCK_SIZE; k++) {
+                    vertexDistances[k] = min(vertexDistances[k], targetDistances[k] + weight);
                 }
             }
         }
     }
 
+    PhastDistances phastDistances;
+    phastDistances.numberOfSourceStopIds = numberOfSourceStopIds;
+    phastDistances.distances = vector<int>(numberOfVertices * numberOfSourceStopIds);
+
     #pragma omp parallel for
-    for (int i = 0; i < sourceStopIds.size(); i++) {
-        int sourceStopId = sourceStopIds[i];
-        for (int j = 0; j < distances[sourceStopId].size(); j++) {
-            distances[sourceStopId][j] = (int) distances[sourceStopId][j] * LOWER_BOUND_FACTOR;
+    for (int vertexIndex = 0; vertexIndex < numberOfVertices; vertexIndex++) {
+        int levelOffset = this->vertices[vertexIndex].level * PHAST_SOURCE_BLOCK_SIZE;
+        for (int i = 0; i < numberOfSourceStopIds; i++) {
+            int distance = distancesPerLevel[(i / PHAST_SOURCE_BLOCK_SIZE) * blockSize + levelOffset + i % PHAST_SOURCE_BLOCK_SIZE];
+            if (distance >= PHAST_INFINITY) {
+                distance = INT_MAX;
+            } else {
+                distance = distance * LOWER_BOUND_FACTOR;
+            }
+            phastDistances.distances[vertexIndex * numberOfSourceStopIds + i] = distance;
         }
     }
 
-    auto end = chrono::high_resolution_clock::now();
-    auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
-    // cout << "Phast completed in " << duration.count() << "ms.\n" << endl;
+    return phastDistances;
+}
+
+/*
+    Calculate the distance between two stops with a bidirectional upward search in the contraction hierarchie.
+*/
+int Graph::getDistanceWithCH(int sourceStopId, int targetStopId) {
+    return chGraph.getDistance(this->vertices[sourceStopId].level, this->vertices[targetStopId].level);
+}
+
+/*
+    Create the buckets of a many-to-many query for the given targets. The buckets can be used for several sources.
+*/
+CHBuckets Graph::createBucketsWithCH(vector<int> targetStopIds) {
+    vector<int> targetLevels = vector<int>(targetStopIds.size());
+    for (int i = 0; i < targetStopIds.size(); i++) {
+        targetLevels[i] = this->vertices[targetStopIds[i]].level;
+    }
+    return chGraph.createBuckets(targetLevels);
+}
 
+/*
+    Calculate the lower bounds from a source to all targets of the buckets. Only the upward search space of the source is visited.
+*/
+vector<int> Graph::getDistancesToTargetsWithCH(int sourceStopId, CHBuckets &buckets) {
+    vector<int> distances = chGraph.getDistancesToTargets(this->vertices[sourceStopId].level, buckets);
+    for (int i = 0; i < distances.size(); i++) {
+        distances[i] = (int) distances[i] * LOWER_BOUND_FACTOR;
+    }
     return distances;
+}
+
+vector<int> Graph::getStopIdsSortedByLevel() {
+    return stopIdsSortedByLevel;
+}
+
+void Graph::exportGraphWithCHBinary(DataType dataType) {
+    cout << "Exporting graph with CH as binary file..." << endl;
+    string dataTypeString = Importer::getDataTypeString(dataType);
+    string folderPath = FOLDER_PREFIX + "graphs/" + dataTypeString + "/";
+    string fileName = folderPath + "graph-withCH";
+    if (USE_FOOTPATHS) {
+        fileName += "-with-footpaths";
+    }
+    fileName += ".bin";
+
+    // the file stores the external stop ids
+    vector<int> stopIdsSortedByLevel = chGraph.stopIdsSortedByLevel;
+    for (int level = 0; level < chGraph.stopIdsSortedByLevel.size(); level++) {
+        chGraph.stopIdsSortedByLevel[level] = Importer::getExternalStopId(stopIdsSortedByLevel[level]);
+    }
+    chGraph.exportBinary(fileName);
+    chGraph.stopIdsSortedByLevel = stopIdsSortedByLevel;
+    cout << "Graph with CH exported.\n" << endl;
+}
+
+/*
+    Import the contraction hierarchie from the binary file and restore the vertices and the adjacency list from its upward and
+    downward edges. Returns false if the file doesn't exist.
+*/
+bool Graph::importGraphWithCHBinary(DataType dataType) {
+    string dataTypeString = Importer::getDataTypeString(dataType);
+    string folderPath = FOLDER_PREFIX + "graphs/" + dataTypeString + "/";
+    string fileName = folderPath + "graph-withCH";
+    if (USE_FOOTPATHS) {
+        fileName += "-with-footpaths";
+    }
+    fileName += ".bin";
+
+    if (!chGraph.importBinary(fileName)) {
+        return false;
+    }
+
+    cout << "Importing graph with CH from binary file..." << endl;
+
+    int numberOfVertices = chGraph.stopIdsSortedByLevel.size();
+    for (int level = 0; level < numberOfVertices; level++) {
+        chGraph.stopIdsSortedByLevel[level] = Importer::getInternalStopId(chGraph.stopIdsSortedByLevel[level]);
+    }
+    this->vertices = vector<Vertex>(numberOfVertices);
+    this->adjacencyList = vector<vector<Edge>>(numberOfVertices);
+    this->stopIdsSortedByLevel = chGraph.stopIdsSortedByLevel;
+
+    for (int level = 0; level < numberOfVertices; level++) {
+        int stopId = chGraph.stopIdsSortedByLevel[level];
+
+        for (int j = chGraph.upwardEdgeOffsets[level]; j < chGraph.upwardEdgeOffsets[level + 1]; j++) {
+            Edge edge;
+            edge.targetStopId = chGraph.stopIdsSortedByLevel[chGraph.upwardEdgeTargetLevels[j]];
+            edge.ewgt = chGraph.upwardEdgeWeights[j];
+            this->adjacencyList[stopId].push_back(edge);
+        }
+
+        // the downward edges of a level are the edges from higher levels to it
+        for (int j = chGraph.downwardEdgeOffsets[level]; j < chGraph.downwardEdgeOffsets[level + 1]; j++) {
+            Edge edge;
+            edge.targetStopId = stopId;
+            edge.ewgt = chGraph.downwardEdgeWeights[j];
+            this->adjacencyList[chGraph.stopIdsSortedByLevel[chGraph.downwardEdgeTargetLevels[j]]].push_back(edge);
+        }
+    }
+
+    for (int level = 0; level < numberOfVertices; level++) {
+        int stopId = chGraph.stopIdsSortedByLevel[level];
+
+        Vertex vertex;
+        vertex.stopId = stopId;
+        vertex.vwgt = 1;
+        vertex.cewgt = 0;
+        vertex.adjwgt = 0;
+        vertex.level = level;
+        vertex.nedges = this->adjacencyList[stopId].size();
+
+        for (int j = 0; j < this->adjacencyList[stopId].size(); j++) {
+            vertex.adjwgt += this->adjacencyList[stopId][j].ewgt;
+        }
+
+        this->vertices[stopId] = vertex;
+    }
+
+    cout << "Graph with CH imported.\n" << endl;
+    return true;
+}
+
+/*
+    Create the upward and downward edges of the contraction hierarchie. Each edge is stored once, at its lower vertex.
+*/
+CHGraph::CHGraph(vector<Vertex> &vertices, vector<vector<Edge>> &adjacencyList) {
+    int numberOfVertices = vertices.size();
+    stopIdsSortedByLevel = vector<int>(numberOfVertices);
+    for (int i = 0; i < numberOfVertices; i++) {
+        stopIdsSortedByLevel[vertices[i].level] = i;
+    }
+
+    upwardEdgeOffsets = vector<int>(numberOfVertices + 1, 0);
+    downwardEdgeOffsets = vector<int>(numberOfVertices + 1, 0);
+
+    // count the edges per level
+    for (int i = 0; i < numberOfVertices; i++) {
+        int level = vertices[i].level;
+        for (int j = 0; j < adjacencyList[i].size(); j++) {
+            int targetLevel = vertices[adjacencyList[i][j].targetStopId].level;
+            if (targetLevel > level) {
+                upwardEdgeOffsets[level + 1]++;
+            } else if (targetLevel < level) {
+                downwardEdgeOffsets[targetLevel + 1]++;
+            }
+        }
+    }
+
+    for (int level = 0; level < numberOfVertices; level++) {
+        upwardEdgeOffsets[level + 1] += upwardEdgeOffsets[level];
+        downwardEdgeOffsets[level + 1] += downwardEdgeOffsets[level];
+    }
+
+    upwardEdgeTargetLevels = vector<int>(upwardEdgeOffsets[numberOfVertices]);
+    upwardEdgeWeights = vector<int>(upwardEdgeOffsets[numberOfVertices]);
+    downwardEdgeTargetLevels = vector<int>(downwardEdgeOffsets[numberOfVertices]);
+    downwardEdgeWeights = vector<int>(downwardEdgeOffsets[numberOfVertices]);
+
+    vector<int> upwardEdgeCounters = vector<int>(upwardEdgeOffsets.begin(), upwardEdgeOffsets.end() - 1);
+    vector<int> downwardEdgeCounters = vector<int>(downwardEdgeOffsets.begin(), downwardEdgeOffsets.end() - 1);
+
+    for (int level = 0; level < numberOfVertices; level++) {
+        int stopId = stopIdsSortedByLevel[level];
+        for (int j = 0; j < adjacencyList[stopId].size(); j++) {
+            int targetLevel = vertices[adjacencyList[stopId][j].targetStopId].level;
+            int weight = adjacencyList[stopId][j].ewgt;
+            if (targetLevel > level) {
+                upwardEdgeTargetLevels[upwardEdgeCounters[level]] = targetLevel;
+                upwardEdgeWeights[upwardEdgeCounters[level]] = weight;
+                upwardEdgeCounters[level]++;
+            } else if (targetLevel < level) {
+                downwardEdgeTargetLevels[downwardEdgeCounters[targetLevel]] = level;
+                downwardEdgeWeights[downwardEdgeCounters[targetLevel]] = weight;
+                downwardEdgeCounters[targetLevel]++;
+            }
+        }
+    }
+}
+
+/*
+    Calculate the distance between two levels with a bidirectional search. The forward search uses the upward edges, the backward
+    search the downward edges in reverse direction. Both searches stop when their smallest key exceeds the best distance.
+*/
+int CHGraph::getDistance(int sourceLevel, int targetLevel) {
+    int numberOfVertices = stopIdsSortedByLevel.size();
+    vector<int> forwardDistances = vector<int>(numberOfVertices, INT_MAX);
+    vector<int> backwardDistances = vector<int>(numberOfVertices, INT_MAX);
+
+    forwardDistances[sourceLevel] = 0;
+    backwardDistances[targetLevel] = 0;
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> forwardPq;
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> backwardPq;
+    forwardPq.push(make_pair(0, sourceLevel));
+    backwardPq.push(make_pair(0, targetLevel));
+
+    int bestDistance = INT_MAX;
+    if (sourceLevel == targetLevel) {
+        bestDistance = 0;
+    }
+
+    while (!forwardPq.empty() || !backwardPq.empty()) {
+        bool forward = backwardPq.empty() || (!forwardPq.empty() && forwardPq.top().first <= backwardPq.top().first);
+
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>>* pq = forward ? &forwardPq : &backwardPq;
+        vector<int>* distances = forward ? &forwardDistances : &backwardDistances;
+        vector<int>* otherDistances = forward ? &backwardDistances : &forwardDistances;
+        vector<int>* edgeOffsets = forward ? &upwardEdgeOffsets : &downwardEdgeOffsets;
+        vector<int>* edgeTargetLevels = forward ? &upwardEdgeTargetLevels : &downwardEdgeTargetLevels;
+        vector<int>* edgeWeights = forward ? &upwardEdgeWeights : &downwardEdgeWeights;
+
+        int distance = pq->top().first;
+        int u = pq->top().second;
+        pq->pop();
+
+        if (distance >= bestDistance) {
+            // the other search can't improve the result with keys that are at least as large
+            *pq = priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>>();
+            continue;
+        }
+
+        if (distance > (*distances)[u]) {
+            continue;
+        }
+
+        for (int j = (*edgeOffsets)[u]; j < (*edgeOffsets)[u + 1]; j++) {
+            int v = (*edgeTargetLevels)[j];
+            int newDistance = distance + (*edgeWeights)[j];
+
+            if (newDistance < (*distances)[v]) {
+                (*distances)[v] = newDistance;
+                pq->push(make_pair(newDistance, v));
+
+                if ((*otherDistances)[v] != INT_MAX && newDistance + (*otherDistances)[v] < bestDistance) {
+                    bestDistance = newDistance + (*otherDistances)[v];
+                }
+            }
+        }
+    }
+
+    return bestDistance;
+}
+
+/*
+    Run the backward searches of all targets and store the reached levels in the buckets.
+*/
+CHBuckets CHGraph::createBuckets(vector<int> targetLevels) {
+    vector<vector<pair<int, int>>> searchSpaces = vector<vector<pair<int, int>>>(targetLevels.size());
+
+    #pragma omp parallel for
+    for (int i = 0; i < targetLevels.size(); i++) {
+        searchSpaces[i] = getUpwardSearchSpace(targetLevels[i], false);
+    }
+
+    CHBuckets buckets;
+    buckets.numberOfTargets = targetLevels.size();
+    buckets.entries = vector<BucketEntry>();
+
+    for (int i = 0; i < searchSpaces.size(); i++) {
+        for (int j = 0; j < searchSpaces[i].size(); j++) {
+            BucketEntry entry;
+            entry.level = searchSpaces[i][j].first;
+            entry.targetIndex = i;
+            entry.distance = searchSpaces[i][j].second;
+            buckets.entries.push_back(entry);
+        }
+    }
+
+    sort(buckets.entries.begin(), buckets.entries.end(), [](const BucketEntry &left, const BucketEntry &right) {
+        return left.level < right.level;
+    });
+
+    return buckets;
+}
+
+/*
+    Run the forward search of the source and combine every reached level with the entries of its bucket.
+*/
+vector<int> CHGraph::getDistancesToTargets(int sourceLevel, CHBuckets &buckets) {
+    vector<int> distances = vector<int>(buckets.numberOfTargets, INT_MAX);
+    vector<pair<int, int>> searchSpace = getUpwardSearchSpace(sourceLevel, true);
+
+    for (int i = 0; i < searchSpace.size(); i++) {
+        int level = searchSpace[i].first;
+        int distance = searchSpace[i].second;
+
+        BucketEntry searchEntry;
+        searchEntry.level = level;
+        auto it = lower_bound(buckets.entries.begin(), buckets.entries.end(), searchEntry, [](const BucketEntry &left, const BucketEntry &right) {
+            return left.level < right.level;
+        });
+
+        for (; it != buckets.entries.end() && it->level == level; it++) {
+            if (distance + it->distance < distances[it->targetIndex]) {
+                distances[it->targetIndex] = distance + it->distance;
+            }
+        }
+    }
+
+    return distances;
+}
+
+/*
+    Returns all levels that are settled by an upward search with their distances. The forward search uses the upward edges,
+    the backward search the downward edges. Only the visited vertices are stored, so the search doesn't touch the whole graph.
+*/
+vector<pair<int, int>> CHGraph::getUpwardSearchSpace(int level, bool forward) {
+    vector<int>* edgeOffsets = forward ? &upwardEdgeOffsets : &downwardEdgeOffsets;
+    vector<int>* edgeTargetLevels = forward ? &upwardEdgeTargetLevels : &downwardEdgeTargetLevels;
+    vector<int>* edgeWeights = forward ? &upwardEdgeWeights : &downwardEdgeWeights;
+
+    vector<pair<int, int>> searchSpace = vector<pair<int, int>>();
+    unordered_map<int, int> distances;
+    distances[level] = 0;
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    pq.push(make_pair(0, level));
+
+    while (!pq.empty()) {
+        int distance = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+
+        if (distance > distances[u]) {
+            continue;
+        }
+
+        searchSpace.push_back(make_pair(u, distance));
+
+        for (int j = (*edgeOffsets)[u]; j < (*edgeOffsets)[u + 1]; j++) {
+            int v = (*edgeTargetLevels)[j];
+            int newDistance = distance + (*edgeWeights)[j];
+
+            auto it = distances.find(v);
+            if (it == distances.end() || newDistance < it->second) {
+                distances[v] = newDistance;
+                pq.push(make_pair(newDistance, v));
+            }
+        }
+    }
+
+    return searchSpace;
+}
+
+/*
+    Write the contraction hierarchie to a binary file. The file starts with the number of vertices and the numbers of upward and
+    downward edges followed by the arrays as 32 bit integers.
+*/
+void CHGraph::exportBinary(string fileName) {
+    remove(fileName.c_str());
+
+    ofstream file;
+    file.open(fileName, ios::binary);
+
+    if (!file.is_open()) {
+        cout << "Could not open file " << fileName << endl;
+        return;
+    }
+
+    int header[3] = {(int) stopIdsSortedByLevel.size(), (int) upwardEdgeTargetLevels.size(), (int) downwardEdgeTargetLevels.size()};
+    file.write((char*) header, sizeof(header));
+
+    vector<vector<int>*> arrays = {&stopIdsSortedByLevel, &upwardEdgeOffsets, &upwardEdgeTargetLevels, &upwardEdgeWeights,
+        &downwardEdgeOffsets, &downwardEdgeTargetLevels, &downwardEdgeWeights};
+    for (int i = 0; i < arrays.size(); i++) {
+        file.write((char*) arrays[i]->data(), arrays[i]->size() * sizeof(int));
+    }
+
+    file.close();
+}
+
+bool CHGraph::importBinary(string fileName) {
+    ifstream file;
+    file.open(fileName, ios::binary);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    int header[3];
+    file.read((char*) header, sizeof(header));
+
+    stopIdsSortedByLevel = vector<int>(header[0]);
+    upwardEdgeOffsets = vector<int>(header[0] + 1);
+    upwardEdgeTargetLevels = vector<int>(header[1]);
+    upwardEdgeWeights = vector<int>(header[1]);
+    downwardEdgeOffsets = vector<int>(header[0] + 1);
+    downwardEdgeTargetLevels = vector<int>(header[2]);
+    downwardEdgeWeights = vector<int>(header[2]);
+
+    vector<vector<int>*> arrays = {&stopIdsSortedByLevel, &upwardEdgeOffsets, &upwardEdgeTargetLevels, &upwardEdgeWeights,
+        &downwardEdgeOffsets, &downwardEdgeTargetLevels, &downwardEdgeWeights};
+    for (int i = 0; i < arrays.size(); i++) {
+        file.read((char*) arrays[i]->data(), arrays[i]->size() * sizeof(int));
+    }
+
+    if (!file) {
+        cout << "Could not read file " << fileName << endl;
+        file.close();
+        return false;
+    }
+
+    file.close();
+    return true;
+}
+/*
+    Returns the earliest arrival time when departing at the given time. The departure time can be outside of the first week.
+*/
+int TravelTimeFunction::evaluate(int departureTime) {
+    int arrivalTime = evaluatePoints(departureTime);
+    if (walkingDuration != INT_MAX && departureTime + walkingDuration < arrivalTime) {
+        arrivalTime = departureTime + walkingDuration;
+    }
+    return arrivalTime;
+}
+
+int TravelTimeFunction::evaluatePoints(int departureTime) {
+    if (points.empty()) {
+        return INT_MAX;
+    }
+
+    int weekOffset = (departureTime / SECONDS_PER_WEEK) * SECONDS_PER_WEEK;
+    if (departureTime < 0 && departureTime % SECONDS_PER_WEEK != 0) {
+        weekOffset -= SECONDS_PER_WEEK;
+    }
+
+    auto it = lower_bound(points.begin(), points.end(), make_pair(departureTime - weekOffset, INT_MIN));
+    if (it == points.end()) {
+        return points[0].second + weekOffset + SECONDS_PER_WEEK;
+    }
+    return it->second + weekOffset;
+}
+
+/*
+    Moves the departure times into the first week and removes the points that are dominated by a later departure, by walking or
+    by the first departures of the next week. Afterwards the minimum and maximum duration are updated.
+*/
+void TravelTimeFunction::reduce() {
+    for (int i = 0; i < points.size(); i++) {
+        while (points[i].first < 0) {
+            points[i].first += SECONDS_PER_WEEK;
+            points[i].second += SECONDS_PER_WEEK;
+        }
+        while (points[i].first >= SECONDS_PER_WEEK) {
+            points[i].first -= SECONDS_PER_WEEK;
+            points[i].second -= SECONDS_PER_WEEK;
+        }
+    }
+
+    // for equal departure times the point with the earliest arrival is visited first by the backward scan
+    sort(points.begin(), points.end(), [](const pair<int, int> &left, const pair<int, int> &right) {
+        return left.first < right.first || (left.first == right.first && left.second > right.second);
+    });
+
+    int minimumArrivalTime = INT_MAX;
+    for (int i = 0; i < points.size(); i++) {
+        minimumArrivalTime = min(minimumArrivalTime, points[i].second);
+    }
+
+    vector<pair<int, int>> reducedPoints = vector<pair<int, int>>();
+    int earliestLaterArrivalTime = minimumArrivalTime == INT_MAX ? INT_MAX : minimumArrivalTime + SECONDS_PER_WEEK;
+    for (int i = points.size() - 1; i >= 0; i--) {
+        if (points[i].second >= earliestLaterArrivalTime) {
+            continue;
+        }
+        if (walkingDuration != INT_MAX && points[i].first + walkingDuration <= points[i].second) {
+            continue;
+        }
+        reducedPoints.push_back(points[i]);
+        earliestLaterArrivalTime = points[i].second;
+    }
+    reverse(reducedPoints.begin(), reducedPoints.end());
+    points = reducedPoints;
+
+    minimumDuration = walkingDuration;
+    maximumDuration = walkingDuration;
+
+    if (!points.empty()) {
+        int maximumDurationOfPoints = points[0].second + SECONDS_PER_WEEK - points[points.size() - 1].first;
+        for (int i = 0; i < points.size(); i++) {
+            minimumDuration = min(minimumDuration, points[i].second - points[i].first);
+            if (i > 0) {
+                maximumDurationOfPoints = max(maximumDurationOfPoints, points[i].second - points[i - 1].first);
+            }
+        }
+        maximumDuration = min(maximumDuration, maximumDurationOfPoints);
+    }
+}
+
+/*
+    Returns the function of the path that uses the edge of the first function and then the edge of the second function.
+*/
+TravelTimeFunction TravelTimeFunction::link(TravelTimeFunction &first, TravelTimeFunction &second) {
+    TravelTimeFunction linkedFunction;
+
+    if (first.walkingDuration != INT_MAX && second.walkingDuration != INT_MAX) {
+        linkedFunction.walkingDuration = first.walkingDuration + second.walkingDuration;
+    }
+
+    // walk first and take a connection of the second edge afterwards
+    if (first.walkingDuration != INT_MAX) {
+        for (int i = 0; i < second.points.size(); i++) {
+            linkedFunction.points.push_back(make_pair(second.points[i].first - first.walkingDuration, second.points[i].second));
+        }
+    }
+
+    for (int i = 0; i < first.points.size(); i++) {
+        // take a connection of the first edge and walk afterwards
+        if (second.walkingDuration != INT_MAX) {
+            linkedFunction.points.push_back(make_pair(first.points[i].first, first.points[i].second + second.walkingDuration));
+        }
+
+        // take connections of both edges
+        if (!second.points.empty()) {
+            linkedFunction.points.push_back(make_pair(first.points[i].first, second.evaluatePoints(first.points[i].second)));
+        }
+    }
+
+    linkedFunction.reduce();
+    return linkedFunction;
+}
+
+/*
+    Returns the minimum of both functions.
+*/
+TravelTimeFunction TravelTimeFunction::merge(TravelTimeFunction &first, TravelTimeFunction &second) {
+    TravelTimeFunction mergedFunction;
+    mergedFunction.walkingDuration = min(first.walkingDuration, second.walkingDuration);
+    mergedFunction.points = first.points;
+    mergedFunction.points.insert(mergedFunction.points.end(), second.points.begin(), second.points.end());
+    mergedFunction.reduce();
+    return mergedFunction;
+}
+
+bool TimeDependentGraph::isCreated() {
+    return !levels.empty();
+}
+
+/*
+    Create the edges of the station graph. The connections of a trip are available on the weekdays of the trip, like in raptor
+    a connection that departs before the first departure of its trip belongs to the trip of the previous day.
+*/
+void TimeDependentGraph::createEdges(vector<map<int, TravelTimeFunction>> &outEdges) {
+    for (int i = 0; i < Importer::connections.size(); i++) {
+        Connection connection = Importer::connections[i];
+
+        int arrivalTime = connection.arrivalTime;
+        if (arrivalTime < connection.departureTime) {
+            arrivalTime += SECONDS_PER_DAY;
+        }
+
+        int firstDepartureTimeOfTrip = Importer::stopTimes[Importer::indexOfFirstStopTimeOfATrip[connection.tripId]].departureTime;
+        int dayShift = firstDepartureTimeOfTrip > connection.departureTime ? 1 : 0;
+
+        TravelTimeFunction* travelTimeFunction = &outEdges[2 * connection.departureStopId + 1][2 * connection.arrivalStopId];
+        for (int weekday = 0; weekday < 7; weekday++) {
+            if (!Importer::isTripAvailable(connection.tripId, (weekday + 7 - dayShift) % 7)) {
+                continue;
+            }
+            int dayOffset = weekday * SECONDS_PER_DAY;
+            travelTimeFunction->points.push_back(make_pair(connection.departureTime + dayOffset, arrivalTime + dayOffset));
+        }
+    }
+
+    for (int i = 0; i < Importer::footPaths.size(); i++) {
+        FootPath footPath = Importer::footPaths[i];
+        TravelTimeFunction* travelTimeFunction = &outEdges[2 * footPath.departureStopId][2 * footPath.arrivalStopId + 1];
+        travelTimeFunction->walkingDuration = min(travelTimeFunction->walkingDuration, footPath.duration);
+    }
+
+    for (int i = 0; i < outEdges.size(); i++) {
+        for (auto it = outEdges[i].begin(); it != outEdges[i].end(); it++) {
+            it->second.reduce();
+        }
+    }
+}
+
+/*
+    Create the time dependent contraction hierarchie. The vertices are contracted in the order of their edge difference until only
+    the core is left. A shortcut is skipped if a witness path avoiding the contracted vertex is never slower, which is checked with
+    the maximum durations of the witness path and the minimum duration of the shortcut.
+*/
+void TimeDependentGraph::createContractionHierarchie() {
+    cout << "Creating time dependent contraction hierarchie..." << endl;
+    auto start = chrono::high_resolution_clock::now();
+
+    int numberOfVertices = 2 * Importer::stops.size();
+
+    vector<map<int, TravelTimeFunction>> outEdges = vector<map<int, TravelTimeFunction>>(numberOfVertices);
+    createEdges(outEdges);
+
+    vector<set<int>> inNeighbors = vector<set<int>>(numberOfVertices);
+    for (int i = 0; i < numberOfVertices; i++) {
+        for (auto it = outEdges[i].begin(); it != outEdges[i].end(); it++) {
+            inNeighbors[it->first].insert(i);
+        }
+    }
+
+    // the edges of contracted vertices, stored as (source, target, function)
+    vector<int> finalEdgeSources = vector<int>();
+    vector<int> finalEdgeTargets = vector<int>();
+    vector<TravelTimeFunction> finalEdgeFunctions = vector<TravelTimeFunction>();
+
+    levels = vector<int>(numberOfVertices, -1);
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    for (int i = 0; i < numberOfVertices; i++) {
+        int numberOfInEdges = inNeighbors[i].size();
+        int numberOfOutEdges = outEdges[i].size();
+        pq.push(make_pair(numberOfInEdges * numberOfOutEdges - numberOfInEdges - numberOfOutEdges, i));
+    }
+
+    int numberOfCoreVertices = max(1, (int) (numberOfVertices * TDCH_CORE_FRACTION));
+    int currentLevel = 0;
+
+    while (numberOfVertices - currentLevel > numberOfCoreVertices && !pq.empty()) {
+        int edgeDifference = pq.top().first;
+        int vertex = pq.top().second;
+        pq.pop();
+
+        int numberOfInEdges = inNeighbors[vertex].size();
+        int numberOfOutEdges = outEdges[vertex].size();
+        int updatedEdgeDifference = numberOfInEdges * numberOfOutEdges - numberOfInEdges - numberOfOutEdges;
+        if (updatedEdgeDifference > edgeDifference) {
+            pq.push(make_pair(updatedEdgeDifference, vertex));
+            continue;
+        }
+
+        set<int> targetVertices = set<int>();
+        for (auto it = outEdges[vertex].begin(); it != outEdges[vertex].end(); it++) {
+            targetVertices.insert(it->first);
+        }
+
+        // add the shortcuts between all in and out neighbors
+        for (int sourceVertex : inNeighbors[vertex]) {
+            if (sourceVertex == vertex) {
+                continue;
+            }
+
+            vector<int> witnessDistances = getWitnessDistances(outEdges, sourceVertex, vertex, targetVertices);
+            TravelTimeFunction* firstFunction = &outEdges[sourceVertex][vertex];
+
+            int j = 0;
+            for (auto it = outEdges[vertex].begin(); it != outEdges[vertex].end(); it++, j++) {
+                int targetVertex = it->first;
+                if (targetVertex == sourceVertex || targetVertex == vertex) {
+                    continue;
+                }
+
+                TravelTimeFunction shortcut = TravelTimeFunction::link(*firstFunction, it->second);
+                if (shortcut.minimumDuration == INT_MAX || witnessDistances[j] <= shortcut.minimumDuration) {
+                    continue;
+                }
+
+                auto existingEdge = outEdges[sourceVertex].find(targetVertex);
+                if (existingEdge == outEdges[sourceVertex].end()) {
+                    outEdges[sourceVertex][targetVertex] = shortcut;
+                    inNeighbors[targetVertex].insert(sourceVertex);
+                } else {
+                    existingEdge->second = TravelTimeFunction::merge(existingEdge->second, shortcut);
+                }
+            }
+        }
+
+        // move the edges of the vertex into the hierarchie and remove them from the remaining graph
+        for (auto it = outEdges[vertex].begin(); it != outEdges[vertex].end(); it++) {
+            if (it->first == vertex) {
+                continue;
+            }
+            finalEdgeSources.push_back(vertex);
+            finalEdgeTargets.push_back(it->first);
+            finalEdgeFunctions.push_back(it->second);
+            inNeighbors[it->first].erase(vertex);
+        }
+        for (int sourceVertex : inNeighbors[vertex]) {
+            if (sourceVertex == vertex) {
+                continue;
+            }
+            finalEdgeSources.push_back(sourceVertex);
+            finalEdgeTargets.push_back(vertex);
+            finalEdgeFunctions.push_back(outEdges[sourceVertex][vertex]);
+            outEdges[sourceVertex].erase(vertex);
+        }
+        outEdges[vertex].clear();
+        inNeighbors[vertex].clear();
+
+        levels[vertex] = currentLevel;
+        currentLevel++;
+    }
+
+    // the remaining vertices form the core
+    for (int i = 0; i < numberOfVertices; i++) {
+        if (levels[i] != -1) {
+            continue;
+        }
+        levels[i] = currentLevel;
+        for (auto it = outEdges[i].begin(); it != outEdges[i].end(); it++) {
+            finalEdgeSources.push_back(i);
+            finalEdgeTargets.push_back(it->first);
+            finalEdgeFunctions.push_back(it->second);
+        }
+    }
+
+    // store the edges by their source and the downward edges by their target
+    edgeOffsets = vector<int>(numberOfVertices + 1, 0);
+    downwardInEdgeOffsets = vector<int>(numberOfVertices + 1, 0);
+    for (int i = 0; i < finalEdgeSources.size(); i++) {
+        edgeOffsets[finalEdgeSources[i] + 1]++;
+        if (levels[finalEdgeSources[i]] > levels[finalEdgeTargets[i]]) {
+            downwardInEdgeOffsets[finalEdgeTargets[i] + 1]++;
+        }
+    }
+    for (int i = 0; i < numberOfVertices; i++) {
+        edgeOffsets[i + 1] += edgeOffsets[i];
+        downwardInEdgeOffsets[i + 1] += downwardInEdgeOffsets[i];
+    }
+
+    edgeTargets = vector<int>(finalEdgeSources.size());
+    edgeFunctions = vector<TravelTimeFunction>(finalEdgeSources.size());
+    downwardInEdgeSources = vector<int>(downwardInEdgeOffsets[numberOfVertices]);
+
+    vector<int> edgeCounters = vector<int>(edgeOffsets.begin(), edgeOffsets.end() - 1);
+    vector<int> downwardInEdgeCounters = vector<int>(downwardInEdgeOffsets.begin(), downwardInEdgeOffsets.end() - 1);
+    for (int i = 0; i < finalEdgeSources.size(); i++) {
+        int source = finalEdgeSources[i];
+        int target = finalEdgeTargets[i];
+        edgeTargets[edgeCounters[source]] = target;
+        edgeFunctions[edgeCounters[source]] = move(finalEdgeFunctions[i]);
+        edgeCounters[source]++;
+
+        if (levels[source] > levels[target]) {
+            downwardInEdgeSources[downwardInEdgeCounters[target]] = source;
+            downwardInEdgeCounters[target]++;
+        }
+    }
+
+    auto end = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+    cout << "Time dependent contraction hierarchie created in " << duration.count() << "ms (" << edgeTargets.size() << " edges, " << numberOfVertices - currentLevel << " core vertices).\n" << endl;
+}
+
+/*
+    Calculate upper bounds of the distances from the source vertex to the target vertices without using the excluded vertex.
+    The search uses the maximum durations of the edges and settles at most TDCH_WITNESS_SEARCH_LIMIT vertices.
+*/
+vector<int> TimeDependentGraph::getWitnessDistances(vector<map<int, TravelTimeFunction>> &outEdges, int sourceVertex, int excludeVertex, set<int> &targetVertices) {
+    unordered_map<int, int> distances;
+    distances[sourceVertex] = 0;
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    pq.push(make_pair(0, sourceVertex));
+
+    int numberOfSettledVertices = 0;
+    while (!pq.empty() && numberOfSettledVertices < TDCH_WITNESS_SEARCH_LIMIT) {
+        int distance = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+
+        if (distance > distances[u]) {
+            continue;
+        }
+        numberOfSettledVertices++;
+
+        for (auto it = outEdges[u].begin(); it != outEdges[u].end(); it++) {
+            int v = it->first;
+            if (v == excludeVertex || it->second.maximumDuration == INT_MAX) {
+                continue;
+            }
+
+            int newDistance = distance + it->second.maximumDuration;
+            auto distanceV = distances.find(v);
+            if (distanceV == distances.end() || newDistance < distanceV->second) {
+                distances[v] = newDistance;
+                pq.push(make_pair(newDistance, v));
+            }
+        }
+    }
+
+    vector<int> witnessDistances = vector<int>();
+    for (int targetVertex : targetVertices) {
+        auto it = distances.find(targetVertex);
+        witnessDistances.push_back(it == distances.end() ? INT_MAX : it->second);
+    }
+    return witnessDistances;
+}
+
+/*
+    Calculate the earliest arrival time at the target stop. The downward edges that lead to the target are marked by a backward
+    search, afterwards a time dependent dijkstra from the source uses the upward edges, the core edges and the marked downward edges.
+    The times are relative to the start of the query day like in raptor.
+*/
+TDQueryResult TimeDependentGraph::getEarliestArrivalTime(int sourceStopId, int targetStopId, int sourceTime, int weekday) {
+    TDQueryResult result;
+    result.earliestArrivalTime = INT_MAX;
+    result.numberOfSettledVertices = 0;
+
+    int weekOffset = weekday * SECONDS_PER_DAY;
+    int latestArrivalTime = weekOffset + (NUMBER_OF_DAYS + 1) * SECONDS_PER_DAY;
+    int targetVertex = 2 * targetStopId + 1;
+
+    unordered_set<int> markedVertices;
+    markedVertices.insert(targetVertex);
+    vector<int> stack = {targetVertex};
+    while (!stack.empty()) {
+        int vertex = stack.back();
+        stack.pop_back();
+        for (int j = downwardInEdgeOffsets[vertex]; j < downwardInEdgeOffsets[vertex + 1]; j++) {
+            if (markedVertices.insert(downwardInEdgeSources[j]).second) {
+                stack.push_back(downwardInEdgeSources[j]);
+            }
+        }
+    }
+
+    unordered_map<int, int> arrivalTimes;
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+
+    // like in raptor the foot paths of the source stop are used before the first ride
+    int indexOfFirstFootPathOfSourceStop = Importer::indexOfFirstFootPathOfAStop[sourceStopId];
+    for (int i = indexOfFirstFootPathOfSourceStop; i < Importer::footPaths.size(); i++) {
+        if (Importer::footPaths[i].departureStopId != sourceStopId) {
+            break;
+        }
+        int vertex = 2 * Importer::footPaths[i].arrivalStopId + 1;
+        int arrivalTime = weekOffset + sourceTime + Importer::footPaths[i].duration;
+        auto it = arrivalTimes.find(vertex);
+        if (it == arrivalTimes.end() || arrivalTime < it->second) {
+            arrivalTimes[vertex] = arrivalTime;
+            pq.push(make_pair(arrivalTime, vertex));
+        }
+    }
+
+    while (!pq.empty()) {
+        int arrivalTime = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+
+        if (arrivalTime > arrivalTimes[u]) {
+            continue;
+        }
+        result.numberOfSettledVertices++;
+
+        if (u == targetVertex) {
+            result.earliestArrivalTime = arrivalTime - weekOffset;
+            break;
+        }
+
+        for (int j = edgeOffsets[u]; j < edgeOffsets[u + 1]; j++) {
+            int v = edgeTargets[j];
+            if (levels[v] < levels[u] && markedVertices.find(v) == markedVertices.end()) {
+                continue;
+            }
+
+            int newArrivalTime = edgeFunctions[j].evaluate(arrivalTime);
+            if (newArrivalTime > latestArrivalTime) {
+                continue;
+            }
+
+            auto it = arrivalTimes.find(v);
+            if (it == arrivalTimes.end() || newArrivalTime < it->second) {
+                arrivalTimes[v] = newArrivalTime;
+                pq.push(make_pair(newArrivalTime, v));
+            }
+        }
+    }
+
+    return result;
+}
+/*
+    Create the metric independent topology. The input edges are the connections and foot paths between the stops, the arcs
+    are stored at their lower vertex. Contracting a vertex connects all of its higher neighbors, it is enough to add them to
+    the lowest higher neighbor, which is contracted next among them.
+*/
+void CustomizableCH::createTopology(vector<int> stopIdsSortedByLevel) {
+    cout << "Creating customizable contraction hierarchie topology..." << endl;
+    auto start = chrono::high_resolution_clock::now();
+
+    int numberOfVertices = stopIdsSortedByLevel.size();
+    this->stopIdsSortedByLevel = stopIdsSortedByLevel;
+    levelOfStopId = vector<int>(numberOfVertices);
+    for (int level = 0; level < numberOfVertices; level++) {
+        levelOfStopId[stopIdsSortedByLevel[level]] = level;
+    }
+
+    vector<vector<pair<int, int>>> inputConnectionDurations = vector<vector<pair<int, int>>>(numberOfVertices);
+    for (int i = 0; i < Importer::connections.size(); i++) {
+        Connection connection = Importer::connections[i];
+        int duration = connection.arrivalTime - connection.departureTime;
+        if (duration < 0) {
+            duration += SECONDS_PER_DAY;
+        }
+        int departureLevel = levelOfStopId[connection.departureStopId];
+        int arrivalLevel = levelOfStopId[connection.arrivalStopId];
+        if (departureLevel != arrivalLevel) {
+            inputConnectionDurations[min(departureLevel, arrivalLevel)].push_back(make_pair(max(departureLevel, arrivalLevel), duration));
+        }
+    }
+
+    vector<vector<pair<int, double>>> inputWalkingDistances = vector<vector<pair<int, double>>>(numberOfVertices);
+    for (int i = 0; i < Importer::footPaths.size(); i++) {
+        FootPath footPath = Importer::footPaths[i];
+        if (footPath.departureStopId == footPath.arrivalStopId) {
+            continue;
+        }
+        Stop departureStop = Importer::stops[footPath.departureStopId];
+        Stop arrivalStop = Importer::stops[footPath.arrivalStopId];
+        double distance = DistanceCalculator::calculateDistance(departureStop.lat, departureStop.lon, arrivalStop.lat, arrivalStop.lon);
+        int departureLevel = levelOfStopId[footPath.departureStopId];
+        int arrivalLevel = levelOfStopId[footPath.arrivalStopId];
+        inputWalkingDistances[min(departureLevel, arrivalLevel)].push_back(make_pair(max(departureLevel, arrivalLevel), distance));
+    }
+
+    vector<vector<int>> higherNeighbors = vector<vector<int>>(numberOfVertices);
+    for (int level = 0; level < numberOfVertices; level++) {
+        for (int i = 0; i < inputConnectionDurations[level].size(); i++) {
+            higherNeighbors[level].push_back(inputConnectionDurations[level][i].first);
+        }
+        for (int i = 0; i < inputWalkingDistances[level].size(); i++) {
+            higherNeighbors[level].push_back(inputWalkingDistances[level][i].first);
+        }
+        sort(higherNeighbors[level].begin(), higherNeighbors[level].end());
+        higherNeighbors[level].erase(unique(higherNeighbors[level].begin(), higherNeighbors[level].end()), higherNeighbors[level].end());
+    }
+
+    for (int level = 0; level < numberOfVertices; level++) {
+        if (higherNeighbors[level].size() < 2) {
+            continue;
+        }
+        int lowestNeighbor = higherNeighbors[level][0];
+        vector<int> mergedNeighbors = vector<int>();
+        set_union(higherNeighbors[lowestNeighbor].begin(), higherNeighbors[lowestNeighbor].end(), higherNeighbors[level].begin() + 1,
+            higherNeighbors[level].end(), back_inserter(mergedNeighbors));
+        higherNeighbors[lowestNeighbor] = mergedNeighbors;
+    }
+
+    arcOffsets = vector<int>(numberOfVertices + 1, 0);
+    for (int level = 0; level < numberOfVertices; level++) {
+        arcOffsets[level + 1] = arcOffsets[level] + higherNeighbors[level].size();
+    }
+    arcTargetLevels = vector<int>(arcOffsets[numberOfVertices]);
+    for (int level = 0; level < numberOfVertices; level++) {
+        copy(higherNeighbors[level].begin(), higherNeighbors[level].end(), arcTargetLevels.begin() + arcOffsets[level]);
+    }
+
+    arcConnectionDurations = vector<int>(arcTargetLevels.size(), -1);
+    arcWalkingDistances = vector<double>(arcTargetLevels.size(), -1);
+    for (int level = 0; level < numberOfVertices; level++) {
+        for (int i = 0; i < inputConnectionDurations[level].size(); i++) {
+            int arc = findArc(level, inputConnectionDurations[level][i].first);
+            int duration = inputConnectionDurations[level][i].second;
+            if (arcConnectionDurations[arc] == -1 || duration < arcConnectionDurations[arc]) {
+                arcConnectionDurations[arc] = duration;
+            }
+        }
+        for (int i = 0; i < inputWalkingDistances[level].size(); i++) {
+            int arc = findArc(level, inputWalkingDistances[level][i].first);
+            double distance = inputWalkingDistances[level][i].second;
+            if (arcWalkingDistances[arc] == -1 || distance < arcWalkingDistances[arc]) {
+                arcWalkingDistances[arc] = distance;
+            }
+        }
+    }
+
+    auto end = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+    cout << "Customizable contraction hierarchie topology with " << arcTargetLevels.size() << " arcs created in " << duration.count() << "ms.\n" << endl;
+}
+
+bool CustomizableCH::isCreated() {
+    return !arcOffsets.empty();
+}
+
+/*
+    Customize the weights of the topology for a profile and store the resulting contraction hierarchie. Every arc gets the
+    minimum of its connection and walking duration, then the lower triangles are processed bottom up: the arcs to two higher
+    neighbors of a vertex form a path between them that the arc between these neighbors must not exceed. Returns the index
+    of the metric.
+*/
+int CustomizableCH::addMetric(MetricProfile profile) {
+    auto start = chrono::high_resolution_clock::now();
+
+    int numberOfVertices = stopIdsSortedByLevel.size();
+    double secondsPerKilometer = 3600 / profile.walkingSpeed;
+
+    vector<int> weights = vector<int>(arcTargetLevels.size(), INT_MAX);
+    for (int i = 0; i < arcTargetLevels.size(); i++) {
+        if (arcConnectionDurations[i] != -1) {
+            weights[i] = arcConnectionDurations[i];
+        }
+        if (arcWalkingDistances[i] != -1) {
+            int walkingDuration = (int) (arcWalkingDistances[i] * secondsPerKilometer) + profile.transferBuffer;
+            weights[i] = min(weights[i], walkingDuration);
+        }
+    }
+
+    for (int level = 0; level < numberOfVertices; level++) {
+        for (int i = arcOffsets[level]; i < arcOffsets[level + 1]; i++) {
+            if (weights[i] == INT_MAX) {
+                continue;
+            }
+            for (int j = i + 1; j < arcOffsets[level + 1]; j++) {
+                if (weights[j] == INT_MAX) {
+                    continue;
+                }
+                int arc = findArc(arcTargetLevels[i], arcTargetLevels[j]);
+                weights[arc] = min(weights[arc], weights[i] + weights[j]);
+            }
+        }
+    }
+
+    // the graph is symmetric, so the downward edges of a level equal its upward edges
+    shared_ptr<CHGraph> chGraph = make_shared<CHGraph>();
+    chGraph->stopIdsSortedByLevel = stopIdsSortedByLevel;
+    chGraph->upwardEdgeOffsets = vector<int>(numberOfVertices + 1, 0);
+    for (int level = 0; level < numberOfVertices; level++) {
+        chGraph->upwardEdgeOffsets[level + 1] = chGraph->upwardEdgeOffsets[level];
+        for (int i = arcOffsets[level]; i < arcOffsets[level + 1]; i++) {
+            if (weights[i] != INT_MAX) {
+                chGraph->upwardEdgeTargetLevels.push_back(arcTargetLevels[i]);
+                chGraph->upwardEdgeWeights.push_back(weights[i]);
+                chGraph->upwardEdgeOffsets[level + 1]++;
+            }
+        }
+    }
+    chGraph->downwardEdgeOffsets = chGraph->upwardEdgeOffsets;
+    chGraph->downwardEdgeTargetLevels = chGraph->upwardEdgeTargetLevels;
+    chGraph->downwardEdgeWeights = chGraph->upwardEdgeWeights;
+
+    metrics.push_back(chGraph);
+
+    auto end = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+    cout << "Customized metric " << metrics.size() - 1 << " (" << profile.walkingSpeed << " km/h, " << profile.transferBuffer << "s transfer buffer) in " << duration.count() << "ms." << endl;
+
+    return metrics.size() - 1;
+}
+
+int CustomizableCH::getNumberOfMetrics() {
+    return metrics.size();
+}
+
+shared_ptr<CHGraph> CustomizableCH::getMetric(int metricIndex) {
+    return metrics[metricIndex];
+}
+
+int CustomizableCH::getDistance(int metricIndex, int sourceStopId, int targetStopId) {
+    return metrics[metricIndex]->getDistance(levelOfStopId[sourceStopId], levelOfStopId[targetStopId]);
+}
+
+/*
+    Calculate the distances of the metric with the given index from the source to all targets with a bucket based many-to-many query.
+*/
+vector<int> CustomizableCH::getDistancesToTargets(int metricIndex, int sourceStopId, vector<int> targetStopIds) {
+    vector<int> targetLevels = vector<int>(targetStopIds.size());
+    for (int i = 0; i < targetStopIds.size(); i++) {
+        targetLevels[i] = levelOfStopId[targetStopIds[i]];
+    }
+    CHBuckets buckets = metrics[metricIndex]->createBuckets(targetLevels);
+    return metrics[metricIndex]->getDistancesToTargets(levelOfStopId[sourceStopId], buckets);
+}
+
+/*
+    Returns the index of the arc between both levels, the source level has to be the lower one.
+*/
+int CustomizableCH::findArc(int sourceLevel, int targetLevel) {
+    auto first = arcTargetLevels.begin() + arcOffsets[sourceLevel];
+    auto last = arcTargetLevels.begin() + arcOffsets[sourceLevel + 1];
+    auto it = lower_bound(first, last, targetLevel);
+    if (it == last || *it != targetLevel) {
+        return -1;
+    }
+    return it - arcTargetLevels.begin();
+}
+
+int PartitionGraph::getNumberOfVertices() {
+    return vertexWeights.size();
+}
+
+/*
+    Calculate the sum of the weights of the edges between different parts of the partition.
+*/
+int PartitionGraph::getEdgeCut(vector<int> &partition) {
+    int edgeCut = 0;
+    for (int i = 0; i < getNumberOfVertices(); i++) {
+        for (int j = edgeOffsets[i]; j < edgeOffsets[i + 1]; j++) {
+            if (partition[i] != partition[edgeTargets[j]]) {
+                edgeCut += edgeWeights[j];
+            }
+        }
+    }
+    return edgeCut;
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include <../data-handling/importer.h>
 #include <vector>
 #include <map>
+#include <set>
+#include <climits>
+#include <memory>
 
 using namespace std;
 
@@ -28,6 +31,239 @@ struct Shortcut {
     int ewgt; // the weight of the shortcut
 };
 
+/*
+    A monotone priority queue for non negative integer keys. The elements are stored in buckets by the highest bit in which
+    their key differs from the last popped key, so the popped keys must never decrease.
+*/
+class RadixHeap {
+    public:
+        explicit RadixHeap() {
+            size = 0;
+            lastPoppedKey = 0;
+        };
+        ~RadixHeap(){};
+
+        void push(int key, int value);
+        pair<int, int> pop();
+        bool empty();
+        void clear();
+
+    private:
+        int getBucketIndex(int key);
+
+        vector<pair<int, int>> buckets[33];
+        int size;
+        int lastPoppedKey;
+};
+
+/*
+    A reusable state for dijkstra searches on the same graph. The distances and the targets are only valid if their timestamp
+    matches the timestamp of the current search, so the arrays don't need to be reset between the searches.
+*/
+class DijkstraContext {
+    public:
+        explicit DijkstraContext(int numberOfVertices) {
+            distances = vector<int>(numberOfVertices, INT_MAX);
+            distanceTimestamps = vector<int>(numberOfVertices, 0);
+            targetTimestamps = vector<int>(numberOfVertices, 0);
+            currentTimestamp = 0;
+        };
+        ~DijkstraContext(){};
+
+        void calculateDistances(vector<vector<Edge>> &adjacencyList, int sourceStopId, vector<int> &targetStopIds);
+        int getDistance(int stopId);
+
+    private:
+        RadixHeap heap;
+        vector<int> distances;
+        vector<int> distanceTimestamps;
+        vector<int> targetTimestamps;
+        int currentTimestamp;
+};
+
+/*
+    The distances of a phast query as a dense matrix. The distances of all sources to a stop are stored next to each other,
+    the distance from the i-th source to a stop is at index stopId * numberOfSourceStopIds + i.
+*/
+struct PhastDistances {
+    int numberOfSourceStopIds = 0;
+    vector<int> distances;
+};
+
+/*
+    The buckets of a many-to-many query in the contraction hierarchie. Every level that is reached by the backward search of
+    a target stores the index of the target and the distance to it. The entries are sorted by level.
+*/
+struct BucketEntry {
+    int level;
+    int targetIndex;
+    int distance;
+};
+
+struct CHBuckets {
+    int numberOfTargets;
+    vector<BucketEntry> entries;
+};
+
+/*
+    An immutable representation of a contraction hierarchie for the queries. The vertices are renumbered by their level, so the
+    edges only store the level of their target. The edges from the vertex with level i to higher levels are stored from
+    upwardEdgeOffsets[i] to upwardEdgeOffsets[i+1], the edges from higher levels to the vertex with level i are stored from
+    downwardEdgeOffsets[i] to downwardEdgeOffsets[i+1].
+*/
+class CHGraph {
+    public:
+        explicit CHGraph() {};
+        explicit CHGraph(vector<Vertex> &vertices, vector<vector<Edge>> &adjacencyList);
+        ~CHGraph(){};
+
+        vector<int> stopIdsSortedByLevel;
+
+        vector<int> upwardEdgeOffsets;
+        vector<int> upwardEdgeTargetLevels;
+        vector<int> upwardEdgeWeights;
+
+        vector<int> downwardEdgeOffsets;
+        vector<int> downwardEdgeTargetLevels;
+        vector<int> downwardEdgeWeights;
+
+        int getDistance(int sourceLevel, int targetLevel);
+        CHBuckets createBuckets(vector<int> targetLevels);
+        vector<int> getDistancesToTargets(int sourceLevel, CHBuckets &buckets);
+        void exportBinary(string fileName);
+        bool importBinary(string fileName);
+
+    private:
+        vector<pair<int, int>> getUpwardSearchSpace(int level, bool forward);
+};
+
+
+/*
+    A piecewise linear travel time function of an edge in the time dependent graph. The points store the departure time within
+    the week and the earliest arrival time of a connection, the function waits for the next departure. Edges that can be walked
+    have a constant walking duration in addition (INT_MAX if they can't be walked).
+*/
+class TravelTimeFunction {
+    public:
+        explicit TravelTimeFunction() {};
+        ~TravelTimeFunction(){};
+
+        int walkingDuration = INT_MAX;
+        vector<pair<int, int>> points;
+
+        int minimumDuration = INT_MAX;
+        int maximumDuration = INT_MAX;
+
+        int evaluate(int departureTime);
+        void reduce();
+
+        static TravelTimeFunction link(TravelTimeFunction &first, TravelTimeFunction &second);
+        static TravelTimeFunction merge(TravelTimeFunction &first, TravelTimeFunction &second);
+
+    private:
+        int evaluatePoints(int departureTime);
+};
+
+struct TDQueryResult {
+    int earliestArrivalTime;
+    int numberOfSettledVertices;
+};
+
+/*
+    A time dependent contraction hierarchie of the station graph. Every stop has an arrival vertex (2 * stopId), which is reached
+    by the connections, and a departure vertex (2 * stopId + 1), which is reached by the foot paths. So like in raptor each ride is
+    followed by exactly one foot path. The vertices of the core are not contracted and share the highest level.
+*/
+class TimeDependentGraph {
+    public:
+        explicit TimeDependentGraph() {};
+        ~TimeDependentGraph(){};
+
+        void createContractionHierarchie();
+        bool isCreated();
+        TDQueryResult getEarliestArrivalTime(int sourceStopId, int targetStopId, int sourceTime, int weekday);
+
+    private:
+        void createEdges(vector<map<int, TravelTimeFunction>> &outEdges);
+        vector<int> getWitnessDistances(vector<map<int, TravelTimeFunction>> &outEdges, int sourceVertex, int excludeVertex, set<int> &targetVertices);
+
+        vector<int> levels;
+
+        vector<int> edgeOffsets;
+        vector<int> edgeTargets;
+        vector<TravelTimeFunction> edgeFunctions;
+
+        // the sources of the edges from higher levels to the vertex i, stored from downwardInEdgeOffsets[i] to downwardInEdgeOffsets[i+1]
+        vector<int> downwardInEdgeOffsets;
+        vector<int> downwardInEdgeSources;
+};
+
+/*
+    The parameters of a metric of the customizable contraction hierarchie. The walking speed (km/h) scales the durations of the
+    foot paths and the transfer buffer (seconds) is added to every foot path.
+*/
+struct MetricProfile {
+    double walkingSpeed;
+    int transferBuffer;
+};
+
+/*
+    A customizable contraction hierarchie. The topology is created once from a contraction order without witness searches, so it
+    contains every shortcut that a metric can need. A new walking speed or transfer buffer only requires a customization of the
+    weights instead of a new contraction. The customized metrics are kept side by side and are addressed by their index.
+*/
+class CustomizableCH {
+    public:
+        explicit CustomizableCH() {};
+        ~CustomizableCH(){};
+
+        void createTopology(vector<int> stopIdsSortedByLevel);
+        bool isCreated();
+        int addMetric(MetricProfile profile);
+        int getNumberOfMetrics();
+        shared_ptr<CHGraph> getMetric(int metricIndex);
+        int getDistance(int metricIndex, int sourceStopId, int targetStopId);
+        vector<int> getDistancesToTargets(int metricIndex, int sourceStopId, vector<int> targetStopIds);
+
+    private:
+        vector<int> stopIdsSortedByLevel;
+        vector<int> levelOfStopId;
+
+        // the arcs from the vertex with level i to higher levels are stored from arcOffsets[i] to arcOffsets[i+1], sorted by their target level
+        vector<int> arcOffsets;
+        vector<int> arcTargetLevels;
+
+        // the minimal duration of a connection and the walking distance (km) between the stops of an arc, -1 if there is none
+        vector<int> arcConnectionDurations;
+        vector<double> arcWalkingDistances;
+
+        vector<shared_ptr<CHGraph>> metrics;
+
+        int findArc(int sourceLevel, int targetLevel);
+};
+
+/*
+    A graph in compressed sparse row format that is used by the multilevel partitioner. The vertex indices refer to the vertices 
+    of the partitionated graph and are only set on the finest level.
+*/
+class PartitionGraph {
+    public:
+        explicit PartitionGraph() {};
+        ~PartitionGraph(){};
+
+        vector<int> vertexIndices;
+        vector<int> vertexWeights;
+        vector<int> contractedEdgeWeights;
+        vector<int> edgeOffsets;
+        vector<int> edgeTargets;
+        vector<int> edgeWeights;
+
+        vector<int> partition;
+        vector<int> indexToCoarserGraphIndex;
+
+        int getNumberOfVertices();
+        int getEdgeCut(vector<int> &partition);
+};
 
 /*
     A graph that represents the public transit network.
@@ -41,25 +277,30 @@ class Graph {
         vector<vector<Edge>> adjacencyList;
         vector<int> partition;
 
-        vector<int> matchings;
-        map<int, int> indexToCoarserGraphIndex;
-
         vector<int> getDistances(int sourceStopId, vector<int> targetStopIds);
         void exportGraph(DataType dataType);
         void importPartition(DataType dataType, int numberOfPartitions);
 
         void exportGraphWithCH(DataType dataType);
         void importGraphWithCH(DataType dataType);
+        void exportGraphWithCHBinary(DataType dataType);
+        bool importGraphWithCHBinary(DataType dataType);
 
         void createContractionHierarchie();
+        void createContractionHierarchieSerial();
 
         map<int, vector<int>> getDistancesWithPhast(vector<int> sourceStopIds);
+        PhastDistances getDistanceMatrixWithPhast(vector<int> sourceStopIds);
+        int getDistanceWithCH(int sourceStopId, int targetStopId);
+        CHBuckets createBucketsWithCH(vector<int> targetStopIds);
+        vector<int> getDistancesToTargetsWithCH(int sourceStopId, CHBuckets &buckets);
+        vector<int> getStopIdsSortedByLevel();
 
     private:
         pair<int, vector<Shortcut>> calculateEdgeDifferenceAndGetShortcuts(int vertexIndex);
         vector<int> getDistancesForCHCreation(int sourceStopId, int excludeStopId, int maxDistance);
-
         vector<int> stopIdsSortedByLevel;
+        CHGraph chGraph;
 };
 
 #endif //CMAKE_GRAPH_H
\ No newline at end of file
@@ -18,80 +18,14 @@
 #include "gtree-controller.h"
 
 /*
-    Find the best parameters for the GTree algorithm. Compares the run time and accuracy of the GTree algorithm with different parameters.
+    Find the best parameters for the GTree algorithm. The candidates are built concurrently and compared on the same stored queries, 
+    the chosen parameters are used by the main program.
 */
 void ExperimentController::findBestGTreeParameters(DataType dataType, int numberOfSourceStops, int numberOfSuccessfulQueries) {
     vector<int> numberOfChildrenPerNodeParams = {2, 4};
     vector<int> maxNumberOfVerticesPerLeafParams = {16, 32, 64, 128};
 
-    // vector<int> numberOfChildrenPerNodeParams = {2};
-    // vector<int> maxNumberOfVerticesPerLeafParams = {16, 64};
-
-    double bestRunTimeCSA = INT_MAX;
-    int bestNumberOfChildrenPerNodeRunTimeCSA = 0;
-    int bestMaxNumberOfVerticesPerLeafRunTimeCSA = 0;
-
-    double bestRunTimeApprox = INT_MAX;
-    int bestNumberOfChildrenPerNodeRunTimeApprox = 0;
-    int bestMaxNumberOfVerticesPerLeafRunTimeApprox = 0;
-
-    double bestAccuracyMinSum = 0;
-    int bestNumberOfChildrenPerNodeAccuracyMinSum = 0;
-    int bestMaxNumberOfVerticesPerLeafAccuracyMinSum = 0;
-
-    double bestAccuracyMinMax = 0;
-    int bestNumberOfChildrenPerNodeAccuracyMinMax = 0;
-    int bestMaxNumberOfVerticesPerLeafAccuracyMinMax = 0;
-    
-    for (int numberOfChildrenPerNode : numberOfChildrenPerNodeParams) {
-        for (int maxNumberOfVerticesPerLeaf : maxNumberOfVerticesPerLeafParams) {
-            GTree* gTreePointer = GTreeController::createOrLoadNetworkGTree(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf);
-            
-            AverageRunTimeAndAccuracy averageRunTimeAndAccuracy = GTreeAlgorithmTester::getAverageRunTimeAndAccuracy(dataType, gTreePointer, numberOfSourceStops, numberOfSuccessfulQueries);
-
-            if (averageRunTimeAndAccuracy.averageRunTimeGTreeCSA < bestRunTimeCSA) {
-                bestRunTimeCSA = averageRunTimeAndAccuracy.averageRunTimeGTreeCSA;
-                bestNumberOfChildrenPerNodeRunTimeCSA = numberOfChildrenPerNode;
-                bestMaxNumberOfVerticesPerLeafRunTimeCSA = maxNumberOfVerticesPerLeaf;
-            }
-
-            if (averageRunTimeAndAccuracy.averageRunTimeGTreeApproximation < bestRunTimeApprox) {
-                bestRunTimeApprox = averageRunTimeAndAccuracy.averageRunTimeGTreeApproximation;
-                bestNumberOfChildrenPerNodeRunTimeApprox = numberOfChildrenPerNode;
-                bestMaxNumberOfVerticesPerLeafRunTimeApprox = maxNumberOfVerticesPerLeaf;
-            }
-
-            if (averageRunTimeAndAccuracy.averageAccuracyMinSum > bestAccuracyMinSum) {
-                bestAccuracyMinSum = averageRunTimeAndAccuracy.averageAccuracyMinSum;
-                bestNumberOfChildrenPerNodeAccuracyMinSum = numberOfChildrenPerNode;
-                bestMaxNumberOfVerticesPerLeafAccuracyMinSum = maxNumberOfVerticesPerLeaf;
-            }
-
-            if (averageRunTimeAndAccuracy.averageAccuracyMinMax > bestAccuracyMinMax) {
-                bestAccuracyMinMax = averageRunTimeAndAccuracy.averageAccuracyMinMax;
-                bestNumberOfChildrenPerNodeAccuracyMinMax = numberOfChildrenPerNode;
-                bestMaxNumberOfVerticesPerLeafAccuracyMinMax = maxNumberOfVerticesPerLeaf;
-            }
-        }
-    }
-
-    string dataTypeString = Importer::getDataTypeString(dataType);
-    string folderPathParams = FOLDER_PREFIX + "tests/" + dataTypeString + "/gtree_params/";
-
-    string filePath = folderPathParams + "gtree_best_params.csv";
-
-    std::ofstream paramsFile;
-    paramsFile.open(filePath, std::ofstream::out);
-
-    paramsFile << "numberOfChildrenPerNodeRunTimeCSA,maxNumberOfVerticesPerLeafRunTimeCSA,numberOfChildrenPerNodeRunTimeApprox,maxNumberOfVerticesPerLeafRunTimeApprox,numberOfChildrenPerNodeAccuracyMinSum,maxNumberOfVerticesPerLeafAccuracyMinSum,numberOfChildrenPerNodeAccuracyMinMax,maxNumberOfVerticesPerLeafAccuracyMinMax" << endl;
-    paramsFile << bestNumberOfChildrenPerNodeRunTimeCSA << "," << bestMaxNumberOfVerticesPerLeafRunTimeCSA << "," << bestNumberOfChildrenPerNodeRunTimeApprox << "," << bestMaxNumberOfVerticesPerLeafRunTimeApprox << "," << bestNumberOfChildrenPerNodeAccuracyMinSum << "," << bestMaxNumberOfVerticesPerLeafAccuracyMinSum << "," << bestNumberOfChildrenPerNodeAccuracyMinMax << "," << bestMaxNumberOfVerticesPerLeafAccuracyMinMax << endl;
-
-    paramsFile.close();
-
-    cout << "Best parameters for CSA run time: " << bestNumberOfChildrenPerNodeRunTimeCSA << " children per node, " << bestMaxNumberOfVerticesPerLeafRunTimeCSA << " vertices per leaf" << endl;
-    cout << "Best parameters for approximation run time: " << bestNumberOfChildrenPerNodeRunTimeApprox << " children per node, " << bestMaxNumberOfVerticesPerLeafRunTimeApprox << " vertices per leaf" << endl;
-    cout << "Best parameters for accuracy min sum: " << bestNumberOfChildrenPerNodeAccuracyMinSum << " children per node, " << bestMaxNumberOfVerticesPerLeafAccuracyMinSum << " vertices per leaf" << endl;
-    cout << "Best parameters for accuracy min max: " << bestNumberOfChildrenPerNodeAccuracyMinMax << " children per node, " << bestMaxNumberOfVerticesPerLeafAccuracyMinMax << " vertices per leaf" << endl;
+    GTreeController::tuneGTreeParameters(dataType, numberOfChildrenPerNodeParams, maxNumberOfVerticesPerLeafParams, numberOfSourceStops, numberOfSuccessfulQueries);
 }
 
 /*
@@ -123,10 +57,42 @@ void ExperimentController::compareRaptorEATAlgorithms(DataType dataType, int num
     RaptorEATAlgorithmTester::compareRaptorEATAlgorithms(dataType, numberOfSuccessfulQueries, true);
 }
 
+void ExperimentController::compareRaptorAndTDCH(DataType dataType, int numberOfQueries) {
+    RaptorEATAlgorithmTester::compareRaptorAndTDCH(dataType, numberOfQueries);
+}
+
+void ExperimentController::compareNaiveWithSourceProfiles(int numberOfQueries, vector<int> numberOfSources) {
+    AlgorithmComparer::compareNaiveWithSourceProfiles(numberOfQueries, numberOfSources);
+}
+
+void ExperimentController::compareWeightedObjectiveWithBruteForce(int numberOfQueries, vector<int> numberOfSources) {
+    AlgorithmComparer::compareWeightedObjectiveWithBruteForce(numberOfQueries, numberOfSources);
+}
+
+void ExperimentController::compareSeparatedMeetingPointsWithBruteForce(int numberOfQueries, vector<int> numberOfSources) {
+    AlgorithmComparer::compareSeparatedMeetingPointsWithBruteForce(numberOfQueries, numberOfSources, 5);
+}
+
+void ExperimentController::compareTimeLabels(int numberOfQueries, vector<int> numberOfSources) {
+    AlgorithmComparer::compareTimeLabels(numberOfQueries, numberOfSources);
+}
+
 void ExperimentController::evaluateLowerBounds(int numberOfSources, int numberOfTargetsPerSource) {
     LowerBoundTester::getLowerBoundDiffs(numberOfSources, numberOfTargetsPerSource);
 }
 
+void ExperimentController::comparePhastImplementations(vector<int> numberOfSources) {
+    LowerBoundTester::comparePhastImplementations(numberOfSources, 10);
+}
+
+void ExperimentController::compareContractionHierarchieCreation(int numberOfSources) {
+    LowerBoundTester::compareContractionHierarchieCreation(numberOfSources);
+}
+
+void ExperimentController::compareCustomizableCH(int numberOfSources) {
+    LowerBoundTester::compareCustomizableCH(numberOfSources, 100);
+}
+
 void ExperimentController::testRaptorNaiveAlgorithmMultipleResult(int numberOfSuccessfulQueries, vector<int> numberOfSources) {
     RaptorAlgorithmTester::testRaptorNaiveAlgorithmRandom(numberOfSuccessfulQueries, numberOfSources);
 }
\ No newline at end of file
@@ -15,7 +15,15 @@ class ExperimentController {
         static void compareRaptorApproxAlgorithms(DataType dataType, int numberOfSuccessfulQueries, vector<int> numberOfSourceStops);
         static void testRaptorApproxAlgorithmForLargeNofSources(DataType dataType, int numberOfSuccessfulQueries, vector<int> numberOfSourceStops);
         static void compareRaptorEATAlgorithms(DataType dataType, int numberOfSuccessfulQueries);
+        static void compareRaptorAndTDCH(DataType dataType, int numberOfQueries);
+        static void compareNaiveWithSourceProfiles(int numberOfQueries, vector<int> numberOfSources);
+        static void compareWeightedObjectiveWithBruteForce(int numberOfQueries, vector<int> numberOfSources);
+        static void compareSeparatedMeetingPointsWithBruteForce(int numberOfQueries, vector<int> numberOfSources);
+        static void compareTimeLabels(int numberOfQueries, vector<int> numberOfSources);
         static void evaluateLowerBounds(int numberOfSources, int numberOfTargetsPerSource);
+        static void comparePhastImplementations(vector<int> numberOfSources);
+        static void compareContractionHierarchieCreation(int numberOfSources);
+        static void compareCustomizableCH(int numberOfSources);
         static void testRaptorNaiveAlgorithmMultipleResult(int numberOfSuccessfulQueries, vector<int> numberOfSources);
 };
 
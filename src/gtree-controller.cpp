@@ -7,7 +7,15 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <chrono>
+#include <omp.h>
 
+/*
+    Load the G-tree from its binary file. A tree that only exists in the former json files is converted to the binary format, 
+    otherwise the tree is created and exported. The duration matrices of a lazy tree are mapped from the binary file and only 
+    loaded when a query uses them.
+*/
 GTree* GTreeController::createOrLoadNetworkGTree(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf) {
     vector<int> stopIds = vector<int>(0);
     for (int i = 0; i < Creator::networkGraph.vertices.size(); i++) {
@@ -30,22 +38,285 @@ GTree* GTreeController::createOrLoadNetworkGTree(DataType dataType, int numberOf
     }
     fileName += "-0.json";
 
+    GTree* gTree = new GTree();
+    if (!gTree->importTreeFromBinary(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf, USE_LAZY_GTREE)) {
+        ifstream file(fileName);
+        if (file.good()) {
+            file.close();
+            gTree->importTreeFromJson(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf, numberOfFiles);
+            gTree->exportTreeAsBinary(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf);
+        } else {
+            file.close();
+            delete gTree;
+            gTree = Creator::createNetworkGTree(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf, false);
+            gTree->calculateBorderDistancesOfStopIds(stopIds);
+            gTree->exportTreeAsBinary(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf);
+        }
+
+        // map the exported file to release the matrices of the created tree
+        if (USE_LAZY_GTREE) {
+            GTree* mappedGTree = new GTree();
+            if (mappedGTree->importTreeFromBinary(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf, true)) {
+                delete gTree;
+                gTree = mappedGTree;
+            } else {
+                delete mappedGTree;
+            }
+        }
+    }
+
+    // the time buckets are not stored in the files
+    if (USE_GTREE_TIME_BUCKETS) {
+        gTree->calculateTimeBucketDurations();
+    }
+    return gTree;
+}
+
+void GTreeController::calculateBorderDistancesOfStopIdsAndExportTree(GTree* gTree, vector<int> stopIds, DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf) {
+    gTree->calculateBorderDistancesOfStopIds(stopIds);
+    gTree->exportTreeAsBinary(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf);
+}
+
+string GTreeController::getGTreeParametersFileName(DataType dataType) {
+    string dataTypeString = Importer::getDataTypeString(dataType);
+    return FOLDER_PREFIX + "graphs/" + dataTypeString + "/g-tree-parameters.csv";
+}
+
+/*
+    Load the G-tree parameters that were chosen by the last tuning of the data type. Without a tuning the default parameters of the 
+    data type are used.
+*/
+void GTreeController::loadGTreeParameters(DataType dataType, int &numberOfChildrenPerNode, int &maxNumberOfVerticesPerLeaf) {
+    if (dataType == schienenfernverkehr_de) {
+        numberOfChildrenPerNode = 2;
+        maxNumberOfVerticesPerLeaf = 32;
+    } else if (dataType == schienenregionalverkehr_de || dataType == schienenfern_und_regionalverkehr_de) {
+        numberOfChildrenPerNode = 4;
+        maxNumberOfVerticesPerLeaf = 128;
+    } else if (dataType == gesamt_de) {
+        numberOfChildrenPerNode = 4;
+        maxNumberOfVerticesPerLeaf = 512;
+    } else {
+        numberOfChildrenPerNode = 4;
+        maxNumberOfVerticesPerLeaf = 64;
+    }
+
+    string fileName = getGTreeParametersFileName(dataType);
     ifstream file(fileName);
-    if (file.good()) {
-        file.close();
-        GTree* gTree = new GTree();
-        gTree->importTreeFromJson(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf, numberOfFiles);
-        return gTree;
+    if (!file.is_open()) {
+        cout << "No tuned G-tree parameters found. Using " << numberOfChildrenPerNode << " children per node and " << maxNumberOfVerticesPerLeaf << " vertices per leaf." << endl;
+        return;
+    }
+
+    string line;
+    getline(file, line);
+    char separator;
+    int tunedNumberOfChildrenPerNode;
+    int tunedMaxNumberOfVerticesPerLeaf;
+    if (getline(file, line) && stringstream(line) >> tunedNumberOfChildrenPerNode >> separator >> tunedMaxNumberOfVerticesPerLeaf 
+        && tunedNumberOfChildrenPerNode > 1 && tunedMaxNumberOfVerticesPerLeaf > 0) {
+        numberOfChildrenPerNode = tunedNumberOfChildrenPerNode;
+        maxNumberOfVerticesPerLeaf = tunedMaxNumberOfVerticesPerLeaf;
+        cout << "Using the tuned G-tree parameters: " << numberOfChildrenPerNode << " children per node, " << maxNumberOfVerticesPerLeaf << " vertices per leaf." << endl;
     } else {
+        cout << "Could not read the G-tree parameters from " << fileName << ". Using the default parameters." << endl;
+    }
+    file.close();
+}
+
+/*
+    Load the stored queries of the tuning. If they don't exist, random queries with a result are generated and stored, so every 
+    tuning of the data type uses the same queries.
+*/
+vector<MeetingPointQuery> GTreeController::loadOrCreateTuningQueries(DataType dataType, int numberOfSourceStops, int numberOfQueries) {
+    string numberOfSourceStopsString = to_string(numberOfSourceStops);
+    while (numberOfSourceStopsString.size() < 3) {
+        numberOfSourceStopsString = "0" + numberOfSourceStopsString;
+    }
+    string dataTypeString = Importer::getDataTypeString(dataType);
+    string filePath = FOLDER_PREFIX + "tests/" + dataTypeString + "/queries/meeting-point-query-" + numberOfSourceStopsString + "-" + to_string(numberOfQueries) + ".csv";
+
+    vector<MeetingPointQuery> meetingPointQueries;
+    ifstream file(filePath);
+    if (file.is_open()) {
+        string line;
+        while (getline(file, line) && meetingPointQueries.size() < numberOfQueries) {
+            meetingPointQueries.push_back(QueryGenerator::parseMeetingPointQuery(line, numberOfSourceStops));
+        }
         file.close();
-        GTree* gTree = Creator::createNetworkGTree(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf, false);
-        gTree->calculateBorderDistancesOfStopIds(stopIds);
-        gTree->exportTreeAsJson(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf, numberOfFiles);
-        return gTree;
+        return meetingPointQueries;
+    }
+
+    ofstream queriesFile(filePath, ofstream::out);
+    while (meetingPointQueries.size() < numberOfQueries) {
+        MeetingPointQuery meetingPointQuery = QueryGenerator::generateRandomMeetingPointQuery(numberOfSourceStops);
+
+        RaptorQueryProcessor raptorQueryProcessor = RaptorQueryProcessor(meetingPointQuery);
+        raptorQueryProcessor.processRaptorQuery();
+        MeetingPointQueryResult meetingPointQueryResult = raptorQueryProcessor.getMeetingPointQueryResult();
+        if (meetingPointQueryResult.meetingPointMinSum == "" || meetingPointQueryResult.meetingPointMinMax == "") {
+            continue;
+        }
+
+        meetingPointQueries.push_back(meetingPointQuery);
+        for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
+            queriesFile << Importer::getExternalStopId(meetingPointQuery.sourceStopIds[i]) << ",";
+        }
+        queriesFile << meetingPointQuery.sourceTime << "," << meetingPointQuery.weekday << "\n";
     }
+    queriesFile.close();
+    return meetingPointQueries;
 }
 
-void GTreeController::calculateBorderDistancesOfStopIdsAndExportTree(GTree* gTree, vector<int> stopIds, DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf, int numberOfFiles) {
-    gTree->calculateBorderDistancesOfStopIds(stopIds);
-    gTree->exportTreeAsJson(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf, numberOfFiles);
+/*
+    Check if the result is dominated by the other result. The build time, the memory and the query times should be small and the 
+    accuracy of the approximation large.
+*/
+bool GTreeController::isDominated(GTreeTuningResult &result, GTreeTuningResult &otherResult) {
+    double accuracy = (result.averageRunTimeAndAccuracy.averageAccuracyMinSum + result.averageRunTimeAndAccuracy.averageAccuracyMinMax) / 2;
+    double otherAccuracy = (otherResult.averageRunTimeAndAccuracy.averageAccuracyMinSum + otherResult.averageRunTimeAndAccuracy.averageAccuracyMinMax) / 2;
+
+    // the matrix build times are compared in thread seconds because the candidates of different batches got different numbers of threads
+    vector<double> costs = {result.structureBuildTimeInSeconds, result.matrixBuildTimeInSeconds * result.numberOfMatrixBuildThreads, result.memoryInMB, result.averageRunTimeAndAccuracy.averageRunTimeGTreeCSA, 
+        result.averageRunTimeAndAccuracy.averageRunTimeGTreeApproximation, -accuracy};
+    vector<double> otherCosts = {otherResult.structureBuildTimeInSeconds, otherResult.matrixBuildTimeInSeconds * otherResult.numberOfMatrixBuildThreads, otherResult.memoryInMB, otherResult.averageRunTimeAndAccuracy.averageRunTimeGTreeCSA, 
+        otherResult.averageRunTimeAndAccuracy.averageRunTimeGTreeApproximation, -otherAccuracy};
+
+    bool isBetterInOneCost = false;
+    for (int i = 0; i < costs.size(); i++) {
+        if (otherCosts[i] > costs[i]) {
+            return false;
+        }
+        if (otherCosts[i] < costs[i]) {
+            isBetterInOneCost = true;
+        }
+    }
+    return isBetterInOneCost;
+}
+
+/*
+    Tune the parameters of the G-tree. The structures of the candidates are created one after another with all threads. Afterwards 
+    the durations of several candidates are calculated at once as long as their matrices fit into the memory budget, the threads are 
+    split between them. Every candidate is evaluated on the same stored queries and deleted before the next candidates are calculated.
+    The pareto optimal candidate with the fastest csa queries is written to the parameter file that is used by the main program.
+*/
+void GTreeController::tuneGTreeParameters(DataType dataType, vector<int> numberOfChildrenPerNodeParams, vector<int> maxNumberOfVerticesPerLeafParams, int numberOfSourceStops, int numberOfQueries) {
+    vector<MeetingPointQuery> meetingPointQueries = loadOrCreateTuningQueries(dataType, numberOfSourceStops, numberOfQueries);
+
+    vector<int> stopIds = vector<int>(0);
+    for (int i = 0; i < Creator::networkGraph.vertices.size(); i++) {
+        stopIds.push_back(Creator::networkGraph.vertices[i].stopId);
+    }
+
+    int numberOfThreads = omp_get_max_threads();
+
+    vector<GTree*> gTrees;
+    vector<GTreeTuningResult> results;
+    for (int numberOfChildrenPerNode : numberOfChildrenPerNodeParams) {
+        for (int maxNumberOfVerticesPerLeaf : maxNumberOfVerticesPerLeafParams) {
+            auto start = std::chrono::high_resolution_clock::now();
+            GTree* gTree = Creator::createNetworkGTree(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf, false);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            GTreeTuningResult result;
+            result.numberOfChildrenPerNode = numberOfChildrenPerNode;
+            result.maxNumberOfVerticesPerLeaf = maxNumberOfVerticesPerLeaf;
+            result.structureBuildTimeInSeconds = std::chrono::duration<double>(end - start).count();
+            result.matrixBuildTimeInSeconds = 0;
+            result.numberOfMatrixBuildThreads = numberOfThreads;
+            result.memoryInMB = (double) gTree->getSizeOfDurationsInBytes() / 1000000;
+            result.isParetoOptimal = true;
+
+            // the matrices are allocated again when the candidate is calculated
+            for (int i = 0; i < gTree->nodes.size(); i++) {
+                vector<unsigned int>().swap(gTree->nodes[i].durations);
+            }
+
+            gTrees.push_back(gTree);
+            results.push_back(result);
+        }
+    }
+
+    int maxActiveLevels = omp_get_max_active_levels();
+    omp_set_max_active_levels(2);
+
+    int candidateIndex = 0;
+    while (candidateIndex < results.size()) {
+        vector<int> batch = vector<int>(0);
+        double memoryOfBatchInMB = 0;
+        while (candidateIndex < results.size() && batch.size() < numberOfThreads 
+            && (batch.size() == 0 || memoryOfBatchInMB + results[candidateIndex].memoryInMB <= GTREE_TUNING_MEMORY_BUDGET_IN_MB)) {
+            memoryOfBatchInMB += results[candidateIndex].memoryInMB;
+            batch.push_back(candidateIndex);
+            candidateIndex++;
+        }
+        int numberOfThreadsPerCandidate = max(1, numberOfThreads / (int) batch.size());
+
+        #pragma omp parallel for num_threads(batch.size()) schedule(dynamic)
+        for (int i = 0; i < batch.size(); i++) {
+            omp_set_num_threads(numberOfThreadsPerCandidate);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            GTree* gTree = gTrees[batch[i]];
+            for (int j = 0; j < gTree->nodes.size(); j++) {
+                gTree->nodes[j].initializeDurations();
+            }
+            gTree->calculateBorderDistancesOfStopIds(stopIds);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            results[batch[i]].matrixBuildTimeInSeconds = std::chrono::duration<double>(end - start).count();
+            results[batch[i]].numberOfMatrixBuildThreads = numberOfThreadsPerCandidate;
+        }
+
+        // the queries are measured one candidate after another to keep the query times comparable
+        for (int i = 0; i < batch.size(); i++) {
+            results[batch[i]].averageRunTimeAndAccuracy = GTreeAlgorithmTester::getAverageRunTimeAndAccuracy(gTrees[batch[i]], meetingPointQueries);
+            delete gTrees[batch[i]];
+            gTrees[batch[i]] = nullptr;
+        }
+    }
+
+    omp_set_max_active_levels(maxActiveLevels);
+
+    int bestResultIndex = -1;
+    for (int i = 0; i < results.size(); i++) {
+        for (int j = 0; j < results.size(); j++) {
+            if (i != j && isDominated(results[i], results[j])) {
+                results[i].isParetoOptimal = false;
+                break;
+            }
+        }
+        if (results[i].isParetoOptimal && (bestResultIndex == -1 
+            || results[i].averageRunTimeAndAccuracy.averageRunTimeGTreeCSA < results[bestResultIndex].averageRunTimeAndAccuracy.averageRunTimeGTreeCSA)) {
+            bestResultIndex = i;
+        }
+    }
+
+    string dataTypeString = Importer::getDataTypeString(dataType);
+    string paretoFileName = FOLDER_PREFIX + "tests/" + dataTypeString + "/gtree_params/gtree_pareto.csv";
+    ofstream paretoFile(paretoFileName, ofstream::out);
+    paretoFile << "numberOfChildrenPerNode,maxNumberOfVerticesPerLeaf,structureBuildTimeInSeconds,matrixBuildTimeInSeconds,numberOfMatrixBuildThreads,memoryInMB,avgQueryTimeCSA,avgQueryTimeApprox,avgAccuracyMinSum,avgAccuracyMinMax,isParetoOptimal\n";
+
+    cout << "\nG-tree parameters (children, leaf size, structure build time in s, matrix build time in s, matrix build threads, memory in MB, csa query time, approximation query time, accuracy min sum, accuracy min max):" << endl;
+    for (int i = 0; i < results.size(); i++) {
+        GTreeTuningResult &result = results[i];
+        stringstream row;
+        row << result.numberOfChildrenPerNode << "," << result.maxNumberOfVerticesPerLeaf << "," << result.structureBuildTimeInSeconds << "," << result.matrixBuildTimeInSeconds << "," << result.numberOfMatrixBuildThreads << "," << result.memoryInMB;
+        row << "," << result.averageRunTimeAndAccuracy.averageRunTimeGTreeCSA << "," << result.averageRunTimeAndAccuracy.averageRunTimeGTreeApproximation;
+        row << "," << result.averageRunTimeAndAccuracy.averageAccuracyMinSum << "," << result.averageRunTimeAndAccuracy.averageAccuracyMinMax;
+        paretoFile << row.str() << "," << result.isParetoOptimal << "\n";
+        cout << row.str() << (result.isParetoOptimal ? " (pareto optimal)" : "") << endl;
+    }
+    paretoFile.close();
+
+    if (bestResultIndex == -1) {
+        return;
+    }
+
+    ofstream parametersFile(getGTreeParametersFileName(dataType), ofstream::out);
+    parametersFile << "numberOfChildrenPerNode,maxNumberOfVerticesPerLeaf\n";
+    parametersFile << results[bestResultIndex].numberOfChildrenPerNode << "," << results[bestResultIndex].maxNumberOfVerticesPerLeaf << "\n";
+    parametersFile.close();
+
+    cout << "Chosen G-tree parameters: " << results[bestResultIndex].numberOfChildrenPerNode << " children per node, " << results[bestResultIndex].maxNumberOfVerticesPerLeaf << " vertices per leaf" << endl;
 }
\ No newline at end of file
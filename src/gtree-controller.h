@@ -4,6 +4,21 @@
 
 #include "data-handling/importer.h"
 #include "data-structures/g-tree.h"
+#include "meeting-point-algorithms/algorithm-tester.h"
+
+#include <vector>
+
+struct GTreeTuningResult {
+    int numberOfChildrenPerNode;
+    int maxNumberOfVerticesPerLeaf;
+    // the structure is created with all threads, the matrices with the threads that the candidate got in its batch
+    double structureBuildTimeInSeconds;
+    double matrixBuildTimeInSeconds;
+    int numberOfMatrixBuildThreads;
+    double memoryInMB;
+    AverageRunTimeAndAccuracy averageRunTimeAndAccuracy;
+    bool isParetoOptimal;
+};
 
 class GTreeController {
     public:
@@ -11,7 +26,14 @@ class GTreeController {
         ~GTreeController(){};
 
         static GTree* createOrLoadNetworkGTree(DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf); 
-        static void calculateBorderDistancesOfStopIdsAndExportTree(GTree* gTree, vector<int> stopIds, DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf, int numberOfFiles);
+        static void calculateBorderDistancesOfStopIdsAndExportTree(GTree* gTree, vector<int> stopIds, DataType dataType, int numberOfChildrenPerNode, int maxNumberOfVerticesPerLeaf);
+        static void loadGTreeParameters(DataType dataType, int &numberOfChildrenPerNode, int &maxNumberOfVerticesPerLeaf);
+        static void tuneGTreeParameters(DataType dataType, vector<int> numberOfChildrenPerNodeParams, vector<int> maxNumberOfVerticesPerLeafParams, int numberOfSourceStops, int numberOfQueries);
+
+    private:
+        static string getGTreeParametersFileName(DataType dataType);
+        static vector<MeetingPointQuery> loadOrCreateTuningQueries(DataType dataType, int numberOfSourceStops, int numberOfQueries);
+        static bool isDominated(GTreeTuningResult &result, GTreeTuningResult &otherResult);
 };
 
 #endif // CMAKE_GTREE_CONTROLLER_H
\ No newline at end of file
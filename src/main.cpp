@@ -36,6 +36,8 @@ int main(int argc, const char *argv[]) {
 
   bool startExperiments = false;
   bool runEatCli = false;
+  bool tuneGTree = false;
+  bool useGTree = false;
 
   if (argc > 1){
     if (strcmp(argv[1], "vvs") == 0){
@@ -60,6 +62,10 @@ int main(int argc, const char *argv[]) {
       startExperiments = true;
     } else if (strcmp(argv[2], "eat") == 0){
       runEatCli = true;
+    } else if (strcmp(argv[2], "tune") == 0){
+      tuneGTree = true;
+    } else if (strcmp(argv[2], "gtree") == 0){
+      useGTree = true;
     }
   }
 
@@ -88,6 +94,9 @@ int main(int argc, const char *argv[]) {
   if (USE_LANDMARKS) {
     LandmarkProcessor::loadOrCalculateLandmarkDurations(dataType, true);
   }
+  if (USE_SOURCE_PROFILES) {
+    SourceProfileProcessor::loadOrCalculateSourceProfiles(dataType);
+  }
 
   // print number of vertices and edges
   cout << "Number of vertices: " << Creator::networkGraph.vertices.size() << endl;
@@ -100,36 +109,38 @@ int main(int argc, const char *argv[]) {
   if (startExperiments){
     ExperimentController::evaluateLowerBounds(2500, 4);
 
+    ExperimentController::comparePhastImplementations({2, 10, 100, 1000});
+
+    ExperimentController::compareContractionHierarchieCreation(100);
+    ExperimentController::compareCustomizableCH(100);
+
     vector<int> numberOfSourceStops = {2, 3, 5, 7, 9, 10};
     ExperimentController::compareRaptorPQAlgorithms(dataType, 1000, numberOfSourceStops);
+
+    ExperimentController::compareWeightedObjectiveWithBruteForce(100, {2, 3, 5});
+    ExperimentController::compareSeparatedMeetingPointsWithBruteForce(100, {2, 3, 5});
+    ExperimentController::compareTimeLabels(100, {2, 10, 50});
     
     numberOfSourceStops = {25, 50, 75, 100, 150};
     ExperimentController::compareRaptorApproxAlgorithms(dataType, 100, numberOfSourceStops);
 
     numberOfSourceStops = {500, 1000};
     ExperimentController::testRaptorApproxAlgorithmForLargeNofSources(dataType, 100, numberOfSourceStops);
+  } else if (tuneGTree){
+    ExperimentController::findBestGTreeParameters(dataType, 3, 100);
   } else {
     
-    int numberOfChildrenPerNode;
-    int maxNumberOfVerticesPerLeaf;
-    if(dataType == vvs_j24){
-      numberOfChildrenPerNode = 4;
-      maxNumberOfVerticesPerLeaf = 64;
-    } else if (dataType == schienenfernverkehr_de) {
-      numberOfChildrenPerNode = 2;
-      maxNumberOfVerticesPerLeaf = 32;
-    } else if (dataType == schienenregionalverkehr_de || dataType == schienenfern_und_regionalverkehr_de) {
-      numberOfChildrenPerNode = 4;
-      maxNumberOfVerticesPerLeaf = 128;
-    } else if (dataType == gesamt_de) {
-      numberOfChildrenPerNode = 4;
-      maxNumberOfVerticesPerLeaf = 512;
-    }
-
-    // GTree* networkGTreePointer = GTreeController::createOrLoadNetworkGTree(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf);
-
     if (!runEatCli) {
-      CliController::runCli(dataType, nullptr);
+      // the G-tree is only loaded on request because its creation takes hours on the large data types
+      GTree* networkGTreePointer = nullptr;
+      if (useGTree) {
+        // the parameters of the last tuning, otherwise the defaults of the data type
+        int numberOfChildrenPerNode;
+        int maxNumberOfVerticesPerLeaf;
+        GTreeController::loadGTreeParameters(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf);
+        networkGTreePointer = GTreeController::createOrLoadNetworkGTree(dataType, numberOfChildrenPerNode, maxNumberOfVerticesPerLeaf);
+      }
+      CliController::runCli(dataType, networkGTreePointer);
     } else {
       CliController::runCliEat(dataType);
     }
@@ -7,6 +7,7 @@
 #include "journey.h"
 #include <../data-handling/importer.h>
 #include <../data-handling/converter.h>
+#include <../data-structures/creator.h>
 #include <../constants.h>
 
 #include <vector>
@@ -151,8 +152,8 @@ void RaptorEATAlgorithmTester::compareRaptorEATAlgorithms(DataType dataType, int
     vector<double> expandedRoutesRaptorBoundStar;
     vector<double> expandedRoutesRaptorPQStar;
 
-    double errorCounterRaptorBoundStar;
-    double errorCounterRaptorPQStar;
+    double errorCounterRaptorBoundStar = 0;
+    double errorCounterRaptorPQStar = 0;
 
     vector<double> lowerBoundSmallerCountRaptorBoundStar;
     vector<double> lowerBoundGreaterCountRaptorBoundStar;
@@ -227,7 +228,7 @@ void RaptorEATAlgorithmTester::compareRaptorEATAlgorithms(DataType dataType, int
             lowerBoundRelDiffRaptorPQStar.push_back((double) raptorStarPQQueryProcessor->lowerBoundRelDiff);
 
             if (loadOrStoreQueries && queriesInfoFile.is_open()) {
-                queriesInfoFile << raptorQuery.sourceStopId << "," << raptorQuery.targetStopIds[0] << "," << raptorQuery.sourceTime << "," << raptorQuery.weekday << "\n";
+                queriesInfoFile << Importer::getExternalStopId(raptorQuery.sourceStopId) << "," << Importer::getExternalStopId(raptorQuery.targetStopIds[0]) << "," << raptorQuery.sourceTime << "," << raptorQuery.weekday << "\n";
             }
 
             if (successfulQueryCounter % (numberOfSuccessfulQueries / 5) == 0) {
@@ -360,6 +361,72 @@ void RaptorEATAlgorithmTester::compareRaptorEATAlgorithms(DataType dataType, int
     cout << "\n\n";
 }
 
+void RaptorEATAlgorithmTester::testTDCHAlgorithm(RaptorQuery raptorQuery) {
+    unique_ptr<TDCHQueryEATProcessor> tdchQueryProcessor = unique_ptr<TDCHQueryEATProcessor>(new TDCHQueryEATProcessor(raptorQuery));
+    tdchQueryProcessor->processTDCHQuery();
+    RaptorQueryResult tdchQueryResult = tdchQueryProcessor->getRaptorQueryResult();
+
+    PrintHelperRaptor::printRaptorQuery(raptorQuery);
+    cout << "\nTime dependent CH query result: " << endl;
+    PrintHelperRaptor::printRaptorQueryResult(tdchQueryResult);
+}
+
+/*
+    Validate the time dependent contraction hierarchie with the stored earliest arrival queries. The arrival times are compared
+    with the results of raptor.
+*/
+void RaptorEATAlgorithmTester::compareRaptorAndTDCH(DataType dataType, int numberOfQueries) {
+    cout << "Comparing raptor and the time dependent contraction hierarchie..." << endl;
+
+    string dataTypeString = Importer::getDataTypeString(dataType);
+    string folderPathQueries = FOLDER_PREFIX + "tests/" + dataTypeString + "/queries-eat/";
+    string queriesFileName = folderPathQueries + "raptor-eat-queries-" + to_string(numberOfQueries) + ".csv";
+
+    std::ifstream file(queriesFileName);
+    if (!file.is_open()) {
+        cout << "Could not open file " << queriesFileName << endl;
+        return;
+    }
+
+    vector<RaptorQuery> raptorQueries;
+    std::string line;
+    while(std::getline(file, line)) {
+        raptorQueries.push_back(QueryGenerator::parseRaptorQuery(line));
+    }
+
+    // create the hierarchie before the time measurement
+    Creator::getTimeDependentGraph();
+
+    vector<double> queryTimesRaptor;
+    vector<double> queryTimesTDCH;
+    vector<double> settledVerticesTDCH;
+    int errorCounter = 0;
+
+    for (int i = 0; i < raptorQueries.size(); i++) {
+        unique_ptr<RaptorQueryEATProcessor> raptorQueryProcessor = unique_ptr<RaptorQueryEATProcessor>(new RaptorQueryEATProcessor(raptorQueries[i]));
+        raptorQueryProcessor->processRaptorQuery();
+        RaptorQueryResult raptorQueryResult = raptorQueryProcessor->getRaptorQueryResult();
+
+        unique_ptr<TDCHQueryEATProcessor> tdchQueryProcessor = unique_ptr<TDCHQueryEATProcessor>(new TDCHQueryEATProcessor(raptorQueries[i]));
+        tdchQueryProcessor->processTDCHQuery();
+        RaptorQueryResult tdchQueryResult = tdchQueryProcessor->getRaptorQueryResult();
+
+        queryTimesRaptor.push_back(raptorQueryResult.queryTime);
+        queryTimesTDCH.push_back(tdchQueryResult.queryTime);
+        settledVerticesTDCH.push_back((double) tdchQueryProcessor->numberOfSettledVertices);
+
+        if (raptorQueryResult.arrivalTime != tdchQueryResult.arrivalTime || raptorQueryResult.durationInSeconds != tdchQueryResult.durationInSeconds) {
+            errorCounter++;
+        }
+    }
+
+    cout << "Number of queries: " << raptorQueries.size() << endl;
+    cout << "Wrong results fraction time dependent CH: " << (double) errorCounter / raptorQueries.size() << endl;
+    cout << "Average query time Raptor: " << Calculator::getAverage(queryTimesRaptor) << " ms" << endl;
+    cout << "Average query time time dependent CH: " << Calculator::getAverage(queryTimesTDCH) << " ms" << endl;
+    cout << "Average settled vertices time dependent CH: " << Calculator::getAverage(settledVerticesTDCH) << "\n" << endl;
+}
+
 void PrintHelperRaptor::printRaptorQuery(RaptorQuery raptorQuery) {
     cout << "\nRaptor query: " << endl;
     cout << "Source stop: " << Importer::getStopName(raptorQuery.sourceStopId) << endl;
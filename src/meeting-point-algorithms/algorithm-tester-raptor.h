@@ -19,6 +19,8 @@ class RaptorEATAlgorithmTester {
         static void testRaptorStarBoundAlgorithm(RaptorQuery raptorQuery, bool printJourney);
         static void testRaptorStarPQAlgorithm(RaptorQuery raptorQuery, bool printJourney);
         static void compareRaptorEATAlgorithms(DataType dataType, int numberOfSuccessfulQueries, bool loadOrStoreQueries);
+        static void testTDCHAlgorithm(RaptorQuery raptorQuery);
+        static void compareRaptorAndTDCH(DataType dataType, int numberOfQueries);
 };
 
 class PrintHelperRaptor {
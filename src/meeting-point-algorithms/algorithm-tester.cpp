@@ -3,14 +3,19 @@
 #include "query-processor.h"
 #include "journey.h"
 #include "optimization.h"
+#include "landmark-processor.h"
 #include <../data-handling/importer.h>
 #include <../data-handling/converter.h>
+#include <../data-handling/calculator.h>
 #include <../data-structures/g-tree.h>
+#include <../data-structures/creator.h>
 #include <../constants.h>
 #include <algorithm>
 #include <memory>
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include <omp.h>
 
 
 using namespace std;
@@ -24,7 +29,7 @@ void NaiveAlgorithmTester::testNaiveAlgorithmRandom(int numberOfSuccessfulQuerie
         MeetingPointQuery meetingPointQuery = QueryGenerator::generateRandomMeetingPointQuery(numberOfSources);
         
         NaiveQueryProcessor naiveQueryProcessor = NaiveQueryProcessor(meetingPointQuery);
-        naiveQueryProcessor.processNaiveQuery();
+        naiveQueryProcessor.processNaiveQuery(USE_SOURCE_PROFILES);
         MeetingPointQueryResult meetingPointQueryResult = naiveQueryProcessor.getMeetingPointQueryResult();
 
         if (meetingPointQueryResult.meetingPointMinSum == "" || meetingPointQueryResult.meetingPointMinMax == "") {
@@ -51,7 +56,7 @@ void NaiveAlgorithmTester::testNaiveAlgorithm(MeetingPointQuery meetingPointQuer
     PrintHelper::printMeetingPointQuery(meetingPointQuery);
 
     NaiveQueryProcessor naiveQueryProcessor = NaiveQueryProcessor(meetingPointQuery);
-    naiveQueryProcessor.processNaiveQuery();
+    naiveQueryProcessor.processNaiveQuery(USE_SOURCE_PROFILES);
     MeetingPointQueryResult meetingPointQueryResult = naiveQueryProcessor.getMeetingPointQueryResult();
     
     PrintHelper::printMeetingPointQueryResult(meetingPointQueryResult);
@@ -85,7 +90,7 @@ void NaiveKeyStopAlgorithmTester::testNaiveKeyStopAlgorithmRandom(DataType dataT
         MeetingPointQuery meetingPointQuery = QueryGenerator::generateRandomMeetingPointQuery(numberOfSources);
         
         NaiveKeyStopQueryProcessor naiveKeyStopQueryProcessor = NaiveKeyStopQueryProcessor(meetingPointQuery);
-        naiveKeyStopQueryProcessor.processNaiveKeyStopQuery(keyStops);
+        naiveKeyStopQueryProcessor.processNaiveKeyStopQuery(keyStops, USE_SOURCE_PROFILES);
         MeetingPointQueryResult meetingPointQueryResult = naiveKeyStopQueryProcessor.getMeetingPointQueryResult();
 
         if (meetingPointQueryResult.meetingPointMinSum == "" || meetingPointQueryResult.meetingPointMinMax == "") {
@@ -114,7 +119,7 @@ void NaiveKeyStopAlgorithmTester::testNaiveKeyStopAlgorithm(DataType dataType, M
     vector<int> keyStops = NaiveKeyStopQueryProcessor::getKeyStops(dataType, meetingPointQuery.sourceStopIds.size());
 
     NaiveKeyStopQueryProcessor naiveKeyStopQueryProcessor = NaiveKeyStopQueryProcessor(meetingPointQuery);
-    naiveKeyStopQueryProcessor.processNaiveKeyStopQuery(keyStops);
+    naiveKeyStopQueryProcessor.processNaiveKeyStopQuery(keyStops, USE_SOURCE_PROFILES);
     MeetingPointQueryResult meetingPointQueryResult = naiveKeyStopQueryProcessor.getMeetingPointQueryResult();
     
     PrintHelper::printMeetingPointQueryResult(meetingPointQueryResult);
@@ -169,6 +174,10 @@ void GTreeAlgorithmTester::testGTreeAlgorithmRandom(GTree* gTree, bool useCSA, i
     double rateOfSuccessfulQueries = (double) successfulQueryCounter / numberOfSuccessfulQueries;
 
     cout << "Rate of successful queries: " << rateOfSuccessfulQueries << endl;
+
+    if (gTree->isMapped()) {
+        gTree->printNodeCacheStatistics();
+    }
 }
 
 /*
@@ -261,6 +270,51 @@ AverageRunTimeAndAccuracy GTreeAlgorithmTester::getAverageRunTimeAndAccuracy(Dat
     return averageRunTimeAndAccuracy;
 }
 
+/*
+    Execute the g-tree csa and approximation algorithm for a stored set of queries and return the average runtime and accuracy. Queries 
+    without a result are skipped, so different trees are compared on the same queries.
+*/
+AverageRunTimeAndAccuracy GTreeAlgorithmTester::getAverageRunTimeAndAccuracy(GTree* gTree, vector<MeetingPointQuery> &meetingPointQueries) {
+    vector<double> queryTimesCSA;
+    vector<double> queryTimesApproximation;
+    vector<double> accuracyMinSum;
+    vector<double> accuracyMinMax;
+
+    for (int i = 0; i < meetingPointQueries.size(); i++) {
+        GTreeQueryProcessor gTreeQueryProcessorCSA = GTreeQueryProcessor(meetingPointQueries[i], gTree);
+        gTreeQueryProcessorCSA.processGTreeQuery(true);
+        MeetingPointQueryResult meetingPointQueryResultGTreeCSA = gTreeQueryProcessorCSA.getMeetingPointQueryResult();
+
+        GTreeQueryProcessor gTreeQueryProcessorApproximation = GTreeQueryProcessor(meetingPointQueries[i], gTree);
+        gTreeQueryProcessorApproximation.processGTreeQuery();
+        MeetingPointQueryResult meetingPointQueryResultApprox = gTreeQueryProcessorApproximation.getMeetingPointQueryResult();
+
+        bool gTreeCSAQuerySuccessful = meetingPointQueryResultGTreeCSA.meetingPointMinSum != "" && meetingPointQueryResultGTreeCSA.meetingPointMinMax != "";
+        bool gTreeApproximationQuerySuccessful = meetingPointQueryResultApprox.meetingPointMinSum != "" && meetingPointQueryResultApprox.meetingPointMinMax != "";
+
+        if (!gTreeCSAQuerySuccessful || !gTreeApproximationQuerySuccessful) {
+            continue;
+        }
+
+        queryTimesCSA.push_back((double) meetingPointQueryResultGTreeCSA.queryTime);
+        queryTimesApproximation.push_back((double) meetingPointQueryResultApprox.queryTime);
+
+        int differenceMinSum = meetingPointQueryResultApprox.minSumDurationInSeconds - meetingPointQueryResultGTreeCSA.minSumDurationInSeconds;
+        int differenceMinMax = meetingPointQueryResultApprox.minMaxDurationInSeconds - meetingPointQueryResultGTreeCSA.minMaxDurationInSeconds;
+
+        accuracyMinSum.push_back(1 - (double) differenceMinSum / meetingPointQueryResultApprox.minSumDurationInSeconds);
+        accuracyMinMax.push_back(1 - (double) differenceMinMax / meetingPointQueryResultApprox.minMaxDurationInSeconds);
+    }
+
+    AverageRunTimeAndAccuracy averageRunTimeAndAccuracy;
+    averageRunTimeAndAccuracy.averageRunTimeGTreeCSA = Calculator::getAverage(queryTimesCSA);
+    averageRunTimeAndAccuracy.averageRunTimeGTreeApproximation = Calculator::getAverage(queryTimesApproximation);
+    averageRunTimeAndAccuracy.averageAccuracyMinSum = Calculator::getAverage(accuracyMinSum);
+    averageRunTimeAndAccuracy.averageAccuracyMinMax = Calculator::getAverage(accuracyMinMax);
+
+    return averageRunTimeAndAccuracy;
+}
+
 void RaptorAlgorithmTester::testRaptorAlgorithmRandom(int numberOfSuccessfulQueries, int numberOfSources, bool printOnlySuccessful) {
     int successfulQueryCounter = 0;
     for (int i = 0; i < numberOfSuccessfulQueries; i++) {
@@ -645,7 +699,7 @@ void RaptorAlgorithmTester::compareRaptorAlgorithms(DataType dataType, int numbe
 
             if (loadOrStoreQueries && meetingPointQueries.size() == 0) {
                 for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-                    queriesInfoFile << meetingPointQuery.sourceStopIds[i] << ",";
+                    queriesInfoFile << Importer::getExternalStopId(meetingPointQuery.sourceStopIds[i]) << ",";
                 }
                 queriesInfoFile << meetingPointQuery.sourceTime << "," << meetingPointQuery.weekday << "\n";
             }
@@ -855,20 +909,25 @@ void RaptorAlgorithmTester::compareRaptorAlgorithms(DataType dataType, int numbe
     }  
 }
 
-void RaptorPQAlgorithmTester::testRaptorPQAlgorithm(MeetingPointQuery meetingPointQuery, bool printJourneys) {
+void RaptorPQAlgorithmTester::testRaptorPQAlgorithm(MeetingPointQuery meetingPointQuery, bool printJourneys, bool useWorkStealing, int numberOfMeetingPoints, double minimumDistance) {
     PrintHelper::printMeetingPointQuery(meetingPointQuery);
 
     RaptorPQQueryProcessor raptorPQQueryProcessorMinSum = RaptorPQQueryProcessor(meetingPointQuery);
-    raptorPQQueryProcessorMinSum.processRaptorPQQuery(min_sum);
+    raptorPQQueryProcessorMinSum.processRaptorPQQuery(min_sum, useWorkStealing, numberOfMeetingPoints, minimumDistance);
     MeetingPointQueryResult meetingPointQueryResultMinSum = raptorPQQueryProcessorMinSum.getMeetingPointQueryResult();
 
     RaptorPQQueryProcessor raptorPQQueryProcessorMinMax = RaptorPQQueryProcessor(meetingPointQuery);
-    raptorPQQueryProcessorMinMax.processRaptorPQQuery(min_max);
+    raptorPQQueryProcessorMinMax.processRaptorPQQuery(min_max, useWorkStealing, numberOfMeetingPoints, minimumDistance);
     MeetingPointQueryResult meetingPointQueryResultMinMax = raptorPQQueryProcessorMinMax.getMeetingPointQueryResult();
     
     PrintHelper::printMeetingPointQueryResultOfOptimization(meetingPointQueryResultMinSum, min_sum);
     PrintHelper::printMeetingPointQueryResultOfOptimization(meetingPointQueryResultMinMax, min_max);
 
+    if (numberOfMeetingPoints > 1) {
+        PrintHelper::printBestMeetingPoints(raptorPQQueryProcessorMinSum.getBestMeetingPoints(), min_sum);
+        PrintHelper::printBestMeetingPoints(raptorPQQueryProcessorMinMax.getBestMeetingPoints(), min_max);
+    }
+
     bool querySuccessful = meetingPointQueryResultMinSum.meetingPointMinSum != "" && meetingPointQueryResultMinMax.meetingPointMinMax != "";
 
     if (querySuccessful && printJourneys) {
@@ -909,6 +968,11 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
     resultsFile << ",avgNumberOfWrongResultsRaptorPQMinSum,avgNumberOfWrongResultsRaptorPQMinMax";
     resultsFile << ",avgNumberOfWrongResultsRaptorBoundMinSum,avgNumberOfWrongResultsRaptorBoundMinMax";
 
+    resultsFile << ",avgQueryTimeRaptorPQWorkStealingMinSum,avgQueryTimeRaptorPQWorkStealingMinMax,medianQueryTimeRaptorPQWorkStealingMinSum,medianQueryTimeRaptorPQWorkStealingMinMax";
+    resultsFile << ",maxQueryTimeRaptorPQWorkStealingMinSum,maxQueryTimeRaptorPQWorkStealingMinMax,minQueryTimeRaptorPQWorkStealingMinSum,minQueryTimeRaptorPQWorkStealingMinMax";
+    resultsFile << ",avgNumberOfWrongResultsRaptorPQWorkStealingMinSum,avgNumberOfWrongResultsRaptorPQWorkStealingMinMax";
+    resultsFile << ",numberOfThreads,speedupRaptorPQWorkStealingMinSum,speedupRaptorPQWorkStealingMinMax";
+
     resultsFile << ",avgNumberOfExpandedRoutesRaptorFirst,avgNumberOfExpandedRoutesRaptorOptimalResult,avgNumberOfExpandedRoutesRaptorPQMinSum,avgNumberOfExpandedRoutesRaptorPQMinMax,avgNumberOfExpandedRoutesRaptorPQParallelMinSum,avgNumberOfExpandedRoutesRaptorPQParallelMinMax,avgNumberOfExpandedRoutesRaptorBoundMinSum,avgNumberOfExpandedRoutesRaptorBoundMinMax";
     resultsFile << ",medianNumberOfExpandedRoutesRaptorFirst,medianNumberOfExpandedRoutesRaptorOptimalResult,medianNumberOfExpandedRoutesRaptorPQMinSum,medianNumberOfExpandedRoutesRaptorPQMinMax,medianNumberOfExpandedRoutesRaptorPQParallelMinSum,medianNumberOfExpandedRoutesRaptorPQParallelMinMax,medianNumberOfExpandedRoutesRaptorBoundMinSum,medianNumberOfExpandedRoutesRaptorBoundMinMax";
     resultsFile << ",maxNumberOfExpandedRoutesRaptorFirst,maxNumberOfExpandedRoutesRaptorOptimalResult,maxNumberOfExpandedRoutesRaptorPQMinSum,maxNumberOfExpandedRoutesRaptorPQMinMax,maxNumberOfExpandedRoutesRaptorPQParallelMinSum,maxNumberOfExpandedRoutesRaptorPQParallelMinMax,maxNumberOfExpandedRoutesRaptorBoundMinSum,maxNumberOfExpandedRoutesRaptorBoundMinMax";
@@ -994,9 +1058,13 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
         vector<double> queryTimesRaptorPQParallelMinMax;
         vector<double> queryTimesRaptorBoundMinSum;
         vector<double> queryTimesRaptorBoundMinMax;
+        vector<double> queryTimesRaptorPQWorkStealingMinSum;
+        vector<double> queryTimesRaptorPQWorkStealingMinMax;
 
         double raptorPQMinSumErrorsCounter = 0;
         double raptorPQMinMaxErrorsCounter = 0;
+        double raptorPQWorkStealingMinSumErrorsCounter = 0;
+        double raptorPQWorkStealingMinMaxErrorsCounter = 0;
         double raptorBoundMinSumErrorsCounter = 0;
         double raptorBoundMinMaxErrorsCounter = 0;
 
@@ -1131,6 +1199,14 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
                 raptorPQMinMaxQueryProcessor->processRaptorPQQuery(min_max);
                 MeetingPointQueryResult meetingPointQueryResultRaptorPQMinMax = raptorPQMinMaxQueryProcessor->getMeetingPointQueryResult();
 
+                unique_ptr<RaptorPQQueryProcessor> raptorPQWorkStealingMinSumQueryProcessor = unique_ptr<RaptorPQQueryProcessor> (new RaptorPQQueryProcessor(meetingPointQuery));
+                raptorPQWorkStealingMinSumQueryProcessor->processRaptorPQQuery(min_sum, true);
+                MeetingPointQueryResult meetingPointQueryResultRaptorPQWorkStealingMinSum = raptorPQWorkStealingMinSumQueryProcessor->getMeetingPointQueryResult();
+
+                unique_ptr<RaptorPQQueryProcessor> raptorPQWorkStealingMinMaxQueryProcessor = unique_ptr<RaptorPQQueryProcessor> (new RaptorPQQueryProcessor(meetingPointQuery));
+                raptorPQWorkStealingMinMaxQueryProcessor->processRaptorPQQuery(min_max, true);
+                MeetingPointQueryResult meetingPointQueryResultRaptorPQWorkStealingMinMax = raptorPQWorkStealingMinMaxQueryProcessor->getMeetingPointQueryResult();
+
                 // unique_ptr<RaptorPQParallelQueryProcessor> raptorPQParallelMinSumQueryProcessor = unique_ptr<RaptorPQParallelQueryProcessor> (new RaptorPQParallelQueryProcessor(meetingPointQuery));
                 // raptorPQParallelMinSumQueryProcessor->processRaptorPQParallelQuery(min_sum);
                 // MeetingPointQueryResult meetingPointQueryResultRaptorPQParallelMinSum = raptorPQParallelMinSumQueryProcessor->getMeetingPointQueryResult();
@@ -1158,6 +1234,8 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
                 // queryTimesRaptorPQParallelMinMax.push_back((double) meetingPointQueryResultRaptorPQParallelMinMax.queryTime);
                 queryTimesRaptorBoundMinSum.push_back((double) meetingPointQueryResultRaptorBoundMinSum.queryTime);
                 queryTimesRaptorBoundMinMax.push_back((double) meetingPointQueryResultRaptorBoundMinMax.queryTime);
+                queryTimesRaptorPQWorkStealingMinSum.push_back((double) meetingPointQueryResultRaptorPQWorkStealingMinSum.queryTime);
+                queryTimesRaptorPQWorkStealingMinMax.push_back((double) meetingPointQueryResultRaptorPQWorkStealingMinMax.queryTime);
 
                 if(meetingPointQueryResultRaptorOptimal.minSumDurationInSeconds != meetingPointQueryResultRaptorPQMinSum.minSumDurationInSeconds) {
                     raptorPQMinSumErrorsCounter++;
@@ -1167,6 +1245,14 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
                     raptorPQMinMaxErrorsCounter++;
                 }
 
+                if(meetingPointQueryResultRaptorOptimal.minSumDurationInSeconds != meetingPointQueryResultRaptorPQWorkStealingMinSum.minSumDurationInSeconds) {
+                    raptorPQWorkStealingMinSumErrorsCounter++;
+                }
+
+                if(meetingPointQueryResultRaptorOptimal.minMaxDurationInSeconds != meetingPointQueryResultRaptorPQWorkStealingMinMax.minMaxDurationInSeconds) {
+                    raptorPQWorkStealingMinMaxErrorsCounter++;
+                }
+
                 if(meetingPointQueryResultRaptorOptimal.minSumDurationInSeconds != meetingPointQueryResultRaptorBoundMinSum.minSumDurationInSeconds) {
                     raptorBoundMinSumErrorsCounter++;
                 }
@@ -1301,7 +1387,7 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
 
                 if (loadOrStoreQueries && meetingPointQueries.size() == 0) {
                     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-                        queriesInfoFile << meetingPointQuery.sourceStopIds[i] << ",";
+                        queriesInfoFile << Importer::getExternalStopId(meetingPointQuery.sourceStopIds[i]) << ",";
                     }
                     queriesInfoFile << meetingPointQuery.sourceTime << "," << meetingPointQuery.weekday << "\n";
                 }
@@ -1333,6 +1419,8 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
         double avgNumberOfWrongResultsRaptorPQMinMax = (double) raptorPQMinMaxErrorsCounter / numberOfSuccessfulQueries;
         double avgNumberOfWrongResultsRaptorBoundMinSum = (double) raptorBoundMinSumErrorsCounter / numberOfSuccessfulQueries;
         double avgNumberOfWrongResultsRaptorBoundMinMax = (double) raptorBoundMinMaxErrorsCounter / numberOfSuccessfulQueries;
+        double avgNumberOfWrongResultsRaptorPQWorkStealingMinSum = (double) raptorPQWorkStealingMinSumErrorsCounter / numberOfSuccessfulQueries;
+        double avgNumberOfWrongResultsRaptorPQWorkStealingMinMax = (double) raptorPQWorkStealingMinMaxErrorsCounter / numberOfSuccessfulQueries;
 
         double avgNumberOfExpandedRoutesRaptorFirst = Calculator::getAverage(numberOfExpandedRoutesRaptorFirst);
         double avgNumberOfExpandedRoutesRaptorOptimalResult = Calculator::getAverage(numberOfExpandedRoutesRaptorOptimalResult);
@@ -1449,6 +1537,19 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
         double minQueryTimeRaptorPQParallelMinMax = Calculator::getMinimum(queryTimesRaptorPQParallelMinMax);
         double minQueryTimeRaptorBoundMinSum = Calculator::getMinimum(queryTimesRaptorBoundMinSum);
         double minQueryTimeRaptorBoundMinMax = Calculator::getMinimum(queryTimesRaptorBoundMinMax);
+        double avgQueryTimeRaptorPQWorkStealingMinSum = Calculator::getAverage(queryTimesRaptorPQWorkStealingMinSum);
+        double avgQueryTimeRaptorPQWorkStealingMinMax = Calculator::getAverage(queryTimesRaptorPQWorkStealingMinMax);
+        double medianQueryTimeRaptorPQWorkStealingMinSum = Calculator::getMedian(queryTimesRaptorPQWorkStealingMinSum);
+        double medianQueryTimeRaptorPQWorkStealingMinMax = Calculator::getMedian(queryTimesRaptorPQWorkStealingMinMax);
+        double maxQueryTimeRaptorPQWorkStealingMinSum = Calculator::getMaximum(queryTimesRaptorPQWorkStealingMinSum);
+        double maxQueryTimeRaptorPQWorkStealingMinMax = Calculator::getMaximum(queryTimesRaptorPQWorkStealingMinMax);
+        double minQueryTimeRaptorPQWorkStealingMinSum = Calculator::getMinimum(queryTimesRaptorPQWorkStealingMinSum);
+        double minQueryTimeRaptorPQWorkStealingMinMax = Calculator::getMinimum(queryTimesRaptorPQWorkStealingMinMax);
+
+        // the speedup of work stealing over the sequential raptor pq, also with fewer sources than threads
+        int numberOfThreads = omp_get_max_threads();
+        double speedupRaptorPQWorkStealingMinSum = avgQueryTimeRaptorPQMinSum / avgQueryTimeRaptorPQWorkStealingMinSum;
+        double speedupRaptorPQWorkStealingMinMax = avgQueryTimeRaptorPQMinMax / avgQueryTimeRaptorPQWorkStealingMinMax;
 
         double avgAlternativeHeuristicImprovementCounter = Calculator::getAverage(alternativeHeuristicImprovementCounter);
         double avgAlternativeHeuristicNoImprovementCounter = Calculator::getAverage(alternativeHeuristicNoImprovementCounter);
@@ -1512,6 +1613,10 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
         resultsFile << "," << minQueryTimeRaptorFirst << "," << minQueryTimeRaptorOptimalResult << "," << minQueryTimeRaptorPQMinSum << "," << minQueryTimeRaptorPQMinMax << "," << minQueryTimeRaptorPQParallelMinSum << "," << minQueryTimeRaptorPQParallelMinMax << "," << minQueryTimeRaptorBoundMinSum << "," << minQueryTimeRaptorBoundMinMax;
         resultsFile << "," << avgNumberOfWrongResultsRaptorPQMinSum << "," << avgNumberOfWrongResultsRaptorPQMinMax;
         resultsFile << "," << avgNumberOfWrongResultsRaptorBoundMinSum << "," << avgNumberOfWrongResultsRaptorBoundMinMax;
+        resultsFile << "," << avgQueryTimeRaptorPQWorkStealingMinSum << "," << avgQueryTimeRaptorPQWorkStealingMinMax << "," << medianQueryTimeRaptorPQWorkStealingMinSum << "," << medianQueryTimeRaptorPQWorkStealingMinMax;
+        resultsFile << "," << maxQueryTimeRaptorPQWorkStealingMinSum << "," << maxQueryTimeRaptorPQWorkStealingMinMax << "," << minQueryTimeRaptorPQWorkStealingMinSum << "," << minQueryTimeRaptorPQWorkStealingMinMax;
+        resultsFile << "," << avgNumberOfWrongResultsRaptorPQWorkStealingMinSum << "," << avgNumberOfWrongResultsRaptorPQWorkStealingMinMax;
+        resultsFile << "," << numberOfThreads << "," << speedupRaptorPQWorkStealingMinSum << "," << speedupRaptorPQWorkStealingMinMax;
         resultsFile << "," << avgNumberOfExpandedRoutesRaptorFirst << "," << avgNumberOfExpandedRoutesRaptorOptimalResult << "," << avgNumberOfExpandedRoutesRaptorPQMinSum << "," << avgNumberOfExpandedRoutesRaptorPQMinMax << "," << avgNumberOfExpandedRoutesRaptorPQParallelMinSum << "," << avgNumberOfExpandedRoutesRaptorPQParallelMinMax << "," << avgNumberOfExpandedRoutesRaptorBoundMinSum << "," << avgNumberOfExpandedRoutesRaptorBoundMinMax;
         resultsFile << "," << medianNumberOfExpandedRoutesRaptorFirst << "," << medianNumberOfExpandedRoutesRaptorOptimalResult << "," << medianNumberOfExpandedRoutesRaptorPQMinSum << "," << medianNumberOfExpandedRoutesRaptorPQMinMax << "," << medianNumberOfExpandedRoutesRaptorPQParallelMinSum << "," << medianNumberOfExpandedRoutesRaptorPQParallelMinMax << "," << medianNumberOfExpandedRoutesRaptorBoundMinSum << "," << medianNumberOfExpandedRoutesRaptorBoundMinMax;
         resultsFile << "," << maxNumberOfExpandedRoutesRaptorFirst << "," << maxNumberOfExpandedRoutesRaptorOptimalResult << "," << maxNumberOfExpandedRoutesRaptorPQMinSum << "," << maxNumberOfExpandedRoutesRaptorPQMinMax << "," << maxNumberOfExpandedRoutesRaptorPQParallelMinSum << "," << maxNumberOfExpandedRoutesRaptorPQParallelMinMax << "," << maxNumberOfExpandedRoutesRaptorBoundMinSum << "," << maxNumberOfExpandedRoutesRaptorBoundMinMax;
@@ -1585,6 +1690,19 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
         cout << "Average number of errors raptor bound min sum: " << avgNumberOfWrongResultsRaptorBoundMinSum << endl;
         cout << "Average number of errors raptor bound min max: " << avgNumberOfWrongResultsRaptorBoundMinMax << endl;
 
+        cout << "\nAverage query time raptor pq work stealing min sum: " << avgQueryTimeRaptorPQWorkStealingMinSum << endl;
+        cout << "Average query time raptor pq work stealing min max: " << avgQueryTimeRaptorPQWorkStealingMinMax << endl;
+        cout << "Median query time raptor pq work stealing min sum: " << medianQueryTimeRaptorPQWorkStealingMinSum << endl;
+        cout << "Median query time raptor pq work stealing min max: " << medianQueryTimeRaptorPQWorkStealingMinMax << endl;
+        cout << "Max query time raptor pq work stealing min sum: " << maxQueryTimeRaptorPQWorkStealingMinSum << endl;
+        cout << "Max query time raptor pq work stealing min max: " << maxQueryTimeRaptorPQWorkStealingMinMax << endl;
+        cout << "Min query time raptor pq work stealing min sum: " << minQueryTimeRaptorPQWorkStealingMinSum << endl;
+        cout << "Min query time raptor pq work stealing min max: " << minQueryTimeRaptorPQWorkStealingMinMax << endl;
+        cout << "Average number of errors raptor pq work stealing min sum: " << avgNumberOfWrongResultsRaptorPQWorkStealingMinSum << endl;
+        cout << "Average number of errors raptor pq work stealing min max: " << avgNumberOfWrongResultsRaptorPQWorkStealingMinMax << endl;
+        cout << "Speedup raptor pq work stealing min sum with " << numberOfThreads << " threads: " << speedupRaptorPQWorkStealingMinSum << endl;
+        cout << "Speedup raptor pq work stealing min max with " << numberOfThreads << " threads: " << speedupRaptorPQWorkStealingMinMax << endl;
+
         cout << "\nAverage number of expanded routes raptor first: " << avgNumberOfExpandedRoutesRaptorFirst << endl;
         cout << "Average number of expanded routes raptor optimal result: " << avgNumberOfExpandedRoutesRaptorOptimalResult << endl;
         cout << "Average number of expanded routes raptor pq min sum: " << avgNumberOfExpandedRoutesRaptorPQMinSum << endl;
@@ -1722,20 +1840,25 @@ void RaptorPQAlgorithmTester::compareRaptorPQAlgorithms(DataType dataType, int n
     }  
 }
 
-void RaptorBoundAlgorithmTester::testRaptorBoundAlgorithm(MeetingPointQuery meetingPointQuery, bool printJourneys) {
+void RaptorBoundAlgorithmTester::testRaptorBoundAlgorithm(MeetingPointQuery meetingPointQuery, bool printJourneys, int numberOfMeetingPoints, double minimumDistance) {
     PrintHelper::printMeetingPointQuery(meetingPointQuery);
 
     RaptorBoundQueryProcessor raptorBoundQueryProcessorMinSum = RaptorBoundQueryProcessor(meetingPointQuery);
-    raptorBoundQueryProcessorMinSum.processRaptorBoundQuery(min_sum);
+    raptorBoundQueryProcessorMinSum.processRaptorBoundQuery(min_sum, numberOfMeetingPoints, minimumDistance);
     MeetingPointQueryResult meetingPointQueryResultMinSum = raptorBoundQueryProcessorMinSum.getMeetingPointQueryResult();
 
     RaptorBoundQueryProcessor raptorBoundQueryProcessorMinMax = RaptorBoundQueryProcessor(meetingPointQuery);
-    raptorBoundQueryProcessorMinMax.processRaptorBoundQuery(min_max);
+    raptorBoundQueryProcessorMinMax.processRaptorBoundQuery(min_max, numberOfMeetingPoints, minimumDistance);
     MeetingPointQueryResult meetingPointQueryResultMinMax = raptorBoundQueryProcessorMinMax.getMeetingPointQueryResult();
     
     PrintHelper::printMeetingPointQueryResultOfOptimization(meetingPointQueryResultMinSum, min_sum);
     PrintHelper::printMeetingPointQueryResultOfOptimization(meetingPointQueryResultMinMax, min_max);
 
+    if (numberOfMeetingPoints > 1) {
+        PrintHelper::printBestMeetingPoints(raptorBoundQueryProcessorMinSum.getBestMeetingPoints(), min_sum);
+        PrintHelper::printBestMeetingPoints(raptorBoundQueryProcessorMinMax.getBestMeetingPoints(), min_max);
+    }
+
     bool querySuccessful = meetingPointQueryResultMinSum.meetingPointMinSum != "" && meetingPointQueryResultMinMax.meetingPointMinMax != "";
 
     if (querySuccessful && printJourneys) {
@@ -2081,7 +2204,7 @@ void RaptorApproximationAlgorithmTester::compareRaptorApproximationAlgorithms(Da
 
                 if (loadOrStoreQueries && meetingPointQueries.size() == 0) {
                     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-                        queriesInfoFile << meetingPointQuery.sourceStopIds[i] << ",";
+                        queriesInfoFile << Importer::getExternalStopId(meetingPointQuery.sourceStopIds[i]) << ",";
                     }
                     queriesInfoFile << meetingPointQuery.sourceTime << "," << meetingPointQuery.weekday << "\n";
                 }
@@ -2472,7 +2595,7 @@ void RaptorApproximationAlgorithmTester::testRaptorApproximationAlgorithmForLarg
 
                 if (loadOrStoreQueries && meetingPointQueries.size() == 0) {
                     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-                        queriesInfoFile << meetingPointQuery.sourceStopIds[i] << ",";
+                        queriesInfoFile << Importer::getExternalStopId(meetingPointQuery.sourceStopIds[i]) << ",";
                     }
                     queriesInfoFile << meetingPointQuery.sourceTime << "," << meetingPointQuery.weekday << "\n";
                 }
@@ -2639,6 +2762,8 @@ void AlgorithmComparer::compareAlgorithmsRandom(DataType dataType, GTree* gTree,
         vector<double> csaTargetStopFractionMinSum;
         vector<double> csaTargetStopFractionMinMax;
         vector<double> csaVisitedConnectionsFraction;
+        vector<double> prunedCandidateFractionMinSum;
+        vector<double> prunedCandidateFractionMinMax;
 
         vector<double> visitedNodesAvgFraction;
 
@@ -2743,6 +2868,8 @@ void AlgorithmComparer::compareAlgorithmsRandom(DataType dataType, GTree* gTree,
             csaTargetStopFractionMinSum.push_back(meetingPointQueryGTreeCSAInfo.csaTargetStopFractionMinSum);
             csaTargetStopFractionMinMax.push_back(meetingPointQueryGTreeCSAInfo.csaTargetStopFractionMinMax);
             csaVisitedConnectionsFraction.push_back(meetingPointQueryGTreeCSAInfo.csaVisitedConnectionsFraction);
+            prunedCandidateFractionMinSum.push_back(meetingPointQueryGTreeCSAInfo.prunedCandidateFractionMinSum);
+            prunedCandidateFractionMinMax.push_back(meetingPointQueryGTreeCSAInfo.prunedCandidateFractionMinMax);
 
             visitedNodesAvgFraction.push_back(gTreeQueryProcessorApproximation.visitedNodesAvgFraction);
 
@@ -2830,7 +2957,7 @@ void AlgorithmComparer::compareAlgorithmsRandom(DataType dataType, GTree* gTree,
 
             if (loadOrStoreQueries && meetingPointQueries.size() == 0) {
                 for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-                    queriesInfoFile << meetingPointQuery.sourceStopIds[i] << ",";
+                    queriesInfoFile << Importer::getExternalStopId(meetingPointQuery.sourceStopIds[i]) << ",";
                 }
                 queriesInfoFile << meetingPointQuery.sourceTime << "," << meetingPointQuery.weekday << "\n";
             }
@@ -2930,6 +3057,8 @@ void AlgorithmComparer::compareAlgorithmsRandom(DataType dataType, GTree* gTree,
             cout << "Minimum target stop fraction min sum: " << Calculator::getMinimum(csaTargetStopFractionMinSum) << endl;
             cout << "Minimum target stop fraction min max: " << Calculator::getMinimum(csaTargetStopFractionMinMax) << endl;
             cout << "Minimum visited connections fraction: " << Calculator::getMinimum(csaVisitedConnectionsFraction) << endl;
+            cout << "Average pruned candidate fraction min sum: " << Calculator::getAverage(prunedCandidateFractionMinSum) << endl;
+            cout << "Average pruned candidate fraction min max: " << Calculator::getAverage(prunedCandidateFractionMinMax) << endl;
 
             cout << "\nGTree Approximation information:" << endl;
             cout << "Average target stop fraction: " << Calculator::getAverage(visitedNodesAvgFraction) << endl;
@@ -3234,7 +3363,7 @@ void AlgorithmComparer::compareAlgorithmsWithoutGTreesRandom(DataType dataType,
 
             if (loadOrStoreQueries && meetingPointQueries.size() == 0) {
                 for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-                    queriesInfoFile << meetingPointQuery.sourceStopIds[i] << ",";
+                    queriesInfoFile << Importer::getExternalStopId(meetingPointQuery.sourceStopIds[i]) << ",";
                 }
                 queriesInfoFile << meetingPointQuery.sourceTime << "," << meetingPointQuery.weekday << "\n";
             }
@@ -3705,6 +3834,327 @@ double Calculator::getMinimum(vector<double> numbers) {
     return min;
 }
 
+/*
+    Compare the naive algorithm with and without the source profiles. The first source stop of every query is replaced by a
+    source stop with a profile, so at least one source is answered from the profiles.
+*/
+void AlgorithmComparer::compareNaiveWithSourceProfiles(int numberOfQueries, vector<int> numberOfSources) {
+    vector<int> profileSourceStopIds = SourceProfileProcessor::getProfileSourceStopIds();
+    if (profileSourceStopIds.empty()) {
+        cout << "No source profiles loaded." << endl;
+        return;
+    }
+
+    for (int i = 0; i < numberOfSources.size(); i++) {
+        cout << "Comparing the source profiles for " << numberOfSources[i] << " source stops..." << endl;
+
+        vector<double> queryTimesNaive;
+        vector<double> queryTimesProfiles;
+        int errorCounter = 0;
+        int transferErrorCounter = 0;
+
+        for (int j = 0; j < numberOfQueries; j++) {
+            MeetingPointQuery meetingPointQuery = QueryGenerator::generateRandomMeetingPointQuery(numberOfSources[i]);
+            meetingPointQuery.sourceStopIds[0] = profileSourceStopIds[rand() % profileSourceStopIds.size()];
+
+            NaiveQueryProcessor naiveQueryProcessor = NaiveQueryProcessor(meetingPointQuery);
+            naiveQueryProcessor.processNaiveQuery(false);
+            MeetingPointQueryResult meetingPointQueryResultNaive = naiveQueryProcessor.getMeetingPointQueryResult();
+
+            NaiveQueryProcessor profileQueryProcessor = NaiveQueryProcessor(meetingPointQuery);
+            profileQueryProcessor.processNaiveQuery(true);
+            MeetingPointQueryResult meetingPointQueryResultProfiles = profileQueryProcessor.getMeetingPointQueryResult();
+
+            queryTimesNaive.push_back(meetingPointQueryResultNaive.queryTime);
+            queryTimesProfiles.push_back(meetingPointQueryResultProfiles.queryTime);
+
+            if (meetingPointQueryResultNaive.minSumDurationInSeconds != meetingPointQueryResultProfiles.minSumDurationInSeconds
+                || meetingPointQueryResultNaive.minMaxDurationInSeconds != meetingPointQueryResultProfiles.minMaxDurationInSeconds) {
+                errorCounter++;
+            }
+            if (meetingPointQueryResultNaive.maxTransfersMinSum != meetingPointQueryResultProfiles.maxTransfersMinSum
+                || meetingPointQueryResultNaive.maxTransfersMinMax != meetingPointQueryResultProfiles.maxTransfersMinMax) {
+                transferErrorCounter++;
+            }
+        }
+
+        cout << "Wrong durations fraction: " << (double) errorCounter / numberOfQueries << endl;
+        cout << "Different transfers fraction: " << (double) transferErrorCounter / numberOfQueries << endl;
+        cout << "Average query time without profiles: " << Calculator::getAverage(queryTimesNaive) << " ms" << endl;
+        cout << "Average query time with profiles: " << Calculator::getAverage(queryTimesProfiles) << " ms\n" << endl;
+    }
+}
+
+/*
+    Compare the raptor pq and the raptor bound algorithm for queries with random weights and deadlines against a brute force
+    evaluation of the objective over all stops. The brute force uses the earliest arrival times of the naive raptor algorithm.
+*/
+void AlgorithmComparer::compareWeightedObjectiveWithBruteForce(int numberOfQueries, vector<int> numberOfSources) {
+    for (int i = 0; i < numberOfSources.size(); i++) {
+        cout << "Comparing the weighted objective for " << numberOfSources[i] << " source stops..." << endl;
+
+        int raptorPQErrorCounter = 0;
+        int raptorBoundErrorCounter = 0;
+
+        for (int j = 0; j < numberOfQueries; j++) {
+            MeetingPointQuery meetingPointQuery = QueryGenerator::generateRandomMeetingPointQuery(numberOfSources[i]);
+
+            vector<double> weightPerSource;
+            vector<int> latestArrivalTimePerSource;
+            for (int k = 0; k < numberOfSources[i]; k++) {
+                weightPerSource.push_back(0.5 + (double) (rand() % 16) / 10);
+                if (j % 2 == 1) {
+                    latestArrivalTimePerSource.push_back(meetingPointQuery.sourceTime + 3600 + rand() % 7200);
+                }
+            }
+            shared_ptr<MeetingPointObjective> objective = make_shared<MeetingPointObjective>(weightPerSource, latestArrivalTimePerSource, vector<int>(0));
+
+            // the naive raptor algorithm is not pruned, so its labels contain the earliest arrival times at all stops
+            RaptorQueryProcessor raptorQueryProcessor = RaptorQueryProcessor(meetingPointQuery);
+            raptorQueryProcessor.processRaptorQuery();
+
+            int minSumDuration = INT_MAX;
+            int minMaxDuration = INT_MAX;
+            for (int stopId = 0; stopId < Importer::stops.size(); stopId++) {
+                if (!objective->isCandidate(stopId)) {
+                    continue;
+                }
+                int sum = 0;
+                int max = 0;
+                bool isValid = true;
+                for (int k = 0; k < numberOfSources[i]; k++) {
+                    int earliestArrivalTime = raptorQueryProcessor.raptors[k]->getEarliestArrivalTime(stopId);
+                    if (earliestArrivalTime == INT_MAX || earliestArrivalTime > objective->getLatestArrivalTime(k)) {
+                        isValid = false;
+                        break;
+                    }
+                    int duration = objective->getDuration(k, earliestArrivalTime - meetingPointQuery.sourceTime);
+                    sum += duration;
+                    if (duration > max) {
+                        max = duration;
+                    }
+                }
+                if (!isValid) {
+                    continue;
+                }
+                minSumDuration = min(minSumDuration, sum);
+                minMaxDuration = min(minMaxDuration, max);
+            }
+
+            meetingPointQuery.objective = objective;
+
+            RaptorPQQueryProcessor raptorPQMinSumQueryProcessor = RaptorPQQueryProcessor(meetingPointQuery);
+            raptorPQMinSumQueryProcessor.processRaptorPQQuery(min_sum);
+            RaptorPQQueryProcessor raptorPQMinMaxQueryProcessor = RaptorPQQueryProcessor(meetingPointQuery);
+            raptorPQMinMaxQueryProcessor.processRaptorPQQuery(min_max);
+            RaptorBoundQueryProcessor raptorBoundMinSumQueryProcessor = RaptorBoundQueryProcessor(meetingPointQuery);
+            raptorBoundMinSumQueryProcessor.processRaptorBoundQuery(min_sum);
+            RaptorBoundQueryProcessor raptorBoundMinMaxQueryProcessor = RaptorBoundQueryProcessor(meetingPointQuery);
+            raptorBoundMinMaxQueryProcessor.processRaptorBoundQuery(min_max);
+
+            // a query without a valid meeting point must not return one
+            vector<CandidateInfo> raptorPQMinSum = raptorPQMinSumQueryProcessor.getBestMeetingPoints();
+            vector<CandidateInfo> raptorPQMinMax = raptorPQMinMaxQueryProcessor.getBestMeetingPoints();
+            vector<CandidateInfo> raptorBoundMinSum = raptorBoundMinSumQueryProcessor.getBestMeetingPoints();
+            vector<CandidateInfo> raptorBoundMinMax = raptorBoundMinMaxQueryProcessor.getBestMeetingPoints();
+            int raptorPQMinSumDuration = raptorPQMinSum.empty() ? INT_MAX : raptorPQMinSum[0].duration;
+            int raptorPQMinMaxDuration = raptorPQMinMax.empty() ? INT_MAX : raptorPQMinMax[0].duration;
+            int raptorBoundMinSumDuration = raptorBoundMinSum.empty() ? INT_MAX : raptorBoundMinSum[0].duration;
+            int raptorBoundMinMaxDuration = raptorBoundMinMax.empty() ? INT_MAX : raptorBoundMinMax[0].duration;
+
+            if (raptorPQMinSumDuration != minSumDuration || raptorPQMinMaxDuration != minMaxDuration) {
+                raptorPQErrorCounter++;
+            }
+            if (raptorBoundMinSumDuration != minSumDuration || raptorBoundMinMaxDuration != minMaxDuration) {
+                raptorBoundErrorCounter++;
+            }
+        }
+
+        cout << "Wrong results raptor pq: " << raptorPQErrorCounter << " of " << numberOfQueries << endl;
+        cout << "Wrong results raptor bound: " << raptorBoundErrorCounter << " of " << numberOfQueries << "\n" << endl;
+    }
+}
+
+/*
+    Compare the k best separated meeting points of the raptor pq and the raptor bound algorithm against a brute force selection
+    over the earliest arrival times of the naive raptor algorithm. The minimum distance is chosen slightly larger than the distance
+    between the two best meeting points, so the best candidates are too close to each other and the pruning has to take the 
+    separation into account.
+*/
+void AlgorithmComparer::compareSeparatedMeetingPointsWithBruteForce(int numberOfQueries, vector<int> numberOfSources, int numberOfMeetingPoints) {
+    vector<Optimization> optimizations = {min_sum, min_max};
+    for (int i = 0; i < numberOfSources.size(); i++) {
+        cout << "Comparing the separated meeting points for " << numberOfSources[i] << " source stops..." << endl;
+
+        int raptorPQErrorCounter = 0;
+        int raptorBoundErrorCounter = 0;
+        int numberOfComparisons = 0;
+
+        for (int j = 0; j < numberOfQueries; j++) {
+            MeetingPointQuery meetingPointQuery = QueryGenerator::generateRandomMeetingPointQuery(numberOfSources[i]);
+
+            RaptorQueryProcessor raptorQueryProcessor = RaptorQueryProcessor(meetingPointQuery);
+            raptorQueryProcessor.processRaptorQuery();
+
+            for (Optimization optimization : optimizations) {
+                vector<pair<int, int>> durationsAndStopIds;
+                for (int stopId = 0; stopId < Importer::stops.size(); stopId++) {
+                    int sum = 0;
+                    int max = 0;
+                    bool isReached = true;
+                    for (int k = 0; k < numberOfSources[i]; k++) {
+                        int earliestArrivalTime = raptorQueryProcessor.raptors[k]->getEarliestArrivalTime(stopId);
+                        if (earliestArrivalTime == INT_MAX) {
+                            isReached = false;
+                            break;
+                        }
+                        int duration = earliestArrivalTime - meetingPointQuery.sourceTime;
+                        sum += duration;
+                        if (duration > max) {
+                            max = duration;
+                        }
+                    }
+                    if (isReached) {
+                        durationsAndStopIds.push_back(make_pair(optimization == min_sum ? sum : max, stopId));
+                    }
+                }
+                sort(durationsAndStopIds.begin(), durationsAndStopIds.end());
+                if (durationsAndStopIds.size() < 2) {
+                    continue;
+                }
+
+                Stop firstStop = Importer::stops[durationsAndStopIds[0].second];
+                Stop secondStop = Importer::stops[durationsAndStopIds[1].second];
+                double minimumDistance = DistanceCalculator::calculateDistance(firstStop.lat, firstStop.lon, secondStop.lat, secondStop.lon) + 0.01;
+
+                vector<int> bruteForceDurations;
+                vector<int> bruteForceStopIds;
+                for (int k = 0; k < durationsAndStopIds.size() && bruteForceStopIds.size() < numberOfMeetingPoints; k++) {
+                    Stop stop = Importer::stops[durationsAndStopIds[k].second];
+                    bool isSeparated = true;
+                    for (int l = 0; l < bruteForceStopIds.size(); l++) {
+                        Stop bestStop = Importer::stops[bruteForceStopIds[l]];
+                        if (DistanceCalculator::calculateDistance(stop.lat, stop.lon, bestStop.lat, bestStop.lon) < minimumDistance) {
+                            isSeparated = false;
+                            break;
+                        }
+                    }
+                    if (isSeparated) {
+                        bruteForceStopIds.push_back(durationsAndStopIds[k].second);
+                        bruteForceDurations.push_back(durationsAndStopIds[k].first);
+                    }
+                }
+
+                RaptorPQQueryProcessor raptorPQQueryProcessor = RaptorPQQueryProcessor(meetingPointQuery);
+                raptorPQQueryProcessor.processRaptorPQQuery(optimization, false, numberOfMeetingPoints, minimumDistance);
+                RaptorBoundQueryProcessor raptorBoundQueryProcessor = RaptorBoundQueryProcessor(meetingPointQuery);
+                raptorBoundQueryProcessor.processRaptorBoundQuery(optimization, numberOfMeetingPoints, minimumDistance);
+
+                vector<CandidateInfo> raptorPQMeetingPoints = raptorPQQueryProcessor.getBestMeetingPoints();
+                vector<CandidateInfo> raptorBoundMeetingPoints = raptorBoundQueryProcessor.getBestMeetingPoints();
+                vector<int> raptorPQDurations;
+                vector<int> raptorBoundDurations;
+                for (int k = 0; k < raptorPQMeetingPoints.size(); k++) {
+                    raptorPQDurations.push_back(raptorPQMeetingPoints[k].duration);
+                }
+                for (int k = 0; k < raptorBoundMeetingPoints.size(); k++) {
+                    raptorBoundDurations.push_back(raptorBoundMeetingPoints[k].duration);
+                }
+
+                numberOfComparisons++;
+                if (raptorPQDurations != bruteForceDurations) {
+                    raptorPQErrorCounter++;
+                }
+                if (raptorBoundDurations != bruteForceDurations) {
+                    raptorBoundErrorCounter++;
+                }
+            }
+        }
+
+        cout << "Wrong results raptor pq: " << raptorPQErrorCounter << " of " << numberOfComparisons << endl;
+        cout << "Wrong results raptor bound: " << raptorBoundErrorCounter << " of " << numberOfComparisons << "\n" << endl;
+    }
+}
+
+/*
+    Compare the full and the compact time labels of the engines. Every query runs the raptor and the raptor pq algorithm of all 
+    sources with both label types, the labels of all sources are kept like in a meeting point query. Prints the run times, the 
+    label memory and the number of queries with different earliest arrival times.
+*/
+void AlgorithmComparer::compareTimeLabels(int numberOfQueries, vector<int> numberOfSources) {
+    for (int i = 0; i < numberOfSources.size(); i++) {
+        cout << "Comparing the time labels for " << numberOfSources[i] << " source stops..." << endl;
+
+        vector<double> durationsFull;
+        vector<double> durationsCompact;
+        double memoryFull = 0;
+        double memoryCompact = 0;
+        int differenceCounter = 0;
+
+        for (int j = 0; j < numberOfQueries; j++) {
+            MeetingPointQuery meetingPointQuery = QueryGenerator::generateRandomMeetingPointQuery(numberOfSources[i]);
+
+            PhastDistances phastDistances;
+            if (!USE_LANDMARKS) {
+                phastDistances = Creator::networkGraph.getDistanceMatrixWithPhast(meetingPointQuery.sourceStopIds);
+            }
+            shared_ptr<CliqueHeuristic> cliqueHeuristic = make_shared<CliqueHeuristic>(move(phastDistances), meetingPointQuery.sourceStopIds, meetingPointQuery.weekday);
+
+            TimeLabelRun runFull = runEnginesWithTimeLabels<FullTimeLabels>(meetingPointQuery, cliqueHeuristic);
+            TimeLabelRun runCompact = runEnginesWithTimeLabels<CompactTimeLabels>(meetingPointQuery, cliqueHeuristic);
+
+            durationsFull.push_back(runFull.durationInMs);
+            durationsCompact.push_back(runCompact.durationInMs);
+            memoryFull += (double) runFull.memoryInBytes / numberOfQueries;
+            memoryCompact += (double) runCompact.memoryInBytes / numberOfQueries;
+            if (runFull.earliestArrivalTimes != runCompact.earliestArrivalTimes) {
+                differenceCounter++;
+            }
+        }
+
+        cout << "Average run time full / compact labels (in ms): " << Calculator::getAverage(durationsFull) << " / " << Calculator::getAverage(durationsCompact) << endl;
+        cout << "Average label memory full / compact labels (in MB): " << memoryFull / 1000000 << " / " << memoryCompact / 1000000 << endl;
+        cout << "Queries with different earliest arrival times: " << differenceCounter << " of " << numberOfQueries << "\n" << endl;
+    }
+}
+
+/*
+    Run the raptor and the raptor pq algorithm of all sources of the query with the given label type.
+*/
+template <typename TimeLabels>
+TimeLabelRun AlgorithmComparer::runEnginesWithTimeLabels(MeetingPointQuery meetingPointQuery, shared_ptr<CliqueHeuristic> cliqueHeuristic) {
+    int numberOfSourceStopIds = meetingPointQuery.sourceStopIds.size();
+    vector<shared_ptr<BasicRaptor<TimeLabels>>> raptors = vector<shared_ptr<BasicRaptor<TimeLabels>>>(numberOfSourceStopIds);
+    vector<shared_ptr<BasicRaptorPQ<TimeLabels>>> raptorPQs = vector<shared_ptr<BasicRaptorPQ<TimeLabels>>>(numberOfSourceStopIds);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < numberOfSourceStopIds; i++) {
+        RaptorQuery query;
+        query.sourceStopId = meetingPointQuery.sourceStopIds[i];
+        query.sourceTime = meetingPointQuery.sourceTime;
+        query.weekday = meetingPointQuery.weekday;
+
+        raptors[i] = make_shared<BasicRaptor<TimeLabels>>(query);
+        raptors[i]->processRaptor();
+
+        raptorPQs[i] = make_shared<BasicRaptorPQ<TimeLabels>>(query, min_sum);
+        raptorPQs[i]->initializeHeuristic(cliqueHeuristic, i, numberOfSourceStopIds);
+        raptorPQs[i]->initializeRaptorPQ();
+        raptorPQs[i]->processRaptorPQ();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    TimeLabelRun run;
+    run.durationInMs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+    run.memoryInBytes = 0;
+    for (int i = 0; i < numberOfSourceStopIds; i++) {
+        run.memoryInBytes += raptors[i]->getMemoryUsageOfLabels() + raptorPQs[i]->getMemoryUsageOfLabels();
+        run.earliestArrivalTimes.push_back(raptors[i]->getEarliestArrivalTimes());
+        run.earliestArrivalTimes.push_back(raptorPQs[i]->getEarliestArrivalTimes());
+    }
+    return run;
+}
+
 /*
     Print the meeting point query.
 */
@@ -3751,6 +4201,23 @@ void PrintHelper::printMeetingPointQueryResultOfOptimization(MeetingPointQueryRe
     cout << "Query time: " << meetingPointQueryResult.queryTime << " milliseconds \n" << endl;
 }
 
+/*
+    Print the best meeting points of the optimization in ascending order of their durations.
+*/
+void PrintHelper::printBestMeetingPoints(vector<CandidateInfo> bestMeetingPoints, Optimization optimization) {
+    string optimizationString = "Min sum";
+    string durationString = "travel time sum";
+    if (optimization == min_max) {
+        optimizationString = "Min max";
+        durationString = "travel time max";
+    }
+    cout << optimizationString << " - best " << bestMeetingPoints.size() << " meeting points:" << endl;
+    for (int i = 0; i < bestMeetingPoints.size(); i++) {
+        cout << i+1 << ". meeting point: " << Importer::getStopName(bestMeetingPoints[i].stopId) << ", meeting time: " << TimeConverter::convertSecondsToTime(bestMeetingPoints[i].meetingTime, true) << ", " << durationString << ": " << TimeConverter::convertSecondsToTime(bestMeetingPoints[i].duration, false) << endl;
+    }
+    cout << endl;
+}
+
 /*
     Print the journey.
 */
@@ -3770,6 +4237,8 @@ void PrintHelper::printGTreeCSAInfo(MeetingPointQueryGTreeCSAInfo meetingPointQu
     cout << "Min Sum - fraction of target stops: " << meetingPointQueryGTreeCSAInfo.csaTargetStopFractionMinSum << endl;
     cout << "Min Max - fraction of target stops: " << meetingPointQueryGTreeCSAInfo.csaTargetStopFractionMinMax << endl;
     cout << "Fraction of visited connections: " << meetingPointQueryGTreeCSAInfo.csaVisitedConnectionsFraction << endl;
+    cout << "Min Sum - fraction of pruned candidates: " << meetingPointQueryGTreeCSAInfo.prunedCandidateFractionMinSum << endl;
+    cout << "Min Max - fraction of pruned candidates: " << meetingPointQueryGTreeCSAInfo.prunedCandidateFractionMinMax << endl;
     cout << endl;
 }
 
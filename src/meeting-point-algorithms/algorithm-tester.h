@@ -15,6 +15,12 @@ struct AverageRunTimeAndAccuracy {
     double averageAccuracyMinMax;
 };
 
+struct TimeLabelRun {
+    double durationInMs;
+    size_t memoryInBytes;
+    vector<vector<int>> earliestArrivalTimes;
+};
+
 class NaiveAlgorithmTester {
     public:
         explicit NaiveAlgorithmTester(){};
@@ -42,6 +48,7 @@ class GTreeAlgorithmTester {
         static void testGTreeAlgorithm(GTree* gTree, MeetingPointQuery meetingPointQuery, bool useCSA, bool printJourneys = false);
 
         static AverageRunTimeAndAccuracy getAverageRunTimeAndAccuracy(DataType dataType, GTree* gTree, int numberOfSourceStops, int numberOfSuccessfulQueries);
+        static AverageRunTimeAndAccuracy getAverageRunTimeAndAccuracy(GTree* gTree, vector<MeetingPointQuery> &meetingPointQueries);
 };
 
 class RaptorAlgorithmTester {
@@ -61,7 +68,7 @@ class RaptorPQAlgorithmTester {
         explicit RaptorPQAlgorithmTester(){};
         ~RaptorPQAlgorithmTester(){};
 
-        static void testRaptorPQAlgorithm(MeetingPointQuery meetingPointQuery, bool printJourneys = true);
+        static void testRaptorPQAlgorithm(MeetingPointQuery meetingPointQuery, bool printJourneys = true, bool useWorkStealing = false, int numberOfMeetingPoints = 1, double minimumDistance = 0);
         static void compareRaptorPQAlgorithms(DataType dataType, int numberOfSuccessfulQueries, vector<int> numberOfSources, bool loadOrStoreQueries);
 };
 
@@ -70,7 +77,7 @@ class RaptorBoundAlgorithmTester {
         explicit RaptorBoundAlgorithmTester(){};
         ~RaptorBoundAlgorithmTester(){};
 
-        static void testRaptorBoundAlgorithm(MeetingPointQuery meetingPointQuery, bool printJourneys = true);
+        static void testRaptorBoundAlgorithm(MeetingPointQuery meetingPointQuery, bool printJourneys = true, int numberOfMeetingPoints = 1, double minimumDistance = 0);
 };
 
 class RaptorApproximationAlgorithmTester {
@@ -93,6 +100,14 @@ class AlgorithmComparer {
         static void compareAlgorithmsWithoutGTreesRandom(DataType dataType, int numberOfSuccessfulQueries, vector<int> numberOfSources, bool printResults = false, bool loadOrStoreQueries = false);
         static void compareAlgorithms(DataType dataType, GTree* gTree, MeetingPointQuery meetingPointQuery);
         static void compareAlgorithmsWithoutGTree(DataType dataType, MeetingPointQuery meetingPointQuery);
+        static void compareNaiveWithSourceProfiles(int numberOfQueries, vector<int> numberOfSources);
+        static void compareWeightedObjectiveWithBruteForce(int numberOfQueries, vector<int> numberOfSources);
+        static void compareTimeLabels(int numberOfQueries, vector<int> numberOfSources);
+        static void compareSeparatedMeetingPointsWithBruteForce(int numberOfQueries, vector<int> numberOfSources, int numberOfMeetingPoints);
+
+    private:
+        template <typename TimeLabels>
+        static TimeLabelRun runEnginesWithTimeLabels(MeetingPointQuery meetingPointQuery, shared_ptr<CliqueHeuristic> cliqueHeuristic);
 };
 
 class PrintHelper {
@@ -103,6 +118,7 @@ class PrintHelper {
         static void printMeetingPointQuery(MeetingPointQuery meetingPointQuery);
         static void printMeetingPointQueryResult(MeetingPointQueryResult meetingPointQueryResult);
         static void printMeetingPointQueryResultOfOptimization(MeetingPointQueryResult meetingPointQueryResult, Optimization optimization);
+        static void printBestMeetingPoints(vector<CandidateInfo> bestMeetingPoints, Optimization optimization);
         static void printGTreeCSAInfo(MeetingPointQueryGTreeCSAInfo meetingPointQueryGTreeCSAInfo);
         static void printGTreeApproxInfo(GTreeQueryProcessor gTreeQueryProcessor);
         static void printJourney(Journey journey);
@@ -13,11 +13,13 @@
 #include <vector>
 #include <set>
 #include <memory>
+#include <algorithm>
 
 
 using namespace std;
 
 vector<vector<int>> LandmarkProcessor::landmarkDurations = vector<vector<int>>(0);
+vector<vector<unsigned short>> LandmarkProcessor::compactLandmarkDurations = vector<vector<unsigned short>>(0);
 
 void LandmarkProcessor::loadOrCalculateLandmarkDurations(DataType dataType, bool importDurations) {
     if (importDurations) {
@@ -32,6 +34,68 @@ void LandmarkProcessor::loadOrCalculateLandmarkDurations(DataType dataType, bool
 
         exportLandmarkDurations(dataType, 0);
     }
+
+    if (USE_COMPACT_LABELS) {
+        compressLandmarkDurations();
+    }
+}
+
+/*
+    Store the landmark durations as 16 bit minutes (rounded down) to reduce the memory of the tables by half. Durations that
+    don't fit into the field are treated as unreachable, so they can't produce invalid lower bounds.
+*/
+void LandmarkProcessor::compressLandmarkDurations() {
+    compactLandmarkDurations = vector<vector<unsigned short>>(landmarkDurations.size());
+    for (int i = 0; i < landmarkDurations.size(); i++) {
+        compactLandmarkDurations[i] = vector<unsigned short>(landmarkDurations[i].size(), COMPACT_LANDMARK_UNREACHED);
+        for (int j = 0; j < landmarkDurations[i].size(); j++) {
+            int duration = landmarkDurations[i][j];
+            if (duration != INT_MAX && duration / COMPACT_LANDMARK_RESOLUTION < COMPACT_LANDMARK_UNREACHED) {
+                compactLandmarkDurations[i][j] = duration / COMPACT_LANDMARK_RESOLUTION;
+            }
+        }
+    }
+
+    landmarkDurations = vector<vector<int>>(0);
+}
+
+int LandmarkProcessor::getNumberOfLandmarks() {
+    if (USE_COMPACT_LABELS && !compactLandmarkDurations.empty()) {
+        return compactLandmarkDurations.size();
+    }
+    return landmarkDurations.size();
+}
+
+/*
+    Returns the duration from the landmark to the stop in seconds, compact durations are rounded down to full minutes.
+*/
+int LandmarkProcessor::getLandmarkDuration(int landmarkIndex, int stopId) {
+    if (USE_COMPACT_LABELS && !compactLandmarkDurations.empty()) {
+        int duration = compactLandmarkDurations[landmarkIndex][stopId];
+        if (duration == COMPACT_LANDMARK_UNREACHED) {
+            return INT_MAX;
+        }
+        return duration * COMPACT_LANDMARK_RESOLUTION;
+    }
+    return landmarkDurations[landmarkIndex][stopId];
+}
+
+/*
+    Lower bound of the duration between both stops with the triangle inequality of a landmark. The rounding of compact durations
+    is subtracted, so that the bound stays valid.
+*/
+int LandmarkProcessor::getLowerBoundOfLandmark(int landmarkIndex, int stopId1, int stopId2) {
+    int duration1 = getLandmarkDuration(landmarkIndex, stopId1);
+    int duration2 = getLandmarkDuration(landmarkIndex, stopId2);
+    if (duration1 == INT_MAX || duration2 == INT_MAX) {
+        return 0;
+    }
+
+    int lowerBound = abs(duration1 - duration2);
+    if (USE_COMPACT_LABELS && !compactLandmarkDurations.empty()) {
+        lowerBound -= COMPACT_LANDMARK_RESOLUTION - 1;
+    }
+    return max(lowerBound, 0);
 }
 
 void LandmarkProcessor::importLandmarkDurations(DataType dataType) {
@@ -65,7 +129,7 @@ void LandmarkProcessor::importLandmarkDurations(DataType dataType) {
             for (int j = 0; j < Importer::stops.size(); j++) {
                 getline(file, line);
 
-                landmarkDurationsFile[i][j] = stoi(line);
+                landmarkDurationsFile[i][Importer::getInternalStopId(j)] = stoi(line);
             }
         }
 
@@ -95,7 +159,7 @@ void LandmarkProcessor::exportLandmarkDurations(DataType dataType, int id) {
     
     for (int i = 0; i < landmarkDurations.size(); i++) {
         for (int j = 0; j < landmarkDurations[i].size(); j++) {
-            file << landmarkDurations[i][j] << endl;
+            file << landmarkDurations[i][Importer::getInternalStopId(j)] << endl;
         }
     }
 
@@ -128,7 +192,7 @@ void LandmarkProcessor::calculateLandmarkDurations(DataType dataType) {
                 parts.push_back(substring);
             }
 
-            landmarkIds.push_back(stoi(parts[0]));
+            landmarkIds.push_back(Importer::getInternalStopId(stoi(parts[0])));
         }
     } else {
         cout << "Error: Could not open file " << filePath << endl;
@@ -298,7 +362,7 @@ vector<int> LandmarkProcessor::getLandmarkIds(DataType dataType, int lowerIndex,
                 parts.push_back(substring);
             }
 
-            landmarkIds.push_back(stoi(parts[0]));
+            landmarkIds.push_back(Importer::getInternalStopId(stoi(parts[0])));
         }
     } else {
         cout << "Error: Could not open file " << filePath << endl;
@@ -318,24 +382,8 @@ vector<int> LandmarkProcessor::getLandmarkIds(DataType dataType, int lowerIndex,
 int LandmarkProcessor::getLowerBound(int stopId1, int stopId2, int weekday) {
     int lowerBound = 0;
 
-    for (int i = 0; i < landmarkDurations.size(); i++) {
-        int duration1 = landmarkDurations[i][stopId1];
-        int duration2 = landmarkDurations[i][stopId2];
-        if (duration1 != INT_MAX && duration2 != INT_MAX) {
-            int duration = duration1 - duration2;
-            if (duration > lowerBound) {
-                lowerBound = duration;
-            }
-        }
-
-        duration1 = landmarkDurations[i][stopId2];
-        duration2 = landmarkDurations[i][stopId1];
-        if (duration1 != INT_MAX && duration2 != INT_MAX) {
-            int duration = duration1 - duration2;
-            if (duration > lowerBound) {
-                lowerBound = duration;
-            }
-        }
+    for (int i = 0; i < getNumberOfLandmarks(); i++) {
+        lowerBound = max(lowerBound, getLowerBoundOfLandmark(i, stopId1, stopId2));
     }
 
     return lowerBound;
@@ -382,8 +430,7 @@ vector<set<int>> LandmarkProcessor::getAllDepartureTimesOfStop(int stopId) {
                             departureTimesPerWeekday[weekday].insert(departureTime);
                         } else {
                             int previousDay = (weekday + 6) % 7;
-                            departureTime = departureTime + SECONDS_PER_DAY;
-                            departureTimesPerWeekday[previousDay].insert(departureTime);
+                            departureTimesPerWeekday[previousDay].insert(departureTime + SECONDS_PER_DAY);
                         }
                     }
                 }
@@ -472,7 +519,7 @@ void LandmarkProcessor::countAllArrivalAndDepartureTimesOfTheLandmarks(DataType
                 parts.push_back(substring);
             }
 
-            landmarkIds.push_back(stoi(parts[0]));
+            landmarkIds.push_back(Importer::getInternalStopId(stoi(parts[0])));
         }
     } else {
         cout << "Error: Could not open file " << filePath << endl;
@@ -506,23 +553,7 @@ int LandmarkProcessor::getLowerBoundUsingLandmarks(int stopId1, int stopId2, vec
     int lowerBound = 0;
 
     for (int i = 0; i < landmarkIndices.size(); i++) {
-        int duration1 = landmarkDurations[landmarkIndices[i]][stopId1];
-        int duration2 = landmarkDurations[landmarkIndices[i]][stopId2];
-        if (duration1 != INT_MAX && duration2 != INT_MAX) {
-            int duration = duration1 - duration2;
-            if (duration > lowerBound) {
-                lowerBound = duration;
-            }
-        }
-
-        duration1 = landmarkDurations[landmarkIndices[i]][stopId2];
-        duration2 = landmarkDurations[landmarkIndices[i]][stopId1];
-        if (duration1 != INT_MAX && duration2 != INT_MAX) {
-            int duration = duration1 - duration2;
-            if (duration > lowerBound) {
-                lowerBound = duration;
-            }
-        }
+        lowerBound = max(lowerBound, getLowerBoundOfLandmark(landmarkIndices[i], stopId1, stopId2));
     }
 
     return lowerBound;
@@ -531,23 +562,10 @@ int LandmarkProcessor::getLowerBoundUsingLandmarks(int stopId1, int stopId2, vec
 vector<int> LandmarkProcessor::getTopKLandmarks(int k, int stopId1, int stopId2) {
     vector<int> topKLandmarks = vector<int>(0);
 
-    vector<int> lowerBounds = vector<int>(landmarkDurations.size(), 0);
-
-    for (int i = 0; i < landmarkDurations.size(); i++) {
-        int duration1 = landmarkDurations[i][stopId1];
-        int duration2 = landmarkDurations[i][stopId2];
-        if (duration1 != INT_MAX && duration2 != INT_MAX) {
-            lowerBounds[i] = duration1 - duration2;
-        }
+    vector<int> lowerBounds = vector<int>(getNumberOfLandmarks(), 0);
 
-        duration1 = landmarkDurations[i][stopId2];
-        duration2 = landmarkDurations[i][stopId1];
-        if (duration1 != INT_MAX && duration2 != INT_MAX) {
-            int duration = duration1 - duration2;
-            if (duration > lowerBounds[i]) {
-                lowerBounds[i] = duration;
-            }
-        }
+    for (int i = 0; i < getNumberOfLandmarks(); i++) {
+        lowerBounds[i] = getLowerBoundOfLandmark(i, stopId1, stopId2);
     }
 
     for (int i = 0; i < k; i++) {
@@ -572,8 +590,8 @@ int LandmarkProcessor::getClosestLandmark(int stopId) {
     int closestLandmark = -1;
     int closestLandmarkDuration = INT_MAX;
 
-    for (int i = 0; i < landmarkDurations.size(); i++) {
-        int duration = landmarkDurations[i][stopId];
+    for (int i = 0; i < getNumberOfLandmarks(); i++) {
+        int duration = getLandmarkDuration(i, stopId);
         if (duration < closestLandmarkDuration) {
             closestLandmarkDuration = duration;
             closestLandmark = i;
@@ -647,7 +665,7 @@ void LandmarkProcessor::findAndCalculateLandmarks(DataType dataType, int numberO
     }
     
     for (int i = 0; i < landmarkIds.size(); i++) {
-        file << landmarkIds[i] << endl;
+        file << Importer::getExternalStopId(landmarkIds[i]) << endl;
     }
 
     file.close();
@@ -658,3 +676,363 @@ void LandmarkProcessor::findAndCalculateLandmarks(DataType dataType, int numberO
     // Print the duration
     cout << "Found and calculated landmarks in " << duration << " milliseconds." << endl;
 }
+
+vector<int> SourceProfileProcessor::profileSourceStopIds = vector<int>(0);
+vector<int> SourceProfileProcessor::entryOffsets = vector<int>(0);
+vector<int> SourceProfileProcessor::entryDepartureTimes = vector<int>(0);
+vector<int> SourceProfileProcessor::entryArrivalTimes = vector<int>(0);
+vector<unsigned char> SourceProfileProcessor::entryNumberOfLegs = vector<unsigned char>(0);
+
+/*
+    Import the source profiles or calculate them for the source stops listed in profile-source-stops.txt (one stop name per line).
+*/
+void SourceProfileProcessor::loadOrCalculateSourceProfiles(DataType dataType) {
+    if (importSourceProfiles(dataType)) {
+        return;
+    }
+
+    vector<int> sourceStopIds = getSourceStopIdsFromFile(dataType);
+    if (sourceStopIds.empty()) {
+        return;
+    }
+
+    calculateSourceProfiles(sourceStopIds);
+    exportSourceProfiles(dataType);
+}
+
+/*
+    Calculate the profiles of the source stops. The earliest arrival times only change at the departure times of the trips that
+    can be reached from a source stop, so raptor runs at these times (and once after the last departure of the day) are enough.
+    The runs are processed from the latest to the earliest departure time and an entry is only stored if it differs from the
+    entry of the next run.
+*/
+void SourceProfileProcessor::calculateSourceProfiles(vector<int> sourceStopIds) {
+    auto start = std::chrono::high_resolution_clock::now();
+    cout << "Calculating source profiles..." << endl;
+
+    int numberOfStops = Importer::stops.size();
+    profileSourceStopIds = sourceStopIds;
+    entryOffsets = vector<int>(sourceStopIds.size() * 7 * numberOfStops + 1, 0);
+    entryDepartureTimes = vector<int>(0);
+    entryArrivalTimes = vector<int>(0);
+    entryNumberOfLegs = vector<unsigned char>(0);
+
+    for (int i = 0; i < sourceStopIds.size(); i++) {
+        vector<set<int>> departureTimesPerWeekday = LandmarkProcessor::getAllDepartureTimesOfStop(sourceStopIds[i]);
+
+        for (int weekday = 0; weekday < 7; weekday++) {
+            // the trips after midnight are part of the next day
+            vector<int> departureTimes = vector<int>(departureTimesPerWeekday[weekday].begin(), departureTimesPerWeekday[weekday].lower_bound(SECONDS_PER_DAY));
+
+            // the run after the last departure answers the queries until the end of the day
+            vector<int> sourceTimes = departureTimes;
+            int lastSourceTime = departureTimes.empty() ? 0 : departureTimes.back() + 1;
+            if (lastSourceTime < SECONDS_PER_DAY) {
+                sourceTimes.push_back(lastSourceTime);
+                departureTimes.push_back(SECONDS_PER_DAY - 1);
+            }
+
+            // the entries of every stop in the order of decreasing departure times
+            vector<vector<int>> departureTimesPerStop = vector<vector<int>>(numberOfStops);
+            vector<vector<int>> arrivalTimesPerStop = vector<vector<int>>(numberOfStops);
+            vector<vector<int>> numberOfLegsPerStop = vector<vector<int>>(numberOfStops);
+
+            vector<int> nextArrivalTimes = vector<int>(numberOfStops, INT_MAX);
+            vector<int> nextNumberOfLegs = vector<int>(numberOfStops, 0);
+
+            // the raptor runs of a block are independent, afterwards they are merged sequentially
+            int blockSize = 64;
+            for (int blockEnd = sourceTimes.size(); blockEnd > 0; blockEnd -= blockSize) {
+                int blockStart = max(0, blockEnd - blockSize);
+                vector<vector<int>> blockArrivalTimes = vector<vector<int>>(blockEnd - blockStart);
+                vector<vector<int>> blockNumberOfLegs = vector<vector<int>>(blockEnd - blockStart);
+
+                #pragma omp parallel for schedule(dynamic)
+                for (int j = blockStart; j < blockEnd; j++) {
+                    RaptorQuery query;
+                    query.sourceStopId = sourceStopIds[i];
+                    query.sourceTime = sourceTimes[j];
+                    query.weekday = weekday;
+
+                    Raptor raptor = Raptor(query);
+                    raptor.processRaptor();
+
+                    vector<int> arrivalTimes = raptor.getEarliestArrivalTimes();
+
+                    // the walking durations from the source stop are added during the query, only rides are stored
+                    int indexOfFirstFootPathOfSourceStop = Importer::indexOfFirstFootPathOfAStop[sourceStopIds[i]];
+                    for (int k = indexOfFirstFootPathOfSourceStop; k < Importer::footPaths.size(); k++) {
+                        if (Importer::footPaths[k].departureStopId != sourceStopIds[i]) {
+                            break;
+                        }
+                        int stopId = Importer::footPaths[k].arrivalStopId;
+                        if (arrivalTimes[stopId] >= sourceTimes[j] + Importer::footPaths[k].duration) {
+                            arrivalTimes[stopId] = INT_MAX;
+                        }
+                    }
+
+                    blockArrivalTimes[j - blockStart] = arrivalTimes;
+                    blockNumberOfLegs[j - blockStart] = getNumberOfLegs(raptor);
+                }
+
+                for (int j = blockEnd - 1; j >= blockStart; j--) {
+                    for (int stopId = 0; stopId < numberOfStops; stopId++) {
+                        int arrivalTime = blockArrivalTimes[j - blockStart][stopId];
+                        int numberOfLegs = arrivalTime == INT_MAX ? 0 : blockNumberOfLegs[j - blockStart][stopId];
+                        if (arrivalTime == nextArrivalTimes[stopId] && numberOfLegs == nextNumberOfLegs[stopId]) {
+                            continue;
+                        }
+                        departureTimesPerStop[stopId].push_back(departureTimes[j]);
+                        arrivalTimesPerStop[stopId].push_back(arrivalTime);
+                        numberOfLegsPerStop[stopId].push_back(numberOfLegs);
+                        nextArrivalTimes[stopId] = arrivalTime;
+                        nextNumberOfLegs[stopId] = numberOfLegs;
+                    }
+                }
+            }
+
+            for (int stopId = 0; stopId < numberOfStops; stopId++) {
+                int index = (i * 7 + weekday) * numberOfStops + stopId;
+                for (int j = departureTimesPerStop[stopId].size() - 1; j >= 0; j--) {
+                    entryDepartureTimes.push_back(departureTimesPerStop[stopId][j]);
+                    entryArrivalTimes.push_back(arrivalTimesPerStop[stopId][j]);
+                    entryNumberOfLegs.push_back((unsigned char) min(numberOfLegsPerStop[stopId][j], 255));
+                }
+                entryOffsets[index + 1] = entryDepartureTimes.size();
+            }
+        }
+
+        cout << "Calculated the profiles of " << Importer::getStopName(sourceStopIds[i]) << "." << endl;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    cout << "Calculated " << entryDepartureTimes.size() << " profile entries in " << duration << " milliseconds.\n" << endl;
+}
+
+/*
+    Returns the number of legs of the journeys of a finished raptor run, counted like in Raptor::createJourney.
+*/
+vector<int> SourceProfileProcessor::getNumberOfLegs(Raptor &raptor) {
+    vector<int> numberOfLegs = vector<int>(Importer::stops.size(), -1);
+    for (int i = 0; i < raptor.extendedSourceStopIds.size(); i++) {
+        numberOfLegs[raptor.extendedSourceStopIds[i]] = 0;
+    }
+
+    vector<int> path = vector<int>(0);
+    for (int i = 0; i < numberOfLegs.size(); i++) {
+        if (raptor.getEarliestArrivalTime(i) == INT_MAX) {
+            continue;
+        }
+
+        int currentStopId = i;
+        while (numberOfLegs[currentStopId] == -1) {
+            path.push_back(currentStopId);
+            currentStopId = raptor.journeyPointers[currentStopId].enterTripAtStop;
+        }
+        for (int j = path.size() - 1; j >= 0; j--) {
+            numberOfLegs[path[j]] = numberOfLegs[currentStopId] + 1;
+            currentStopId = path[j];
+        }
+        path.clear();
+    }
+    return numberOfLegs;
+}
+
+/*
+    Returns the index of the profile of the source stop or -1 if there is no profile.
+*/
+int SourceProfileProcessor::getProfileIndex(int sourceStopId) {
+    for (int i = 0; i < profileSourceStopIds.size(); i++) {
+        if (profileSourceStopIds[i] == sourceStopId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+vector<int> SourceProfileProcessor::getProfileSourceStopIds() {
+    return profileSourceStopIds;
+}
+
+/*
+    Calculate the earliest arrival times and the number of legs of all stops like a raptor query from the source stop of the
+    profile. The source time has to be in the query day.
+*/
+void SourceProfileProcessor::getEarliestArrivalTimes(int profileIndex, int sourceTime, int weekday, vector<int> &earliestArrivalTimes, vector<int> &numberOfLegs) {
+    int numberOfStops = Importer::stops.size();
+    earliestArrivalTimes = vector<int>(numberOfStops, INT_MAX);
+    numberOfLegs = vector<int>(numberOfStops, 0);
+
+    int firstIndex = (profileIndex * 7 + weekday) * numberOfStops;
+    for (int i = 0; i < numberOfStops; i++) {
+        auto first = entryDepartureTimes.begin() + entryOffsets[firstIndex + i];
+        auto last = entryDepartureTimes.begin() + entryOffsets[firstIndex + i + 1];
+        auto it = lower_bound(first, last, sourceTime);
+        if (it != last) {
+            int entryIndex = it - entryDepartureTimes.begin();
+            earliestArrivalTimes[i] = entryArrivalTimes[entryIndex];
+            numberOfLegs[i] = entryNumberOfLegs[entryIndex];
+        }
+    }
+
+    // like in raptor a ride has to be faster than walking from the source stop
+    int sourceStopId = profileSourceStopIds[profileIndex];
+    int indexOfFirstFootPathOfSourceStop = Importer::indexOfFirstFootPathOfAStop[sourceStopId];
+    for (int i = indexOfFirstFootPathOfSourceStop; i < Importer::footPaths.size(); i++) {
+        if (Importer::footPaths[i].departureStopId != sourceStopId) {
+            break;
+        }
+        int stopId = Importer::footPaths[i].arrivalStopId;
+        int arrivalTime = sourceTime + Importer::footPaths[i].duration;
+        if (arrivalTime <= earliestArrivalTimes[stopId]) {
+            earliestArrivalTimes[stopId] = arrivalTime;
+            numberOfLegs[stopId] = 0;
+        }
+    }
+}
+
+/*
+    Export the profiles as binary file. The file starts with the number of source stops, the number of stops and the number of
+    entries, followed by the source stop ids, the offsets, the departure times, the arrival times and the number of legs.
+*/
+void SourceProfileProcessor::exportSourceProfiles(DataType dataType) {
+    string dataTypeString = Importer::getDataTypeString(dataType);
+    string filePath = FOLDER_PREFIX + "graphs/" + dataTypeString + "/source-profiles.bin";
+
+    ofstream file(filePath, ios::binary);
+    if (!file.is_open()) {
+        cout << "Error: Could not open file " << filePath << endl;
+        return;
+    }
+
+    // the file stores the profiles in the order of the external stop ids
+    reorderProfileStops(true);
+
+    int header[3] = {(int) profileSourceStopIds.size(), (int) Importer::stops.size(), (int) entryDepartureTimes.size()};
+    file.write((char*) header, sizeof(header));
+    file.write((char*) profileSourceStopIds.data(), profileSourceStopIds.size() * sizeof(int));
+    file.write((char*) entryOffsets.data(), entryOffsets.size() * sizeof(int));
+    file.write((char*) entryDepartureTimes.data(), entryDepartureTimes.size() * sizeof(int));
+    file.write((char*) entryArrivalTimes.data(), entryArrivalTimes.size() * sizeof(int));
+    file.write((char*) entryNumberOfLegs.data(), entryNumberOfLegs.size());
+    file.close();
+
+    reorderProfileStops(false);
+
+    cout << "Exported source profiles.\n" << endl;
+}
+
+bool SourceProfileProcessor::importSourceProfiles(DataType dataType) {
+    string dataTypeString = Importer::getDataTypeString(dataType);
+    string filePath = FOLDER_PREFIX + "graphs/" + dataTypeString + "/source-profiles.bin";
+
+    ifstream file(filePath, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    int header[3];
+    file.read((char*) header, sizeof(header));
+    if (!file || header[1] != Importer::stops.size()) {
+        cout << "The source profiles in " << filePath << " don't match the stops." << endl;
+        file.close();
+        return false;
+    }
+
+    profileSourceStopIds = vector<int>(header[0]);
+    entryOffsets = vector<int>(header[0] * 7 * header[1] + 1);
+    entryDepartureTimes = vector<int>(header[2]);
+    entryArrivalTimes = vector<int>(header[2]);
+    entryNumberOfLegs = vector<unsigned char>(header[2]);
+
+    file.read((char*) profileSourceStopIds.data(), profileSourceStopIds.size() * sizeof(int));
+    file.read((char*) entryOffsets.data(), entryOffsets.size() * sizeof(int));
+    file.read((char*) entryDepartureTimes.data(), entryDepartureTimes.size() * sizeof(int));
+    file.read((char*) entryArrivalTimes.data(), entryArrivalTimes.size() * sizeof(int));
+    file.read((char*) entryNumberOfLegs.data(), entryNumberOfLegs.size());
+
+    if (!file) {
+        cout << "Could not read file " << filePath << endl;
+        profileSourceStopIds.clear();
+        file.close();
+        return false;
+    }
+
+    file.close();
+    reorderProfileStops(false);
+
+    cout << "Imported the source profiles of " << profileSourceStopIds.size() << " source stops.\n" << endl;
+    return true;
+}
+
+/*
+    Reorder the source stops and the entries of the profiles from the internal to the external stop ids or the other way round.
+*/
+void SourceProfileProcessor::reorderProfileStops(bool toExternalStopIds) {
+    int numberOfStops = Importer::stops.size();
+    int numberOfBlocks = profileSourceStopIds.size() * 7;
+
+    vector<int> newEntryOffsets = vector<int>(entryOffsets.size(), 0);
+    vector<int> newEntryDepartureTimes = vector<int>(0);
+    vector<int> newEntryArrivalTimes = vector<int>(0);
+    vector<unsigned char> newEntryNumberOfLegs = vector<unsigned char>(0);
+    newEntryDepartureTimes.reserve(entryDepartureTimes.size());
+    newEntryArrivalTimes.reserve(entryArrivalTimes.size());
+    newEntryNumberOfLegs.reserve(entryNumberOfLegs.size());
+
+    for (int block = 0; block < numberOfBlocks; block++) {
+        for (int stopId = 0; stopId < numberOfStops; stopId++) {
+            int oldStopId = toExternalStopIds ? Importer::getInternalStopId(stopId) : Importer::getExternalStopId(stopId);
+            int oldIndex = block * numberOfStops + oldStopId;
+            for (int i = entryOffsets[oldIndex]; i < entryOffsets[oldIndex + 1]; i++) {
+                newEntryDepartureTimes.push_back(entryDepartureTimes[i]);
+                newEntryArrivalTimes.push_back(entryArrivalTimes[i]);
+                newEntryNumberOfLegs.push_back(entryNumberOfLegs[i]);
+            }
+            newEntryOffsets[block * numberOfStops + stopId + 1] = newEntryDepartureTimes.size();
+        }
+    }
+
+    for (int i = 0; i < profileSourceStopIds.size(); i++) {
+        int stopId = profileSourceStopIds[i];
+        profileSourceStopIds[i] = toExternalStopIds ? Importer::getExternalStopId(stopId) : Importer::getInternalStopId(stopId);
+    }
+
+    entryOffsets = newEntryOffsets;
+    entryDepartureTimes = newEntryDepartureTimes;
+    entryArrivalTimes = newEntryArrivalTimes;
+    entryNumberOfLegs = newEntryNumberOfLegs;
+}
+
+vector<int> SourceProfileProcessor::getSourceStopIdsFromFile(DataType dataType) {
+    string dataTypeString = Importer::getDataTypeString(dataType);
+    string filePath = FOLDER_PREFIX + "graphs/" + dataTypeString + "/profile-source-stops.txt";
+
+    vector<int> sourceStopIds = vector<int>(0);
+
+    ifstream file(filePath);
+    if (!file.is_open()) {
+        cout << "Error: Could not open file " << filePath << endl;
+        return sourceStopIds;
+    }
+
+    string line;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        int stopId = Importer::getStopId(line);
+        if (stopId == -1) {
+            cout << "Unknown source stop " << line << endl;
+            continue;
+        }
+        sourceStopIds.push_back(stopId);
+    }
+
+    file.close();
+    return sourceStopIds;
+}
@@ -2,6 +2,7 @@
 #define CMAKE_LANDMARK_PROCESSOR_H
 
 #include "../data-handling/importer.h"
+#include "raptor.h"
 
 #include <vector>
 #include <set>
@@ -34,7 +35,46 @@ class LandmarkProcessor {
 
         static vector<int> getLandmarkIds(DataType dataType, int lowerIndex, int upperIndex);
 
+        static void compressLandmarkDurations();
+        static int getNumberOfLandmarks();
+        static int getLandmarkDuration(int landmarkIndex, int stopId);
+        static int getLowerBoundOfLandmark(int landmarkIndex, int stopId1, int stopId2);
+
         static vector<vector<int>> landmarkDurations;
+        // the landmark durations in minutes (rounded down) if compact labels are used
+        static vector<vector<unsigned short>> compactLandmarkDurations;
+};
+
+/*
+    Precomputed full day profiles of frequently used source stops. For every source stop, weekday and stop the profile contains
+    the departure times at which the earliest arrival time or the number of legs changes.
+*/
+class SourceProfileProcessor {
+    public:
+        explicit SourceProfileProcessor(){};
+        ~SourceProfileProcessor(){};
+
+        static void loadOrCalculateSourceProfiles(DataType dataType);
+        static void calculateSourceProfiles(vector<int> sourceStopIds);
+
+        static int getProfileIndex(int sourceStopId);
+        static vector<int> getProfileSourceStopIds();
+        static void getEarliestArrivalTimes(int profileIndex, int sourceTime, int weekday, vector<int> &earliestArrivalTimes, vector<int> &numberOfLegs);
+
+    private:
+        static bool importSourceProfiles(DataType dataType);
+        static void exportSourceProfiles(DataType dataType);
+        static vector<int> getSourceStopIdsFromFile(DataType dataType);
+        static vector<int> getNumberOfLegs(Raptor &raptor);
+        static void reorderProfileStops(bool toExternalStopIds);
+
+        static vector<int> profileSourceStopIds;
+
+        // the entries of source i, weekday w and stop s are stored from entryOffsets[k] to entryOffsets[k+1] with k = (i * 7 + w) * |S| + s
+        static vector<int> entryOffsets;
+        static vector<int> entryDepartureTimes;
+        static vector<int> entryArrivalTimes;
+        static vector<unsigned char> entryNumberOfLegs;
 };
 
 #endif //CMAKE_LANDMARK_PROCESSOR_H
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <chrono>
 
 #include "csa.h"
 #include "../data-structures/graph.h"
@@ -131,4 +132,137 @@ void LowerBoundTester::getLowerBoundDiffs(int numberOfSources, int numberOfTarge
     cout << "Min relative diff landmarks: " << minRelativeDiffLandmarks << endl;
 
     cout << "Lower bound greater fraction landmarks: " << lowerBoundGreaterFractionLandmarks << endl;
+}
+
+/*
+    Compare the run times of the phast implementation with one distance vector per source and the dense distance matrix
+    for the given numbers of sources. The distances of both implementations are compared as well.
+*/
+void LowerBoundTester::comparePhastImplementations(vector<int> numberOfSourcesVec, int numberOfRuns) {
+    for (int numberOfSources : numberOfSourcesVec) {
+        double durationPerSource = 0;
+        double durationMatrix = 0;
+        int numberOfDifferences = 0;
+
+        for (int run = 0; run < numberOfRuns; run++) {
+            vector<int> sources = vector<int>();
+            for (int i = 0; i < numberOfSources; i++) {
+                sources.push_back(rand() % Creator::networkGraph.vertices.size());
+            }
+
+            auto start = chrono::high_resolution_clock::now();
+            map<int, vector<int>> sourceStopIdToAllStops = Creator::networkGraph.getDistancesWithPhast(sources);
+            auto end = chrono::high_resolution_clock::now();
+            durationPerSource += chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+            start = chrono::high_resolution_clock::now();
+            PhastDistances phastDistances = Creator::networkGraph.getDistanceMatrixWithPhast(sources);
+            end = chrono::high_resolution_clock::now();
+            durationMatrix += chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+            for (int i = 0; i < numberOfSources; i++) {
+                vector<int>* distances = &sourceStopIdToAllStops[sources[i]];
+                for (int j = 0; j < distances->size(); j++) {
+                    if ((*distances)[j] != phastDistances.distances[j * numberOfSources + i]) {
+                        numberOfDifferences++;
+                    }
+                }
+            }
+        }
+
+        cout << "Number of sources: " << numberOfSources << endl;
+        cout << "Average phast duration per source vectors (in ms): " << durationPerSource / numberOfRuns << endl;
+        cout << "Average phast duration distance matrix (in ms): " << durationMatrix / numberOfRuns << endl;
+        cout << "Number of different distances: " << numberOfDifferences << "\n" << endl;
+    }
+}
+
+/*
+    Creates the contraction hierarchie of the network graph with the serial and the batched contraction and compares the build times,
+    the number of edges and the phast distances of random sources.
+*/
+void LowerBoundTester::compareContractionHierarchieCreation(int numberOfSources) {
+    Graph graphWithCH = Creator::networkGraph;
+    Creator::createNetworkGraph();
+    Graph serialGraph = Creator::networkGraph;
+    Graph batchedGraph = Creator::networkGraph;
+    Creator::networkGraph = graphWithCH;
+
+    auto start = chrono::high_resolution_clock::now();
+    serialGraph.createContractionHierarchieSerial();
+    auto end = chrono::high_resolution_clock::now();
+    double durationSerial = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+    start = chrono::high_resolution_clock::now();
+    batchedGraph.createContractionHierarchie();
+    end = chrono::high_resolution_clock::now();
+    double durationBatched = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+    long numberOfEdgesSerial = 0;
+    long numberOfEdgesBatched = 0;
+    for (int i = 0; i < serialGraph.adjacencyList.size(); i++) {
+        numberOfEdgesSerial += serialGraph.adjacencyList[i].size();
+        numberOfEdgesBatched += batchedGraph.adjacencyList[i].size();
+    }
+
+    vector<int> sources = vector<int>();
+    for (int i = 0; i < numberOfSources; i++) {
+        sources.push_back(rand() % serialGraph.vertices.size());
+    }
+
+    PhastDistances serialDistances = serialGraph.getDistanceMatrixWithPhast(sources);
+    PhastDistances batchedDistances = batchedGraph.getDistanceMatrixWithPhast(sources);
+
+    int numberOfDifferences = 0;
+    for (int i = 0; i < serialDistances.distances.size(); i++) {
+        if (serialDistances.distances[i] != batchedDistances.distances[i]) {
+            numberOfDifferences++;
+        }
+    }
+
+    cout << "Duration of the serial contraction (in ms): " << durationSerial << endl;
+    cout << "Duration of the batched contraction (in ms): " << durationBatched << endl;
+    cout << "Number of edges serial / batched: " << numberOfEdgesSerial << " / " << numberOfEdgesBatched << endl;
+    cout << "Number of different distances: " << numberOfDifferences << "\n" << endl;
+}
+
+/*
+    Customizes the metric of the network graph and a slower metric with a transfer buffer. Compares the distances of the network metric
+    with the contraction hierarchie of the network graph and checks that the slower metric never returns a shorter distance.
+*/
+void LowerBoundTester::compareCustomizableCH(int numberOfSources, int numberOfTargetsPerSource) {
+    CustomizableCH* customizableCH = Creator::getCustomizableCH();
+
+    auto start = chrono::high_resolution_clock::now();
+    int networkMetricIndex = customizableCH->addMetric({4, 0});
+    auto end = chrono::high_resolution_clock::now();
+    double durationCustomization = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    int slowMetricIndex = customizableCH->addMetric({3, 60});
+
+    int numberOfStops = Creator::networkGraph.vertices.size();
+    int numberOfDifferences = 0;
+    int numberOfShorterDistances = 0;
+    for (int i = 0; i < numberOfSources; i++) {
+        int sourceStopId = rand() % numberOfStops;
+        vector<int> targetStopIds = vector<int>(numberOfTargetsPerSource);
+        for (int j = 0; j < numberOfTargetsPerSource; j++) {
+            targetStopIds[j] = rand() % numberOfStops;
+        }
+
+        vector<int> networkDistances = customizableCH->getDistancesToTargets(networkMetricIndex, sourceStopId, targetStopIds);
+        vector<int> slowDistances = customizableCH->getDistancesToTargets(slowMetricIndex, sourceStopId, targetStopIds);
+        for (int j = 0; j < numberOfTargetsPerSource; j++) {
+            int distance = Creator::networkGraph.getDistanceWithCH(sourceStopId, targetStopIds[j]);
+            if (networkDistances[j] != distance || customizableCH->getDistance(networkMetricIndex, sourceStopId, targetStopIds[j]) != distance) {
+                numberOfDifferences++;
+            }
+            if (slowDistances[j] < networkDistances[j]) {
+                numberOfShorterDistances++;
+            }
+        }
+    }
+
+    cout << "Duration of the customization (in ms): " << durationCustomization << endl;
+    cout << "Number of different distances to the network graph: " << numberOfDifferences << endl;
+    cout << "Number of shorter distances with the slower metric: " << numberOfShorterDistances << "\n" << endl;
 }
\ No newline at end of file
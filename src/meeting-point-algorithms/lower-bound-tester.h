@@ -1,12 +1,19 @@
 #ifndef CMAKE_LOWER_BOUND_TESTER_H
 #define CMAKE_LOWER_BOUND_TESTER_H
 
+#include <vector>
+
+using namespace std;
+
 class LowerBoundTester {
     public:
         explicit LowerBoundTester(){};
         ~LowerBoundTester(){};
 
         static void getLowerBoundDiffs(int numberOfSources, int numberOfTargetsPerSource);
+        static void comparePhastImplementations(vector<int> numberOfSourcesVec, int numberOfRuns);
+        static void compareContractionHierarchieCreation(int numberOfSources);
+        static void compareCustomizableCH(int numberOfSources, int numberOfTargetsPerSource);
 };
 
 #endif //CMAKE_LOWER_BOUND_TESTER_H
\ No newline at end of file
@@ -37,6 +37,25 @@ Journey RaptorQueryEATProcessor::getJourney() {
     return journey;
 }
 
+void TDCHQueryEATProcessor::processTDCHQuery() {
+    TimeDependentGraph* timeDependentGraph = Creator::getTimeDependentGraph();
+
+    auto start = chrono::high_resolution_clock::now();
+    TDQueryResult result = timeDependentGraph->getEarliestArrivalTime(raptorQuery.sourceStopId, raptorQuery.targetStopIds[0], raptorQuery.sourceTime, raptorQuery.weekday);
+    auto end = chrono::high_resolution_clock::now();
+    // the queries take only microseconds
+    raptorQueryResult.queryTime = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+    raptorQueryResult.arrivalTime = TimeConverter::convertSecondsToTime(result.earliestArrivalTime, true);
+    raptorQueryResult.durationInSeconds = result.earliestArrivalTime - raptorQuery.sourceTime;
+
+    numberOfSettledVertices = result.numberOfSettledVertices;
+}
+
+RaptorQueryResult TDCHQueryEATProcessor::getRaptorQueryResult() {
+    return raptorQueryResult;
+}
+
 void RaptorStarBoundQueryProcessor::processRaptorStarBoundQuery() {
     auto start = chrono::high_resolution_clock::now();
     map<int, vector<int>> targetStopIdToAllStops;
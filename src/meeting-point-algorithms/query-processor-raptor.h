@@ -31,6 +31,26 @@ class RaptorQueryEATProcessor {
         shared_ptr<Raptor> raptor;
 };
 
+/*
+    Answers earliest arrival queries with the time dependent contraction hierarchie instead of raptor.
+*/
+class TDCHQueryEATProcessor {
+    public:
+        explicit TDCHQueryEATProcessor(RaptorQuery raptorQuery){
+            this->raptorQuery = raptorQuery;
+        }
+        ~TDCHQueryEATProcessor(){};
+
+        void processTDCHQuery();
+        RaptorQueryResult getRaptorQueryResult();
+
+        int numberOfSettledVertices;
+
+    private:
+        RaptorQuery raptorQuery;
+        RaptorQueryResult raptorQueryResult;
+};
+
 class RaptorStarBoundQueryProcessor {
     public:
         explicit RaptorStarBoundQueryProcessor(RaptorQuery raptorStarQuery){
@@ -22,6 +22,11 @@
 #include <algorithm>
 #include <memory>
 #include <random>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <atomic>
+#include <cfloat>
 
 #include <vector>
 #include <string>
@@ -33,9 +38,10 @@ using namespace std;
     For each source stop, calculate the earliest arrival time for all stops.
     Then calculate the sum of the earliest arrival times for all stops and the maximum earliest arrival time for all stops.
     The stop with the lowest sum and the stop with the highest maximum earliest arrival time are the meeting points.
+    The source stops with a precomputed source profile are answered from the profile instead of running the CSA.
 
 */
-void NaiveQueryProcessor::processNaiveQuery() {
+void NaiveQueryProcessor::processNaiveQuery(bool useSourceProfiles) {
     auto start = std::chrono::high_resolution_clock::now();
 
     // RaptorQueryProcessor raptorQueryProcessor = RaptorQueryProcessor(meetingPointQuery);
@@ -44,7 +50,21 @@ void NaiveQueryProcessor::processNaiveQuery() {
 
     // int maxDepartureTime = meetingPointQuery.sourceTime + meetingPointQueryResultRaptor.minSumDurationInSeconds;
 
+    bool isSourceTimeInQueryDay = meetingPointQuery.sourceTime >= 0 && meetingPointQuery.sourceTime < SECONDS_PER_DAY;
+    profileEarliestArrivalTimes = vector<vector<int>>(meetingPointQuery.sourceStopIds.size());
+    profileNumberOfLegs = vector<vector<int>>(meetingPointQuery.sourceStopIds.size());
+
     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
+        int profileIndex = -1;
+        if (useSourceProfiles && isSourceTimeInQueryDay) {
+            profileIndex = SourceProfileProcessor::getProfileIndex(meetingPointQuery.sourceStopIds[i]);
+        }
+        if (profileIndex != -1) {
+            SourceProfileProcessor::getEarliestArrivalTimes(profileIndex, meetingPointQuery.sourceTime, meetingPointQuery.weekday, profileEarliestArrivalTimes[i], profileNumberOfLegs[i]);
+            csas.push_back(nullptr);
+            continue;
+        }
+
         CSAQuery query;
         query.sourceStopId = meetingPointQuery.sourceStopIds[i];
         query.sourceTime = meetingPointQuery.sourceTime;
@@ -57,7 +77,9 @@ void NaiveQueryProcessor::processNaiveQuery() {
     // Process the CSA algorithm for each source stop
     #pragma omp parallel for
     for (int i = 0; i < csas.size(); i++) {
-        csas[i]->processCSA();
+        if (csas[i] != nullptr) {
+            csas[i]->processCSA();
+        }
     }
 
     int minSum = INT_MAX;
@@ -72,7 +94,7 @@ void NaiveQueryProcessor::processNaiveQuery() {
         int max = 0;
         int arrivalTime = 0;
         for (int j = 0; j < meetingPointQuery.sourceStopIds.size(); j++) {
-            int earliestArrivalTime = csas[j]->getEarliestArrivalTime(i);
+            int earliestArrivalTime = getEarliestArrivalTime(j, i);
             if (earliestArrivalTime == INT_MAX) {
                 sum = INT_MAX;
                 max = INT_MAX;
@@ -111,15 +133,15 @@ void NaiveQueryProcessor::processNaiveQuery() {
         int maxTransfersMinSum = 0;
         int maxTransfersMinMax = 0;
         for (int i = 0; i < csas.size(); i++) {
-            Journey journeyMinSum = csas[i]->createJourney(stopIdMinSum);
-            Journey journeyMinMax = csas[i]->createJourney(stopIdMinMax);
+            int numberOfLegsMinSum = getNumberOfLegs(i, stopIdMinSum);
+            int numberOfLegsMinMax = getNumberOfLegs(i, stopIdMinMax);
 
-            if (journeyMinSum.legs.size() > 1 && journeyMinSum.legs.size() - 1 > maxTransfersMinSum) {
-                maxTransfersMinSum = journeyMinSum.legs.size() - 1;
+            if (numberOfLegsMinSum > 1 && numberOfLegsMinSum - 1 > maxTransfersMinSum) {
+                maxTransfersMinSum = numberOfLegsMinSum - 1;
             }
 
-            if (journeyMinMax.legs.size() > 1 && journeyMinMax.legs.size() - 1 > maxTransfersMinMax) {
-                maxTransfersMinMax = journeyMinMax.legs.size() - 1;
+            if (numberOfLegsMinMax > 1 && numberOfLegsMinMax - 1 > maxTransfersMinMax) {
+                maxTransfersMinMax = numberOfLegsMinMax - 1;
             }
         }
         meetingPointQueryResult.maxTransfersMinSum = maxTransfersMinSum;
@@ -140,7 +162,8 @@ MeetingPointQueryResult NaiveQueryProcessor::getMeetingPointQueryResult() {
 }
 
 /*
-    Get the journeys to a meeting point.
+    Get the journeys to a meeting point. The source profiles don't store the legs, so the csa of a source stop that was
+    answered by its profile is processed when the journeys are requested.
 */
 vector<Journey> NaiveQueryProcessor::getJourneys(Optimization optimization) {
     vector<Journey> journeys;
@@ -151,12 +174,34 @@ vector<Journey> NaiveQueryProcessor::getJourneys(Optimization optimization) {
         targetStopId = meetingPointQueryResult.meetingPointMinMaxStopId;
     }
     for (int i = 0; i < csas.size(); i++) {
+        if (csas[i] == nullptr) {
+            CSAQuery query;
+            query.sourceStopId = meetingPointQuery.sourceStopIds[i];
+            query.sourceTime = meetingPointQuery.sourceTime;
+            query.weekday = meetingPointQuery.weekday;
+            csas[i] = shared_ptr<CSA> (new CSA(query));
+            csas[i]->processCSA();
+        }
         Journey journey = csas[i]->createJourney(targetStopId);
         journeys.push_back(journey);
     }
     return journeys;
 }
 
+int NaiveQueryProcessor::getEarliestArrivalTime(int sourceIndex, int stopId) {
+    if (csas[sourceIndex] == nullptr) {
+        return profileEarliestArrivalTimes[sourceIndex][stopId];
+    }
+    return csas[sourceIndex]->getEarliestArrivalTime(stopId);
+}
+
+int NaiveQueryProcessor::getNumberOfLegs(int sourceIndex, int stopId) {
+    if (csas[sourceIndex] == nullptr) {
+        return profileNumberOfLegs[sourceIndex][stopId];
+    }
+    return csas[sourceIndex]->createJourney(stopId).legs.size();
+}
+
 /*
     Get the stops with a given accuracy.
     Calculate the sum of the earliest arrival times for all source stops and the maximum earliest arrival time for all source stops.
@@ -169,7 +214,7 @@ vector<int> NaiveQueryProcessor::getStopsWithGivenAccuracy(double accuracyBound)
         int sum = 0;
         int max = 0;
         for (int j = 0; j < meetingPointQuery.sourceStopIds.size(); j++) {
-            int earliestArrivalTime = csas[j]->getEarliestArrivalTime(i);
+            int earliestArrivalTime = getEarliestArrivalTime(j, i);
             if (earliestArrivalTime == INT_MAX) {
                 sum = INT_MAX;
                 max = INT_MAX;
@@ -265,7 +310,7 @@ void NaiveKeyStopQueryProcessor::findKeyStops(DataType dataType, vector<int> num
         keyStopsFile.open(filePath, std::ofstream::out);
 
         for (int j = 0; j < numberOfKeyStops; j++) {
-            keyStopsFile << counterStopIdPairs[j].second << "," << Importer::getStopName(counterStopIdPairs[j].second) << "\n";
+            keyStopsFile << Importer::getExternalStopId(counterStopIdPairs[j].second) << "," << Importer::getStopName(counterStopIdPairs[j].second) << "\n";
         }
 
         keyStopsFile.close();
@@ -309,7 +354,7 @@ vector<int> NaiveKeyStopQueryProcessor::getKeyStops(DataType dataType, int numbe
                     parts.push_back(substring);
                 }
 
-                keyStops.push_back(stoi(parts[0]));
+                keyStops.push_back(Importer::getInternalStopId(stoi(parts[0])));
             }
 
             break;
@@ -330,12 +375,27 @@ vector<int> NaiveKeyStopQueryProcessor::getKeyStops(DataType dataType, int numbe
     For each source stop, calculate the earliest arrival time for all key stop.
     Then calculate the sum of the earliest arrival times for all stops and the maximum earliest arrival time for all stops.
     The stop with the lowest sum and the stop with the highest maximum earliest arrival time are the meeting points.
-
+    The source stops with a precomputed source profile are answered from the profile instead of running the CSA.
 */
-void NaiveKeyStopQueryProcessor::processNaiveKeyStopQuery(vector<int> keyStops) {
+void NaiveKeyStopQueryProcessor::processNaiveKeyStopQuery(vector<int> keyStops, bool useSourceProfiles) {
     auto start = std::chrono::high_resolution_clock::now();
 
+    this->keyStops = keyStops;
+    bool isSourceTimeInQueryDay = meetingPointQuery.sourceTime >= 0 && meetingPointQuery.sourceTime < SECONDS_PER_DAY;
+    profileEarliestArrivalTimes = vector<vector<int>>(meetingPointQuery.sourceStopIds.size());
+    profileNumberOfLegs = vector<vector<int>>(meetingPointQuery.sourceStopIds.size());
+
     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
+        int profileIndex = -1;
+        if (useSourceProfiles && isSourceTimeInQueryDay) {
+            profileIndex = SourceProfileProcessor::getProfileIndex(meetingPointQuery.sourceStopIds[i]);
+        }
+        if (profileIndex != -1) {
+            SourceProfileProcessor::getEarliestArrivalTimes(profileIndex, meetingPointQuery.sourceTime, meetingPointQuery.weekday, profileEarliestArrivalTimes[i], profileNumberOfLegs[i]);
+            csas.push_back(nullptr);
+            continue;
+        }
+
         CSAQuery query;
         query.sourceStopId = meetingPointQuery.sourceStopIds[i];
         query.targetStopIds = keyStops;
@@ -348,7 +408,9 @@ void NaiveKeyStopQueryProcessor::processNaiveKeyStopQuery(vector<int> keyStops)
     // Process the CSA algorithm for each source stop
     #pragma omp parallel for
     for (int i = 0; i < csas.size(); i++) {
-        csas[i]->processCSA();
+        if (csas[i] != nullptr) {
+            csas[i]->processCSA();
+        }
     }
 
     int minSum = INT_MAX;
@@ -364,7 +426,7 @@ void NaiveKeyStopQueryProcessor::processNaiveKeyStopQuery(vector<int> keyStops)
         int max = 0;
         int arrivalTime = 0;
         for (int j = 0; j < meetingPointQuery.sourceStopIds.size(); j++) {
-            int earliestArrivalTime = csas[j]->getEarliestArrivalTime(stopId);
+            int earliestArrivalTime = getEarliestArrivalTime(j, stopId);
             if (earliestArrivalTime == INT_MAX) {
                 sum = INT_MAX;
                 max = INT_MAX;
@@ -403,15 +465,15 @@ void NaiveKeyStopQueryProcessor::processNaiveKeyStopQuery(vector<int> keyStops)
         int maxTransfersMinSum = 0;
         int maxTransfersMinMax = 0;
         for (int i = 0; i < csas.size(); i++) {
-            Journey journeyMinSum = csas[i]->createJourney(stopIdMinSum);
-            Journey journeyMinMax = csas[i]->createJourney(stopIdMinMax);
+            int numberOfLegsMinSum = getNumberOfLegs(i, stopIdMinSum);
+            int numberOfLegsMinMax = getNumberOfLegs(i, stopIdMinMax);
 
-            if (journeyMinSum.legs.size() > 1 && journeyMinSum.legs.size() - 1 > maxTransfersMinSum) {
-                maxTransfersMinSum = journeyMinSum.legs.size() - 1;
+            if (numberOfLegsMinSum > 1 && numberOfLegsMinSum - 1 > maxTransfersMinSum) {
+                maxTransfersMinSum = numberOfLegsMinSum - 1;
             }
 
-            if (journeyMinMax.legs.size() > 1 && journeyMinMax.legs.size() - 1 > maxTransfersMinMax) {
-                maxTransfersMinMax = journeyMinMax.legs.size() - 1;
+            if (numberOfLegsMinMax > 1 && numberOfLegsMinMax - 1 > maxTransfersMinMax) {
+                maxTransfersMinMax = numberOfLegsMinMax - 1;
             }
         }
         meetingPointQueryResult.maxTransfersMinSum = maxTransfersMinSum;
@@ -432,7 +494,8 @@ MeetingPointQueryResult NaiveKeyStopQueryProcessor::getMeetingPointQueryResult()
 }
 
 /*
-    Get the journeys to a meeting point.
+    Get the journeys to a meeting point. The csa of a source stop that was answered by its profile is processed when the
+    journeys are requested.
 */
 vector<Journey> NaiveKeyStopQueryProcessor::getJourneys(Optimization optimization) {
     vector<Journey> journeys;
@@ -443,12 +506,35 @@ vector<Journey> NaiveKeyStopQueryProcessor::getJourneys(Optimization optimizatio
         targetStopId = meetingPointQueryResult.meetingPointMinMaxStopId;
     }
     for (int i = 0; i < csas.size(); i++) {
+        if (csas[i] == nullptr) {
+            CSAQuery query;
+            query.sourceStopId = meetingPointQuery.sourceStopIds[i];
+            query.targetStopIds = keyStops;
+            query.sourceTime = meetingPointQuery.sourceTime;
+            query.weekday = meetingPointQuery.weekday;
+            csas[i] = shared_ptr<CSA> (new CSA(query));
+            csas[i]->processCSA();
+        }
         Journey journey = csas[i]->createJourney(targetStopId);
         journeys.push_back(journey);
     }
     return journeys;
 }
 
+int NaiveKeyStopQueryProcessor::getEarliestArrivalTime(int sourceIndex, int stopId) {
+    if (csas[sourceIndex] == nullptr) {
+        return profileEarliestArrivalTimes[sourceIndex][stopId];
+    }
+    return csas[sourceIndex]->getEarliestArrivalTime(stopId);
+}
+
+int NaiveKeyStopQueryProcessor::getNumberOfLegs(int sourceIndex, int stopId) {
+    if (csas[sourceIndex] == nullptr) {
+        return profileNumberOfLegs[sourceIndex][stopId];
+    }
+    return csas[sourceIndex]->createJourney(stopId).legs.size();
+}
+
 /*
     Generate a random meeting point query.
 */
@@ -514,7 +600,7 @@ MeetingPointQuery QueryGenerator::parseMeetingPointQuery(string line, int number
     }
 
     for (int i = 0; i < numberOfSourceStops; i++) {
-        meetingPointQuery.sourceStopIds.push_back(stoi(parts[i]));
+        meetingPointQuery.sourceStopIds.push_back(Importer::getInternalStopId(stoi(parts[i])));
     }
     meetingPointQuery.sourceTime = stoi(parts[numberOfSourceStops]);
     meetingPointQuery.weekday = stoi(parts[numberOfSourceStops + 1]);
@@ -531,8 +617,8 @@ RaptorQuery QueryGenerator::parseRaptorQuery(string line) {
     while (std::getline(ss, substring, ',')) {
         parts.push_back(substring);
     }
-    raptorQuery.sourceStopId = stoi(parts[0]);
-    raptorQuery.targetStopIds.push_back(stoi(parts[1]));
+    raptorQuery.sourceStopId = Importer::getInternalStopId(stoi(parts[0]));
+    raptorQuery.targetStopIds.push_back(Importer::getInternalStopId(stoi(parts[1])));
     raptorQuery.sourceTime = stoi(parts[2]);
     raptorQuery.weekday = stoi(parts[3]);
     return raptorQuery;
@@ -570,7 +656,9 @@ void GTreeQueryProcessor::processGTreeQuery(bool useCSA) {
         csas.push_back(csa);
     }
 
-    queryPointAndNodeToBorderStopDurations = vector<map<int, vector<pair<int, int>>>>(meetingPointQuery.sourceStopIds.size(), map<int, vector<pair<int, int>>>());
+    queryPointAndNodeToBorderStopDurations = vector<vector<vector<int>>>(meetingPointQuery.sourceStopIds.size(), vector<vector<int>>(gTree->nodes.size()));
+    queryPointAndNodeToMinimalDuration = vector<vector<int>>(meetingPointQuery.sourceStopIds.size(), vector<int>(gTree->nodes.size(), -1));
+    timeBucket = gTree->getTimeBucket(meetingPointQuery.sourceTime, meetingPointQuery.weekday);
 
     auto start = std::chrono::high_resolution_clock::now();
 
@@ -582,10 +670,14 @@ void GTreeQueryProcessor::processGTreeQuery(bool useCSA) {
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
-    int totalNumberOfNodes = gTree->nodeOfNodeId.size() * meetingPointQuery.sourceStopIds.size();
+    int totalNumberOfNodes = gTree->nodes.size() * meetingPointQuery.sourceStopIds.size();
     int visitedNodes = 0;
     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-        visitedNodes += queryPointAndNodeToBorderStopDurations[i].size();
+        for (int j = 0; j < queryPointAndNodeToBorderStopDurations[i].size(); j++) {
+            if (!queryPointAndNodeToBorderStopDurations[i][j].empty()) {
+                visitedNodes++;
+            }
+        }
     }
     visitedNodesAvgFraction = (double) visitedNodes / totalNumberOfNodes;
 
@@ -682,9 +774,9 @@ void GTreeQueryProcessor::processGTreeQuery(bool useCSA) {
 
 /*
     Process a G-tree query for a given optimization criteria. If useCSA is true, the CSA algorithm is used to calculate the real durations during the algorithm.
+    The candidate stops are verified one by one in the order of their lower bounds until the next lower bound isn't better than the current best.
 */
 void GTreeQueryProcessor::processGTreeQueryWithOptimization(Optimization optimization, bool useCSA) {
-    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
     int optimalMeetingPointStopId = -1;
     int currentBest = INT_MAX;
 
@@ -694,62 +786,42 @@ void GTreeQueryProcessor::processGTreeQueryWithOptimization(Optimization optimiz
     }
 
     int csaTargetStops = 0;
+    numberOfCandidates = 0;
+    numberOfPrunedCandidates = 0;
 
     // Calculate the initial lower bound of the root node
-    int l = getLowerBoundToNode(gTree->root->nodeId, optimization);
-    pq.push(make_pair(l, gTree->root->nodeId));
+    candidateQueue = priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>>();
+    int l = getLowerBoundToNode(gTree->rootNodeId, optimization);
+    candidateQueue.push(make_pair(l, gTree->rootNodeId));
 
-    // Process the query until the priority queue is empty or the current lower bound is greater than the current best
-    while(!pq.empty()){
-        pair<int, int> current = pq.top();
-        pq.pop();
-        int currentLowerBound = current.first;
-        int currentNodeId = current.second;
+    while (true) {
+        pair<int, int> candidate = getNextCandidateStop(optimization, currentBest, alpha);
+        int stopId = candidate.second;
+        if (stopId == -1) {
+            break;
+        }
 
-        if(currentLowerBound >= currentBest){
+        // Without CSA the lower bound is the approximated costs, so the first candidate is optimal
+        if (!useCSA) {
+            currentBest = candidate.first;
+            optimalMeetingPointStopId = stopId;
             break;
         }
 
-        GNode* currentNode = gTree->nodeOfNodeId[currentNodeId];
-        // Case 1: The current node is a inner node. Calculate the lower bounds of the children and add them to the priority queue.
-        if(currentNode->children.size() > 0){
-            for(int i = 0; i < currentNode->children.size(); i++){
-                GNode* childNode = currentNode->children[i];
-                int childNodeId = childNode->nodeId;
-                int childLowerBound = getLowerBoundToNode(childNodeId, optimization);
-                if (childLowerBound < currentBest * alpha) {
-                    pq.push(make_pair(childLowerBound, childNodeId));
-                }
-            }
-        } 
-        // Case 2: The current node is a leaf node. Calculate the costs to the stops and update the current best if necessary.
-        else {
-            vector<int> reachableTargetStopIds = vector<int>(0);
-            for (int i = 0; i < currentNode->stopIds.size(); i++) {
-                int stopId = currentNode->stopIds[i];
-                int costs = getApproximatedCostsToStop(stopId, optimization);
-                if (costs < currentBest) {
-                    reachableTargetStopIds.push_back(stopId);
-                    if (!useCSA) {
-                        currentBest = costs;
-                        optimalMeetingPointStopId = stopId;
-                    }
-                }
-            }
-            if (useCSA) {
-                processCSAToTargetStops(reachableTargetStopIds, currentBest);
-                #pragma omp parallel for
-                for (int i = 0; i < reachableTargetStopIds.size(); i++) {
-                    int stopId = reachableTargetStopIds[i];
-                    int costs = getCostsToStop(stopId, optimization);
-                    if (costs < currentBest) {
-                        currentBest = costs;
-                        optimalMeetingPointStopId = stopId;
-                    }
-                }
-                csaTargetStops += reachableTargetStopIds.size();
-            }
+        // Calculate the real costs to the candidate, the CSAs continue from their previous state
+        processCSAToTargetStops(vector<int>(1, stopId), currentBest);
+        int costs = getCostsToStop(stopId, optimization);
+        if (costs < currentBest) {
+            currentBest = costs;
+            optimalMeetingPointStopId = stopId;
         }
+        csaTargetStops++;
+    }
+
+    // Only the candidates that failed the bound check are pruned, the candidates left in the queue were never checked
+    double prunedCandidateFraction = 0;
+    if (numberOfCandidates > 0) {
+        prunedCandidateFraction = (double) numberOfPrunedCandidates / numberOfCandidates;
     }
     
     // Set the optimal meeting point stop name
@@ -761,13 +833,66 @@ void GTreeQueryProcessor::processGTreeQueryWithOptimization(Optimization optimiz
         meetingPointQueryResult.meetingPointMinSumStopId = optimalMeetingPointStopId;
         meetingPointQueryResult.meetingPointMinSum = optimalMeetingPointStopName;
         meetingPointQueryGTreeCSAInfo.csaTargetStopFractionMinSum = (double) csaTargetStops / Importer::stops.size();
+        meetingPointQueryGTreeCSAInfo.prunedCandidateFractionMinSum = prunedCandidateFraction;
     } else {
         meetingPointQueryResult.meetingPointMinMaxStopId = optimalMeetingPointStopId;
         meetingPointQueryResult.meetingPointMinMax = optimalMeetingPointStopName;
         meetingPointQueryGTreeCSAInfo.csaTargetStopFractionMinMax = (double) csaTargetStops / Importer::stops.size();
+        meetingPointQueryGTreeCSAInfo.prunedCandidateFractionMinMax = prunedCandidateFraction;
     }
 }
 
+/*
+    Get the next candidate stop and its lower bound from the best first search over the G-tree. Inner nodes are replaced by their children 
+    and leaves by their stops. Returns -1 as stop id if there is no candidate with a lower bound below the current best.
+*/
+pair<int, int> GTreeQueryProcessor::getNextCandidateStop(Optimization optimization, int currentBest, double alpha) {
+    int numberOfNodes = gTree->nodes.size();
+    while (!candidateQueue.empty()) {
+        pair<int, int> current = candidateQueue.top();
+        int currentLowerBound = current.first;
+        int currentId = current.second;
+
+        if (currentLowerBound >= currentBest) {
+            break;
+        }
+        candidateQueue.pop();
+
+        if (currentId >= numberOfNodes) {
+            return make_pair(currentLowerBound, currentId - numberOfNodes);
+        }
+
+        GNode &currentNode = gTree->nodes[currentId];
+        // Case 1: The current node is a inner node. Calculate the lower bounds of the children and add them to the queue.
+        if (currentNode.childNodeIds.size() > 0) {
+            for (int i = 0; i < currentNode.childNodeIds.size(); i++) {
+                int childNodeId = currentNode.childNodeIds[i];
+                int childLowerBound = getLowerBoundToNode(childNodeId, optimization);
+                numberOfCandidates++;
+                if (childLowerBound < currentBest * alpha) {
+                    candidateQueue.push(make_pair(childLowerBound, childNodeId));
+                } else {
+                    numberOfPrunedCandidates++;
+                }
+            }
+        }
+        // Case 2: The current node is a leaf node. Calculate the approximated costs of the stops and add them to the queue.
+        else {
+            for (int i = 0; i < currentNode.stopIds.size(); i++) {
+                int stopId = currentNode.stopIds[i];
+                int costs = getApproximatedCostsToStop(stopId, optimization);
+                numberOfCandidates++;
+                if (costs < currentBest) {
+                    candidateQueue.push(make_pair(costs, numberOfNodes + stopId));
+                } else {
+                    numberOfPrunedCandidates++;
+                }
+            }
+        }
+    }
+    return make_pair(INT_MAX, -1);
+}
+
 /*
     Get the lower bound to a node.
 */
@@ -776,7 +901,11 @@ int GTreeQueryProcessor::getLowerBoundToNode(int nodeId, Optimization optimizati
     vector<int> durations = vector<int>(meetingPointQuery.sourceStopIds.size(), 0);
     #pragma omp parallel for
     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-        durations[i] = gTree->getMinimalDurationToNode(meetingPointQuery.sourceStopIds[i], nodeId, queryPointAndNodeToBorderStopDurations[i]); 
+        int &minimalDuration = queryPointAndNodeToMinimalDuration[i][nodeId];
+        if (minimalDuration == -1) {
+            minimalDuration = gTree->getMinimalDurationToNode(meetingPointQuery.sourceStopIds[i], nodeId, queryPointAndNodeToBorderStopDurations[i], timeBucket);
+        }
+        durations[i] = minimalDuration;
     }
 
     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
@@ -803,7 +932,7 @@ int GTreeQueryProcessor::getApproximatedCostsToStop(int stopId, Optimization opt
     vector<int> durations = vector<int>(meetingPointQuery.sourceStopIds.size(), 0);
     #pragma omp parallel for
     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-        durations[i] = gTree->getMinimalDurationToStop(meetingPointQuery.sourceStopIds[i], stopId, queryPointAndNodeToBorderStopDurations[i]); 
+        durations[i] = gTree->getMinimalDurationToStop(meetingPointQuery.sourceStopIds[i], stopId, queryPointAndNodeToBorderStopDurations[i], timeBucket); 
     }
 
     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
@@ -894,6 +1023,14 @@ void RaptorQueryProcessor::initializeRaptors() {
         raptors.push_back(raptor);
     }
 
+    meetingPointAggregator = make_shared<MeetingPointAggregator>(raptors.size(), meetingPointQuery.sourceTime, meetingPointQuery.objective);
+    for (int i = 0; i < raptors.size(); i++) {
+        for (int j = 0; j < raptors[i]->improvedStopIds.size(); j++) {
+            int stopId = raptors[i]->improvedStopIds[j];
+            meetingPointAggregator->updateArrivalTime(i, stopId, raptors[i]->getEarliestArrivalTime(stopId));
+        }
+    }
+
     transfers = 0;
     lastRoundMinSumDuration = INT_MAX;
     lastRoundMinMaxDuration = INT_MAX;
@@ -928,6 +1065,37 @@ void RaptorQueryProcessor::processRaptorQueryUntilFirstResult() {
     numberOfExpandedRoutes = numberOfExpandedRoutes / raptors.size();
 }
 
+/*
+    Process the raptors until the given number of meeting points is known or all raptors are finished. With a minimum distance 
+    (in km) the meeting points have to be separated like for the pruning bound of the aggregator.
+*/
+void RaptorQueryProcessor::processRaptorQueryUntilNumberOfResults(int numberOfMeetingPoints, Optimization optimization, double minimumDistance) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    initializeRaptors();
+
+    while (true) {
+        bool allFinished = processRaptorRound();
+        if (allFinished) {
+            break;
+        }
+
+        if (meetingPointAggregator->getKthBestDuration(numberOfMeetingPoints, optimization, minimumDistance) != INT_MAX) {
+            break;
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    meetingPointQueryResult.queryTime = duration;
+
+    numberOfExpandedRoutes = 0;
+    for (int i = 0; i < raptors.size(); i++) {
+        numberOfExpandedRoutes += raptors[i]->numberOfExpandedRoutes;
+    }
+    numberOfExpandedRoutes = numberOfExpandedRoutes / raptors.size();
+}
+
 void RaptorQueryProcessor::processRaptorQuery() {
     auto start = std::chrono::high_resolution_clock::now();
 
@@ -1012,59 +1180,27 @@ bool RaptorQueryProcessor::processRaptorRound() {
     if (allFinished) {
         return true;
     }
-    
-    int meetingPointMinSum = -1;
-    int minDurationMinSum = INT_MAX;
-    int meetingTimeMinSum = INT_MAX;
-    multipleResultMinSum = 0;
 
-    int meetingPointMinMax = -1;
-    int minDurationMinMax = INT_MAX;
-    int meetingTimeMinMax = INT_MAX;
-    multipleResultMinMax = 0;
-
-    for (int i = 0; i < Importer::stops.size(); i++) {
-        int durationMinSum = 0;
-        int durationMinMax = 0;
-        int meetingTime;
-        for (int j = 0; j < raptors.size(); j++) {
-            int earliestArrivalTime = raptors[j]->getEarliestArrivalTime(i);
-            if (earliestArrivalTime == INT_MAX) {
-                durationMinSum = INT_MAX;
-                durationMinMax = INT_MAX;
-                break;
-            }
-            int duration = earliestArrivalTime - meetingPointQuery.sourceTime;
-            durationMinSum += duration;
-            if (duration > durationMinMax) {
-                durationMinMax = duration;
-                meetingTime = earliestArrivalTime;
-            }
-        }
-        if (durationMinSum < minDurationMinSum) {
-            meetingPointMinSum = i;
-            minDurationMinSum = durationMinSum;
-            meetingTimeMinSum = meetingTime;
-            multipleResultMinSum = 0;
-        }
-        if (durationMinSum == minDurationMinSum) {
-            multipleResultMinSum += 1;
-        }
-        if (durationMinMax < minDurationMinMax) {
-            meetingPointMinMax = i;
-            minDurationMinMax = durationMinMax;
-            meetingTimeMinMax = meetingTime;
-            multipleResultMinMax = 0;
-        }
-        if (durationMinMax == minDurationMinMax) {
-            multipleResultMinMax += 1;
+    // only the labels that improved in this round change the meeting points
+    for (int i = 0; i < raptors.size(); i++) {
+        for (int j = 0; j < raptors[i]->improvedStopIds.size(); j++) {
+            int stopId = raptors[i]->improvedStopIds[j];
+            meetingPointAggregator->updateArrivalTime(i, stopId, raptors[i]->getEarliestArrivalTime(stopId));
         }
     }
 
+    int meetingPointMinSum = meetingPointAggregator->getMinSumStopId();
+    int minDurationMinSum = meetingPointAggregator->getMinSumDuration();
+    multipleResultMinSum = meetingPointAggregator->getNumberOfMinSumStops();
+
+    int meetingPointMinMax = meetingPointAggregator->getMinMaxStopId();
+    int minDurationMinMax = meetingPointAggregator->getMinMaxDuration();
+    multipleResultMinMax = meetingPointAggregator->getNumberOfMinMaxStops();
+
     if (minDurationMinSum < lastRoundMinSumDuration) {
         meetingPointQueryResult.meetingPointMinSumStopId = meetingPointMinSum;
         meetingPointQueryResult.meetingPointMinSum = Importer::getStopName(meetingPointMinSum);
-        meetingPointQueryResult.meetingTimeMinSum = TimeConverter::convertSecondsToTime(meetingTimeMinSum, true);
+        meetingPointQueryResult.meetingTimeMinSum = TimeConverter::convertSecondsToTime(meetingPointAggregator->getMeetingTime(meetingPointMinSum), true);
         meetingPointQueryResult.minSumDuration = TimeConverter::convertSecondsToTime(minDurationMinSum, false);
         meetingPointQueryResult.minSumDurationInSeconds = minDurationMinSum;
         meetingPointQueryResult.maxTransfersMinSum = transfers;
@@ -1074,7 +1210,7 @@ bool RaptorQueryProcessor::processRaptorRound() {
     if (minDurationMinMax < lastRoundMinMaxDuration) {
         meetingPointQueryResult.meetingPointMinMaxStopId = meetingPointMinMax;
         meetingPointQueryResult.meetingPointMinMax = Importer::getStopName(meetingPointMinMax);
-        meetingPointQueryResult.meetingTimeMinMax = TimeConverter::convertSecondsToTime(meetingTimeMinMax, true);
+        meetingPointQueryResult.meetingTimeMinMax = TimeConverter::convertSecondsToTime(meetingPointAggregator->getMeetingTime(meetingPointMinMax), true);
         meetingPointQueryResult.minMaxDuration = TimeConverter::convertSecondsToTime(minDurationMinMax, false);
         meetingPointQueryResult.minMaxDurationInSeconds = minDurationMinMax;
         meetingPointQueryResult.maxTransfersMinMax = transfers;
@@ -1094,6 +1230,10 @@ MeetingPointQueryResult RaptorQueryProcessor::getMeetingPointQueryResult() {
     return meetingPointQueryResult;
 }
 
+shared_ptr<MeetingPointAggregator> RaptorQueryProcessor::getMeetingPointAggregator() {
+    return meetingPointAggregator;
+}
+
 vector<Journey> RaptorQueryProcessor::getJourneys(Optimization optimization) {
     vector<Journey> journeys;
     int targetStopId;
@@ -1149,45 +1289,23 @@ vector<int> RaptorQueryProcessor::getStopsWithGivenAccuracy(double accuracyBound
     return meetingPointsOverAccuracy;
 }
 
-void RaptorBoundQueryProcessor::processRaptorBoundQuery(Optimization optimization) {
-    map<int, vector<int>> sourceStopIdToAllStops;
+/*
+    Process the raptor bound algorithm. If more than one meeting point is requested, the raptors prune with the duration
+    of the k-th best meeting point. With a minimum distance (in km) between the meeting points the bound is taken from
+    separated meeting points, so k separated results are found if they exist.
+*/
+void RaptorBoundQueryProcessor::processRaptorBoundQuery(Optimization optimization, int numberOfMeetingPoints, double minimumDistance) {
+    PhastDistances phastDistances;
 
     auto start = std::chrono::high_resolution_clock::now();
     if (!USE_LANDMARKS) {
-        sourceStopIdToAllStops = Creator::networkGraph.getDistancesWithPhast(meetingPointQuery.sourceStopIds);
+        phastDistances = Creator::networkGraph.getDistanceMatrixWithPhast(meetingPointQuery.sourceStopIds);
     }
     auto endPhast = std::chrono::high_resolution_clock::now();
     durationPhast = std::chrono::duration_cast<std::chrono::milliseconds>(endPhast - start).count();
 
-    // calculate basic heuristic
-    int basicHeuristic = 0;
-    vector<int> lowerBoundSumPerStopId = vector<int>(meetingPointQuery.sourceStopIds.size(), 0);
-
-    if (meetingPointQuery.sourceStopIds.size() > 2) {
-        for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-            int stopId1 = meetingPointQuery.sourceStopIds[i];
-            for (int j = i+1; j < meetingPointQuery.sourceStopIds.size(); j++) {
-                int stopId2 = meetingPointQuery.sourceStopIds[j];
-                int distance;
-                if (USE_LANDMARKS) {
-                    distance = LandmarkProcessor::getLowerBound(stopId1, stopId2, meetingPointQuery.weekday);
-                } else {
-                    distance = sourceStopIdToAllStops[stopId1][stopId2];
-                }
-                basicHeuristic += distance;
-                lowerBoundSumPerStopId[i] += distance;
-                lowerBoundSumPerStopId[j] += distance;
-            }
-        }
-    }
-
-    // get closest landmark to each source stop
-    vector<int> closestLandmarkPerStopId = vector<int>(meetingPointQuery.sourceStopIds.size(), -1);
-    for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-        int stopId = meetingPointQuery.sourceStopIds[i];
-        int closestLandmark = LandmarkProcessor::getClosestLandmark(stopId);
-        closestLandmarkPerStopId[i] = closestLandmark;
-    }
+    // calculate basic heuristic, the lower bound sums per stop are shared by all raptors
+    shared_ptr<CliqueHeuristic> cliqueHeuristic = make_shared<CliqueHeuristic>(move(phastDistances), meetingPointQuery.sourceStopIds, meetingPointQuery.weekday);
 
     auto startInitRaptorBounds = std::chrono::high_resolution_clock::now();
     raptorBounds = vector<shared_ptr<RaptorBound>>(meetingPointQuery.sourceStopIds.size());
@@ -1200,8 +1318,8 @@ void RaptorBoundQueryProcessor::processRaptorBoundQuery(Optimization optimizatio
         query.sourceTime = meetingPointQuery.sourceTime;
         query.weekday = meetingPointQuery.weekday;
         shared_ptr<RaptorBound> raptorBound = shared_ptr<RaptorBound> (new RaptorBound(query, optimization));
-        int baseHeuristicOfSourceStop = basicHeuristic - lowerBoundSumPerStopId[i];
-        raptorBound->initializeHeuristic(sourceStopIdToAllStops, meetingPointQuery.sourceStopIds, baseHeuristicOfSourceStop, {closestLandmarkPerStopId[i]});
+        raptorBound->initializeHeuristic(cliqueHeuristic, i, meetingPointQuery.sourceStopIds.size());
+        raptorBound->setObjective(meetingPointQuery.objective);
         raptorBounds[i] = raptorBound;
     }
     auto endInitRaptorBounds = std::chrono::high_resolution_clock::now();
@@ -1210,6 +1328,18 @@ void RaptorBoundQueryProcessor::processRaptorBoundQuery(Optimization optimizatio
     auto startRaptorBound = std::chrono::high_resolution_clock::now();
 
     int currentBest = INT_MAX;
+    Optimization boundOptimization = min_max;
+    if (optimization == min_sum) {
+        boundOptimization = min_sum;
+    }
+
+    meetingPointAggregator = make_shared<MeetingPointAggregator>(raptorBounds.size(), meetingPointQuery.sourceTime, meetingPointQuery.objective);
+    for (int i = 0; i < raptorBounds.size(); i++) {
+        for (int j = 0; j < raptorBounds[i]->improvedStopIds.size(); j++) {
+            int stopId = raptorBounds[i]->improvedStopIds[j];
+            meetingPointAggregator->updateArrivalTime(i, stopId, raptorBounds[i]->getEarliestArrivalTime(stopId));
+        }
+    }
 
     while (true) {
         // cout << "current best: " << currentBest << endl;
@@ -1229,28 +1359,17 @@ void RaptorBoundQueryProcessor::processRaptorBoundQuery(Optimization optimizatio
             break;
         }
         
-        for (int i = 0; i < Importer::stops.size(); i++) {
-            int lastRoundBest = 0;
-
-            for (int j = 0; j < raptorBounds.size(); j++) {
-                int earliestArrivalTime = raptorBounds[j]->getEarliestArrivalTime(i);
-                if (earliestArrivalTime == INT_MAX) {
-                    lastRoundBest = INT_MAX;
-                    break;
-                }
-                int duration = earliestArrivalTime - meetingPointQuery.sourceTime;
-                if (optimization == min_sum) {
-                    lastRoundBest += duration;
-                } else {
-                    if (duration > lastRoundBest) {
-                        lastRoundBest = duration;
-                    }
-                }
+        for (int i = 0; i < raptorBounds.size(); i++) {
+            for (int j = 0; j < raptorBounds[i]->improvedStopIds.size(); j++) {
+                int stopId = raptorBounds[i]->improvedStopIds[j];
+                meetingPointAggregator->updateArrivalTime(i, stopId, raptorBounds[i]->getEarliestArrivalTime(stopId));
             }
+        }
 
-            if (lastRoundBest < currentBest) {
-                currentBest = lastRoundBest;
-            }
+        int lastRoundBest = meetingPointAggregator->getKthBestDuration(numberOfMeetingPoints, boundOptimization, minimumDistance);
+
+        if (lastRoundBest < currentBest) {
+            currentBest = lastRoundBest;
         }
     }
 
@@ -1259,53 +1378,28 @@ void RaptorBoundQueryProcessor::processRaptorBoundQuery(Optimization optimizatio
 
     auto startCreateResult = std::chrono::high_resolution_clock::now();
 
-    int minSum = INT_MAX;
-    int minMax = INT_MAX;
-
-    int stopIdMinSum = -1;
-    int stopIdMinMax = -1;
-
-    // Calculate the sum of the earliest arrival times for all stops and the maximum earliest arrival time for all stops
-    for (int i = 0; i < Importer::stops.size(); i++) {
-        int sum = 0;
-        int max = 0;
-        int arrivalTime = 0;
-        for (int j = 0; j < meetingPointQuery.sourceStopIds.size(); j++) {
-            int earliestArrivalTime = raptorBounds[j]->getEarliestArrivalTime(i);
-            if (earliestArrivalTime == INT_MAX) {
-                sum = INT_MAX;
-                max = INT_MAX;
-                break;
-            }
-
-            int duration = earliestArrivalTime - meetingPointQuery.sourceTime;
-            sum += duration;
-            if (duration > max) {
-                max = duration;
-                arrivalTime = earliestArrivalTime;
-            }
-        }
-
-        if (sum < minSum) {
-            meetingPointQueryResult.meetingPointMinSumStopId = i;
-            meetingPointQueryResult.meetingPointMinSum = Importer::getStopName(i);
-            meetingPointQueryResult.meetingTimeMinSum = TimeConverter::convertSecondsToTime(arrivalTime, true);
-            meetingPointQueryResult.minSumMeetingTimeInSeconds = arrivalTime;
-            meetingPointQueryResult.minSumDuration = TimeConverter::convertSecondsToTime(sum, false);
-            meetingPointQueryResult.minSumDurationInSeconds = sum;
-            stopIdMinSum = i;
-            minSum = sum;
-        }
-        if (max < minMax) {
-            meetingPointQueryResult.meetingPointMinMaxStopId = i;
-            meetingPointQueryResult.meetingPointMinMax = Importer::getStopName(i);
-            meetingPointQueryResult.meetingTimeMinMax = TimeConverter::convertSecondsToTime(arrivalTime, true);
-            meetingPointQueryResult.minMaxMeetingTimeInSeconds = arrivalTime;
-            meetingPointQueryResult.minMaxDuration = TimeConverter::convertSecondsToTime(max, false);
-            meetingPointQueryResult.minMaxDurationInSeconds = max;
-            stopIdMinMax = i;
-            minMax = max;
-        }
+    int stopIdMinSum = meetingPointAggregator->getMinSumStopId();
+    int stopIdMinMax = meetingPointAggregator->getMinMaxStopId();
+
+    if (stopIdMinSum != -1) {
+        int sum = meetingPointAggregator->getMinSumDuration();
+        int arrivalTime = meetingPointAggregator->getMeetingTime(stopIdMinSum);
+        meetingPointQueryResult.meetingPointMinSumStopId = stopIdMinSum;
+        meetingPointQueryResult.meetingPointMinSum = Importer::getStopName(stopIdMinSum);
+        meetingPointQueryResult.meetingTimeMinSum = TimeConverter::convertSecondsToTime(arrivalTime, true);
+        meetingPointQueryResult.minSumMeetingTimeInSeconds = arrivalTime;
+        meetingPointQueryResult.minSumDuration = TimeConverter::convertSecondsToTime(sum, false);
+        meetingPointQueryResult.minSumDurationInSeconds = sum;
+    }
+    if (stopIdMinMax != -1) {
+        int max = meetingPointAggregator->getMinMaxDuration();
+        int arrivalTime = meetingPointAggregator->getMeetingTime(stopIdMinMax);
+        meetingPointQueryResult.meetingPointMinMaxStopId = stopIdMinMax;
+        meetingPointQueryResult.meetingPointMinMax = Importer::getStopName(stopIdMinMax);
+        meetingPointQueryResult.meetingTimeMinMax = TimeConverter::convertSecondsToTime(arrivalTime, true);
+        meetingPointQueryResult.minMaxMeetingTimeInSeconds = arrivalTime;
+        meetingPointQueryResult.minMaxDuration = TimeConverter::convertSecondsToTime(max, false);
+        meetingPointQueryResult.minMaxDurationInSeconds = max;
     }
 
     if (stopIdMinSum != -1 && stopIdMinMax != -1) {
@@ -1327,6 +1421,16 @@ void RaptorBoundQueryProcessor::processRaptorBoundQuery(Optimization optimizatio
         meetingPointQueryResult.maxTransfersMinMax = maxTransfersMinMax;
     }
 
+    bestMeetingPoints = vector<CandidateInfo>(0);
+    vector<int> bestStopIds = meetingPointAggregator->getBestStopIds(numberOfMeetingPoints, boundOptimization, minimumDistance);
+    for (int i = 0; i < bestStopIds.size(); i++) {
+        CandidateInfo candidateInfo;
+        candidateInfo.stopId = bestStopIds[i];
+        candidateInfo.duration = meetingPointAggregator->getDuration(bestStopIds[i], boundOptimization);
+        candidateInfo.meetingTime = meetingPointAggregator->getMeetingTime(bestStopIds[i]);
+        bestMeetingPoints.push_back(candidateInfo);
+    }
+
     auto endCreateResult = std::chrono::high_resolution_clock::now();
     durationCreateResult = std::chrono::duration_cast<std::chrono::milliseconds>(endCreateResult - startCreateResult).count();
 
@@ -1358,6 +1462,10 @@ MeetingPointQueryResult RaptorBoundQueryProcessor::getMeetingPointQueryResult()
     return meetingPointQueryResult;
 }
 
+vector<CandidateInfo> RaptorBoundQueryProcessor::getBestMeetingPoints() {
+    return bestMeetingPoints;
+}
+
 vector<Journey> RaptorBoundQueryProcessor::getJourneys(Optimization optimization) {
     vector<Journey> journeys;
     int targetStopId;
@@ -1381,76 +1489,54 @@ vector<CandidateInfo> RaptorBoundQueryProcessor::getStopsAndResultsWithSmallerRe
     } else {
         bestResult = meetingPointQueryResult.minMaxDurationInSeconds;
     }
-    for (int i = 0; i < Importer::stops.size(); i++) {
-        int currentResult = 0;
-        int arrivalTime = 0;
-        for (int j = 0; j < meetingPointQuery.sourceStopIds.size(); j++) {
-            int earliestArrivalTime = raptorBounds[j]->getEarliestArrivalTime(i);
-            if (earliestArrivalTime == INT_MAX) {
-                currentResult = INT_MAX;
-                break;
-            }
-
-            int duration = earliestArrivalTime - meetingPointQuery.sourceTime;
-            if (optimization == min_sum) {
-                currentResult += duration;
-            } else {
-                if (duration > currentResult) {
-                    currentResult = duration;
-                }
-            } 
-
-            if (earliestArrivalTime > arrivalTime) {
-                arrivalTime = earliestArrivalTime;
-            }
-        }
-        if (currentResult == INT_MAX) {
-            continue;
-        }
+    // the candidates are returned in ascending order of their durations
+    vector<int> bestStopIds = meetingPointAggregator->getBestStopIds(25, optimization);
+    for (int i = 0; i < bestStopIds.size(); i++) {
+        int stopId = bestStopIds[i];
+        int currentResult = meetingPointAggregator->getDuration(stopId, optimization);
 
         int difference = currentResult - bestResult;
         double currentRelativeDifference = (double) difference / currentResult;
-        if (currentRelativeDifference < relativeDifference) {
-            CandidateInfo candidateInfo;
-            candidateInfo.stopId = i;
-            candidateInfo.duration = currentResult;
-            candidateInfo.meetingTime = arrivalTime;
-            meetingPointsWithSmallerRelativeDifference.push_back(candidateInfo);
+        if (currentRelativeDifference >= relativeDifference) {
+            break;
         }
-    }
-
-    // sort candidate infos by result and select the top 25 results
-    sort(meetingPointsWithSmallerRelativeDifference.begin(), meetingPointsWithSmallerRelativeDifference.end(), [](const CandidateInfo &a, const CandidateInfo &b) {
-        return a.duration < b.duration;
-    });
 
-    if (meetingPointsWithSmallerRelativeDifference.size() > 25) {
-        meetingPointsWithSmallerRelativeDifference.resize(25);
+        CandidateInfo candidateInfo;
+        candidateInfo.stopId = stopId;
+        candidateInfo.duration = currentResult;
+        candidateInfo.meetingTime = meetingPointAggregator->getMeetingTime(stopId);
+        meetingPointsWithSmallerRelativeDifference.push_back(candidateInfo);
     }
 
     return meetingPointsWithSmallerRelativeDifference;
 }
 
-void RaptorPQQueryProcessor::processRaptorPQQuery(Optimization optimization) {
-    map<int, vector<int>> sourceStopIdToAllStops;
+/*
+    Process the raptor pq algorithm. If more than one meeting point is requested or the query has an objective, the upper bound
+    is the duration of the k-th best meeting point found by the raptors. With a minimum distance (in km) between the meeting points
+    the bound is taken from separated meeting points, so k separated results are found if they exist.
+*/
+void RaptorPQQueryProcessor::processRaptorPQQuery(Optimization optimization, bool useWorkStealing, int numberOfMeetingPoints, double minimumDistance) {
+    PhastDistances phastDistances;
 
     auto start = std::chrono::high_resolution_clock::now();
     if (!USE_LANDMARKS) {
-        sourceStopIdToAllStops = Creator::networkGraph.getDistancesWithPhast(meetingPointQuery.sourceStopIds);
+        phastDistances = Creator::networkGraph.getDistanceMatrixWithPhast(meetingPointQuery.sourceStopIds);
     }
     auto endPhast = std::chrono::high_resolution_clock::now();
     durationPhast = std::chrono::duration_cast<std::chrono::milliseconds>(endPhast - start).count();
     
     auto startRaptorFirstResult = std::chrono::high_resolution_clock::now();
     RaptorQueryProcessor raptorQueryProcessor = RaptorQueryProcessor(meetingPointQuery);
-    raptorQueryProcessor.processRaptorQueryUntilFirstResult();
+    if (numberOfMeetingPoints == 1 && meetingPointQuery.objective == nullptr) {
+        raptorQueryProcessor.processRaptorQueryUntilFirstResult();
+    } else {
+        raptorQueryProcessor.processRaptorQueryUntilNumberOfResults(numberOfMeetingPoints, optimization, minimumDistance);
+    }
     MeetingPointQueryResult meetingPointQueryResultRaptor = raptorQueryProcessor.getMeetingPointQueryResult();
     auto endRaptorFirstResult = std::chrono::high_resolution_clock::now();
     durationRaptorFirstResult = std::chrono::duration_cast<std::chrono::milliseconds>(endRaptorFirstResult - startRaptorFirstResult).count();
 
-    // get closest landmark to each source stop
-    vector<int> closestLandmarkPerStopId = vector<int>(meetingPointQuery.sourceStopIds.size(), -1);
-
     auto initRaptorPQs = std::chrono::high_resolution_clock::now();
     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
         RaptorQuery query;
@@ -1459,106 +1545,99 @@ void RaptorPQQueryProcessor::processRaptorPQQuery(Optimization optimization) {
         query.weekday = meetingPointQuery.weekday;
         shared_ptr<RaptorPQ> raptorPQ = shared_ptr<RaptorPQ> (new RaptorPQ(query, optimization));
         raptorPQs.push_back(raptorPQ);
-
-        int stopId = meetingPointQuery.sourceStopIds[i];
-        int closestLandmark = LandmarkProcessor::getClosestLandmark(stopId);
-        closestLandmarkPerStopId[i] = closestLandmark;
     }
     auto endInitRaptorPQs = std::chrono::high_resolution_clock::now();
     durationInitRaptorPQs = std::chrono::duration_cast<std::chrono::milliseconds>(endInitRaptorPQs - initRaptorPQs).count();
 
-    // calculate basic heuristic
-    int basicHeuristic = 0;
-    vector<int> lowerBoundSumPerStopId = vector<int>(meetingPointQuery.sourceStopIds.size(), 0);
+    // calculate basic heuristic, the lower bound sums per stop are shared by all raptors
+    shared_ptr<CliqueHeuristic> cliqueHeuristic = make_shared<CliqueHeuristic>(move(phastDistances), meetingPointQuery.sourceStopIds, meetingPointQuery.weekday);
 
-    if (meetingPointQuery.sourceStopIds.size() > 2) {
-        for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
-            int stopId1 = meetingPointQuery.sourceStopIds[i];
-            for (int j = i+1; j < meetingPointQuery.sourceStopIds.size(); j++) {
-                int stopId2 = meetingPointQuery.sourceStopIds[j];
-                int distance;
-                if (USE_LANDMARKS) {
-                    distance = LandmarkProcessor::getLowerBound(stopId1, stopId2, meetingPointQuery.weekday);
-                } else {
-                    distance = sourceStopIdToAllStops[stopId1][stopId2];
-                }
-                basicHeuristic += distance;
-                lowerBoundSumPerStopId[i] += distance;
-                lowerBoundSumPerStopId[j] += distance;
-            }
+    // cout << "upper bound min sum: " << meetingPointQueryResultRaptor.minSumDurationInSeconds << ", upper bound min max: " << meetingPointQueryResultRaptor.minMaxDurationInSeconds << endl;
+
+    auto startRaptorPQ = std::chrono::high_resolution_clock::now();
+    int upperBound = meetingPointQueryResultRaptor.minSumDurationInSeconds;
+    if (optimization == min_max) {
+        upperBound = meetingPointQueryResultRaptor.minMaxDurationInSeconds;
+    }
+    if (numberOfMeetingPoints > 1 || meetingPointQuery.objective != nullptr) {
+        upperBound = raptorQueryProcessor.getMeetingPointAggregator()->getKthBestDuration(numberOfMeetingPoints, optimization, minimumDistance);
+        // the raptors are finished if less meeting points exist, the bound must not overflow when the source time is added
+        if (upperBound == INT_MAX) {
+            upperBound = INT_MAX - meetingPointQuery.sourceTime;
         }
     }
 
-    // cout << "upper bound min sum: " << meetingPointQueryResultRaptor.minSumDurationInSeconds << ", upper bound min max: " << meetingPointQueryResultRaptor.minMaxDurationInSeconds << endl;
+    // the shared upper bound only tracks the best meeting point of the unweighted objective, otherwise the fixed bound is used
+    shared_ptr<SharedUpperBound> sharedUpperBound = nullptr;
+    if (useWorkStealing && numberOfMeetingPoints == 1 && meetingPointQuery.objective == nullptr) {
+        sharedUpperBound = make_shared<SharedUpperBound>(raptorPQs.size(), meetingPointQuery.sourceTime, optimization, upperBound);
+    }
 
-    auto startRaptorPQ = std::chrono::high_resolution_clock::now();
     // omp_set_dynamic(0);
     // omp_set_num_threads(4);
     #pragma omp parallel for
     for (int i = 0; i < raptorPQs.size(); i++) {
-        int baseHeuristicOfSourceStop = basicHeuristic - lowerBoundSumPerStopId[i];
-        raptorPQs[i]->initializeHeuristic(sourceStopIdToAllStops, meetingPointQuery.sourceStopIds, baseHeuristicOfSourceStop, {closestLandmarkPerStopId[i]});
-        if (optimization == min_sum) {
-            int upperBound = meetingPointQueryResultRaptor.minSumDurationInSeconds;
-            raptorPQs[i]->setCurrentBest(upperBound);
-        } else {
-            int upperBound = meetingPointQueryResultRaptor.minMaxDurationInSeconds;
-            raptorPQs[i]->setCurrentBest(upperBound);
-        }
+        raptorPQs[i]->initializeHeuristic(cliqueHeuristic, i, meetingPointQuery.sourceStopIds.size());
+        raptorPQs[i]->setObjective(meetingPointQuery.objective);
+        raptorPQs[i]->setCurrentBest(upperBound);
         // raptorPQs[i]->initializeRaptorPQ();
         raptorPQs[i]->transformRaptorToRaptorPQ(raptorQueryProcessor.raptors[i]);
-        raptorPQs[i]->processRaptorPQ();
+        if (sharedUpperBound != nullptr) {
+            for (int j = 0; j < Importer::stops.size(); j++) {
+                int earliestArrivalTime = raptorPQs[i]->getEarliestArrivalTime(j);
+                if (earliestArrivalTime != INT_MAX) {
+                    sharedUpperBound->setArrivalTime(i, j, earliestArrivalTime);
+                }
+            }
+            raptorPQs[i]->setSharedUpperBound(sharedUpperBound);
+        } else if (!useWorkStealing) {
+            raptorPQs[i]->processRaptorPQ();
+        }
+    }
+
+    if (sharedUpperBound != nullptr) {
+        sharedUpperBound->calculateCurrentBest();
+    }
+
+    if (useWorkStealing) {
+        processRaptorPQsWithWorkStealing();
     }
     auto endRaptorPQ = std::chrono::high_resolution_clock::now();
     durationRaptorPQs = std::chrono::duration_cast<std::chrono::milliseconds>(endRaptorPQ - startRaptorPQ).count();
 
     auto startCreateResult = std::chrono::high_resolution_clock::now();
 
-    int minSum = INT_MAX;
-    int minMax = INT_MAX;
-
-    int stopIdMinSum = -1;
-    int stopIdMinMax = -1;
-
-    // Calculate the sum of the earliest arrival times for all stops and the maximum earliest arrival time for all stops
-    for (int i = 0; i < Importer::stops.size(); i++) {
-        int sum = 0;
-        int max = 0;
-        int arrivalTime = 0;
-        for (int j = 0; j < meetingPointQuery.sourceStopIds.size(); j++) {
-            int earliestArrivalTime = raptorPQs[j]->getEarliestArrivalTime(i);
-            if (earliestArrivalTime == INT_MAX) {
-                sum = INT_MAX;
-                max = INT_MAX;
-                break;
-            }
-
-            int duration = earliestArrivalTime - meetingPointQuery.sourceTime;
-            sum += duration;
-            if (duration > max) {
-                max = duration;
-                arrivalTime = earliestArrivalTime;
-            }
+    // Get the meeting points from the stops that were reached by the raptors
+    MeetingPointAggregator meetingPointAggregator = MeetingPointAggregator(raptorPQs.size(), meetingPointQuery.sourceTime, meetingPointQuery.objective);
+    for (int i = 0; i < raptorPQs.size(); i++) {
+        for (int j = 0; j < raptorPQs[i]->reachedStopIds.size(); j++) {
+            int stopId = raptorPQs[i]->reachedStopIds[j];
+            meetingPointAggregator.updateArrivalTime(i, stopId, raptorPQs[i]->getEarliestArrivalTime(stopId));
         }
+    }
 
-        if (sum < minSum) {
-            meetingPointQueryResult.meetingPointMinSumStopId = i;
-            meetingPointQueryResult.meetingPointMinSum = Importer::getStopName(i);
-            meetingPointQueryResult.meetingTimeMinSum = TimeConverter::convertSecondsToTime(arrivalTime, true);
-            meetingPointQueryResult.minSumDuration = TimeConverter::convertSecondsToTime(sum, false);
-            meetingPointQueryResult.minSumDurationInSeconds = sum;
-            stopIdMinSum = i;
-            minSum = sum;
-        }
-        if (max < minMax) {
-            meetingPointQueryResult.meetingPointMinMaxStopId = i;
-            meetingPointQueryResult.meetingPointMinMax = Importer::getStopName(i);
-            meetingPointQueryResult.meetingTimeMinMax = TimeConverter::convertSecondsToTime(arrivalTime, true);
-            meetingPointQueryResult.minMaxDuration = TimeConverter::convertSecondsToTime(max, false);
-            meetingPointQueryResult.minMaxDurationInSeconds = max;
-            stopIdMinMax = i;
-            minMax = max;
-        }
+    int stopIdMinSum = meetingPointAggregator.getMinSumStopId();
+    int stopIdMinMax = meetingPointAggregator.getMinMaxStopId();
+
+    if (stopIdMinSum != -1) {
+        int sum = meetingPointAggregator.getMinSumDuration();
+        int arrivalTime = meetingPointAggregator.getMeetingTime(stopIdMinSum);
+        meetingPointQueryResult.meetingPointMinSumStopId = stopIdMinSum;
+        meetingPointQueryResult.meetingPointMinSum = Importer::getStopName(stopIdMinSum);
+        meetingPointQueryResult.meetingTimeMinSum = TimeConverter::convertSecondsToTime(arrivalTime, true);
+        meetingPointQueryResult.minSumMeetingTimeInSeconds = arrivalTime;
+        meetingPointQueryResult.minSumDuration = TimeConverter::convertSecondsToTime(sum, false);
+        meetingPointQueryResult.minSumDurationInSeconds = sum;
+    }
+    if (stopIdMinMax != -1) {
+        int max = meetingPointAggregator.getMinMaxDuration();
+        int arrivalTime = meetingPointAggregator.getMeetingTime(stopIdMinMax);
+        meetingPointQueryResult.meetingPointMinMaxStopId = stopIdMinMax;
+        meetingPointQueryResult.meetingPointMinMax = Importer::getStopName(stopIdMinMax);
+        meetingPointQueryResult.meetingTimeMinMax = TimeConverter::convertSecondsToTime(arrivalTime, true);
+        meetingPointQueryResult.minMaxMeetingTimeInSeconds = arrivalTime;
+        meetingPointQueryResult.minMaxDuration = TimeConverter::convertSecondsToTime(max, false);
+        meetingPointQueryResult.minMaxDurationInSeconds = max;
     }
 
     if (stopIdMinSum != -1 && stopIdMinMax != -1) {
@@ -1580,6 +1659,20 @@ void RaptorPQQueryProcessor::processRaptorPQQuery(Optimization optimization) {
         meetingPointQueryResult.maxTransfersMinMax = maxTransfersMinMax;
     }
 
+    Optimization resultOptimization = min_sum;
+    if (optimization == min_max) {
+        resultOptimization = min_max;
+    }
+    bestMeetingPoints = vector<CandidateInfo>(0);
+    vector<int> bestStopIds = meetingPointAggregator.getBestStopIds(numberOfMeetingPoints, resultOptimization, minimumDistance);
+    for (int i = 0; i < bestStopIds.size(); i++) {
+        CandidateInfo candidateInfo;
+        candidateInfo.stopId = bestStopIds[i];
+        candidateInfo.duration = meetingPointAggregator.getDuration(bestStopIds[i], resultOptimization);
+        candidateInfo.meetingTime = meetingPointAggregator.getMeetingTime(bestStopIds[i]);
+        bestMeetingPoints.push_back(candidateInfo);
+    }
+
     auto endCreateResult = std::chrono::high_resolution_clock::now();
     durationCreateResult = std::chrono::duration_cast<std::chrono::milliseconds>(endCreateResult - startCreateResult).count();
 
@@ -1636,10 +1729,79 @@ void RaptorPQQueryProcessor::processRaptorPQQuery(Optimization optimization) {
     altHeuristicImprovementFraction = (double) altHeuristicImprovementCounter / (altHeuristicImprovementCounter + noHeuristicImprovementCounter);
 }
 
+/*
+    Process the raptor pqs with several threads. The queued routes of every raptor are handed out in batches, a thread
+    takes a batch of its own raptor if it has routes left and steals a batch of the raptor with the lowest lower bound
+    otherwise, so more threads than sources can work on a query. Several threads traverse batches of the same raptor
+    at once, the raptor guards its labels with its own lock. A raptor is finished when no queued route is below the
+    shared upper bound and none of its batches is still traversed.
+*/
+void RaptorPQQueryProcessor::processRaptorPQsWithWorkStealing() {
+    int numberOfRaptorPQs = raptorPQs.size();
+    mutex schedulerLock;
+    condition_variable schedulerCondition;
+    set<pair<double, int>> availableRaptorPQs;
+    vector<double> lowestLowerBoundPerRaptorPQ(numberOfRaptorPQs, DBL_MAX);
+    vector<int> numberOfBatchesInProgress(numberOfRaptorPQs, 0);
+    int numberOfFinishedRaptorPQs = 0;
+
+    // refreshes the lower bound of a raptor, must be called with the scheduler lock
+    auto updateRaptorPQ = [&](int raptorIndex) {
+        availableRaptorPQs.erase(make_pair(lowestLowerBoundPerRaptorPQ[raptorIndex], raptorIndex));
+        lowestLowerBoundPerRaptorPQ[raptorIndex] = raptorPQs[raptorIndex]->getLowestLowerBound();
+        if (lowestLowerBoundPerRaptorPQ[raptorIndex] != DBL_MAX) {
+            availableRaptorPQs.insert(make_pair(lowestLowerBoundPerRaptorPQ[raptorIndex], raptorIndex));
+        } else if (numberOfBatchesInProgress[raptorIndex] == 0) {
+            numberOfFinishedRaptorPQs++;
+        }
+    };
+
+    for (int i = 0; i < numberOfRaptorPQs; i++) {
+        updateRaptorPQ(i);
+    }
+
+    #pragma omp parallel
+    {
+        int ownIndex = omp_get_thread_num() % numberOfRaptorPQs;
+        unique_lock<mutex> lock(schedulerLock);
+
+        while (true) {
+            schedulerCondition.wait(lock, [&] { return !availableRaptorPQs.empty() || numberOfFinishedRaptorPQs == numberOfRaptorPQs; });
+            if (numberOfFinishedRaptorPQs == numberOfRaptorPQs) {
+                break;
+            }
+
+            // take a batch of the own raptor if it has routes left, otherwise steal from the raptor with the lowest lower bound
+            int raptorIndex = availableRaptorPQs.begin()->second;
+            if (lowestLowerBoundPerRaptorPQ[ownIndex] != DBL_MAX) {
+                raptorIndex = ownIndex;
+            }
+            vector<pair<int, int>> routes = raptorPQs[raptorIndex]->takeRouteBatch(WORK_STEALING_BATCH_SIZE);
+            numberOfBatchesInProgress[raptorIndex]++;
+            updateRaptorPQ(raptorIndex);
+            if (!availableRaptorPQs.empty()) {
+                schedulerCondition.notify_one();
+            }
+            lock.unlock();
+
+            raptorPQs[raptorIndex]->traverseRouteBatch(routes);
+
+            lock.lock();
+            numberOfBatchesInProgress[raptorIndex]--;
+            updateRaptorPQ(raptorIndex);
+            schedulerCondition.notify_all();
+        }
+    }
+}
+
 MeetingPointQueryResult RaptorPQQueryProcessor::getMeetingPointQueryResult() {
     return meetingPointQueryResult;
 }
 
+vector<CandidateInfo> RaptorPQQueryProcessor::getBestMeetingPoints() {
+    return bestMeetingPoints;
+}
+
 vector<Journey> RaptorPQQueryProcessor::getJourneys(Optimization optimization) {
     vector<Journey> journeys;
     int targetStopId;
@@ -1704,52 +1866,31 @@ void RaptorPQParallelQueryProcessor::processRaptorPQParallelQuery(Optimization o
 
     auto startCreateResult = std::chrono::high_resolution_clock::now();
 
-    int minSum = INT_MAX;
-    int minMax = INT_MAX;
-
-    int stopIdMinSum = -1;
-    int stopIdMinMax = -1;
-
-    // Calculate the sum of the earliest arrival times for all stops and the maximum earliest arrival time for all stops
-    for (int i = 0; i < Importer::stops.size(); i++) {
-        int sum = 0;
-        int max = 0;
-        int arrivalTime = 0;
-        vector<int> earliestArrivalTimes = raptorPQParallel->getEarliestArrivalTimes(i);
-        for (int j = 0; j < earliestArrivalTimes.size(); j++) {
-            int earliestArrivalTime = earliestArrivalTimes[j];
-            if (earliestArrivalTime == INT_MAX) {
-                sum = INT_MAX;
-                max = INT_MAX;
-                break;
-            }
-
-            int duration = earliestArrivalTime - meetingPointQuery.sourceTime;
-            sum += duration;
-            if (duration > max) {
-                max = duration;
-                arrivalTime = earliestArrivalTime;
-            }
-        }
-
-        if (sum < minSum) {
-            meetingPointQueryResult.meetingPointMinSumStopId = i;
-            meetingPointQueryResult.meetingPointMinSum = Importer::getStopName(i);
-            meetingPointQueryResult.meetingTimeMinSum = TimeConverter::convertSecondsToTime(arrivalTime, true);
-            meetingPointQueryResult.minSumDuration = TimeConverter::convertSecondsToTime(sum, false);
-            meetingPointQueryResult.minSumDurationInSeconds = sum;
-            stopIdMinSum = i;
-            minSum = sum;
-        }
-        if (max < minMax) {
-            meetingPointQueryResult.meetingPointMinMaxStopId = i;
-            meetingPointQueryResult.meetingPointMinMax = Importer::getStopName(i);
-            meetingPointQueryResult.meetingTimeMinMax = TimeConverter::convertSecondsToTime(arrivalTime, true);
-            meetingPointQueryResult.minMaxDuration = TimeConverter::convertSecondsToTime(max, false);
-            meetingPointQueryResult.minMaxDurationInSeconds = max;
-            stopIdMinMax = i;
-            minMax = max;
-        }
+    // The meeting points were maintained while the raptors improved their labels
+    shared_ptr<MeetingPointAggregator> meetingPointAggregator = raptorPQParallel->meetingPointAggregator;
+
+    int stopIdMinSum = meetingPointAggregator->getMinSumStopId();
+    int stopIdMinMax = meetingPointAggregator->getMinMaxStopId();
+
+    if (stopIdMinSum != -1) {
+        int sum = meetingPointAggregator->getMinSumDuration();
+        int arrivalTime = meetingPointAggregator->getMeetingTime(stopIdMinSum);
+        meetingPointQueryResult.meetingPointMinSumStopId = stopIdMinSum;
+        meetingPointQueryResult.meetingPointMinSum = Importer::getStopName(stopIdMinSum);
+        meetingPointQueryResult.meetingTimeMinSum = TimeConverter::convertSecondsToTime(arrivalTime, true);
+        meetingPointQueryResult.minSumMeetingTimeInSeconds = arrivalTime;
+        meetingPointQueryResult.minSumDuration = TimeConverter::convertSecondsToTime(sum, false);
+        meetingPointQueryResult.minSumDurationInSeconds = sum;
+    }
+    if (stopIdMinMax != -1) {
+        int max = meetingPointAggregator->getMinMaxDuration();
+        int arrivalTime = meetingPointAggregator->getMeetingTime(stopIdMinMax);
+        meetingPointQueryResult.meetingPointMinMaxStopId = stopIdMinMax;
+        meetingPointQueryResult.meetingPointMinMax = Importer::getStopName(stopIdMinMax);
+        meetingPointQueryResult.meetingTimeMinMax = TimeConverter::convertSecondsToTime(arrivalTime, true);
+        meetingPointQueryResult.minMaxMeetingTimeInSeconds = arrivalTime;
+        meetingPointQueryResult.minMaxDuration = TimeConverter::convertSecondsToTime(max, false);
+        meetingPointQueryResult.minMaxDurationInSeconds = max;
     }
 
     if (stopIdMinSum != -1 && stopIdMinMax != -1) {
@@ -1914,6 +2055,9 @@ void RaptorApproximationQueryProcessor::calculateExactSources(int numberOfExactS
 
     vector<int> minimalDistances = vector<int>(meetingPointQuery.sourceStopIds.size(), INT_MAX);
 
+    // the backward searches of all sources are done once, each selected source only needs a forward search
+    CHBuckets sourceBuckets = Creator::networkGraph.createBucketsWithCH(meetingPointQuery.sourceStopIds);
+
     // select a random source
     int randomSource = meetingPointQuery.sourceStopIds[rand() % meetingPointQuery.sourceStopIds.size()];
 
@@ -1921,13 +2065,13 @@ void RaptorApproximationQueryProcessor::calculateExactSources(int numberOfExactS
     int maximumDistance = 0;
 
     // calculate the distance of the random source to all other sources
-    vector<int> distances = Creator::networkGraph.getDistancesWithPhast({randomSource})[randomSource];
+    vector<int> distances = Creator::networkGraph.getDistancesToTargetsWithCH(randomSource, sourceBuckets);
     for (int i = 0; i < meetingPointQuery.sourceStopIds.size(); i++) {
         int sourceId = meetingPointQuery.sourceStopIds[i];
-        minimalDistances[i] = distances[sourceId];
+        minimalDistances[i] = distances[i];
 
-        if (distances[sourceId] > maximumDistance) {
-            maximumDistance = distances[sourceId];
+        if (distances[i] > maximumDistance) {
+            maximumDistance = distances[i];
             nextExactSourceStopId = sourceId;
         }
     }
@@ -1936,18 +2080,18 @@ void RaptorApproximationQueryProcessor::calculateExactSources(int numberOfExactS
         exactSources.push_back(nextExactSourceStopId);
 
         // calculate the distance of the new exact source to all other sources
-        distances = Creator::networkGraph.getDistancesWithPhast({nextExactSourceStopId})[nextExactSourceStopId];
+        distances = Creator::networkGraph.getDistancesToTargetsWithCH(nextExactSourceStopId, sourceBuckets);
         maximumDistance = 0;
 
         for (int j = 0; j < meetingPointQuery.sourceStopIds.size(); j++) {
             int sourceId = meetingPointQuery.sourceStopIds[j];
 
-            if (distances[sourceId] < minimalDistances[j]) {
-                minimalDistances[j] = distances[sourceId];
+            if (distances[j] < minimalDistances[j]) {
+                minimalDistances[j] = distances[j];
             }
 
             if (minimalDistances[j] > maximumDistance) {
-                maximumDistance = distances[sourceId];
+                maximumDistance = minimalDistances[j];
                 nextExactSourceStopId = sourceId;
             }
         }
@@ -12,11 +12,13 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <queue>
 
 struct MeetingPointQuery {
     vector<int> sourceStopIds;
     int sourceTime;
     int weekday;
+    shared_ptr<MeetingPointObjective> objective;
 };
 
 struct MeetingPointQueryResult {
@@ -41,6 +43,8 @@ struct MeetingPointQueryGTreeCSAInfo {
     double csaTargetStopFractionMinSum;
     double csaTargetStopFractionMinMax;
     double csaVisitedConnectionsFraction;
+    double prunedCandidateFractionMinSum;
+    double prunedCandidateFractionMinMax;
 };
 
 struct CandidateInfo {
@@ -59,7 +63,7 @@ class NaiveQueryProcessor {
         };
         ~NaiveQueryProcessor(){};
 
-        void processNaiveQuery();
+        void processNaiveQuery(bool useSourceProfiles = false);
         MeetingPointQueryResult getMeetingPointQueryResult();
         vector<Journey> getJourneys(Optimization optimization);
         vector<int> getStopsWithGivenAccuracy(double accuracyBound);
@@ -68,6 +72,13 @@ class NaiveQueryProcessor {
         MeetingPointQuery meetingPointQuery;
         MeetingPointQueryResult meetingPointQueryResult;
         vector<shared_ptr<CSA>> csas;
+
+        // the results of the source stops that are answered by a source profile (the csa of these sources is a nullptr)
+        vector<vector<int>> profileEarliestArrivalTimes;
+        vector<vector<int>> profileNumberOfLegs;
+
+        int getEarliestArrivalTime(int sourceIndex, int stopId);
+        int getNumberOfLegs(int sourceIndex, int stopId);
 };
 
 class NaiveKeyStopQueryProcessor {
@@ -79,14 +90,22 @@ class NaiveKeyStopQueryProcessor {
 
         static void findKeyStops(DataType dataType, vector<int> numberOfSourceStopsVec, int numberOfQueries, int numberOfKeyStops, double accuracyBound);
         static vector<int> getKeyStops(DataType dataType, int numberOfSourceStops);
-        void processNaiveKeyStopQuery(vector<int> keyStops);
+        void processNaiveKeyStopQuery(vector<int> keyStops, bool useSourceProfiles = false);
         MeetingPointQueryResult getMeetingPointQueryResult();
         vector<Journey> getJourneys(Optimization optimization);
 
     private:
         MeetingPointQuery meetingPointQuery;
         MeetingPointQueryResult meetingPointQueryResult;
+        vector<int> keyStops;
         vector<shared_ptr<CSA>> csas;
+
+        // the results of the source stops that are answered by a source profile (the csa of these sources is a nullptr)
+        vector<vector<int>> profileEarliestArrivalTimes;
+        vector<vector<int>> profileNumberOfLegs;
+
+        int getEarliestArrivalTime(int sourceIndex, int stopId);
+        int getNumberOfLegs(int sourceIndex, int stopId);
 };
 
 /*
@@ -97,6 +116,9 @@ class GTreeQueryProcessor {
         explicit GTreeQueryProcessor(MeetingPointQuery meetingPointQuery, GTree* gTree){
             this->meetingPointQuery = meetingPointQuery;
             this->gTree = gTree;
+            this->timeBucket = -1;
+            this->numberOfCandidates = 0;
+            this->numberOfPrunedCandidates = 0;
         };
         ~GTreeQueryProcessor(){};
 
@@ -111,10 +133,20 @@ class GTreeQueryProcessor {
         MeetingPointQuery meetingPointQuery;
         MeetingPointQueryResult meetingPointQueryResult;
         MeetingPointQueryGTreeCSAInfo meetingPointQueryGTreeCSAInfo;
-        vector<map<int, vector<pair<int, int>>>> queryPointAndNodeToBorderStopDurations;
+        vector<vector<vector<int>>> queryPointAndNodeToBorderStopDurations;
+        // the minimal durations from the query points to the nodes are shared by both optimizations, -1 if not calculated
+        vector<vector<int>> queryPointAndNodeToMinimalDuration;
         vector<shared_ptr<CSA>> csas;
+        // the time bucket of the lower bounds, -1 for the time independent lower bounds
+        int timeBucket;
+        int numberOfCandidates;
+        int numberOfPrunedCandidates;
+
+        // the candidates of the best first search ordered by their lower bounds, stops are stored with the id nodes.size() + stopId
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> candidateQueue;
 
         void processGTreeQueryWithOptimization(Optimization optimization, bool useCSA);
+        pair<int, int> getNextCandidateStop(Optimization optimization, int currentBest, double alpha);
         int getLowerBoundToNode(int nodeId, Optimization optimization);
         int getApproximatedCostsToStop(int stopId, Optimization optimization);
         int getCostsToStop(int stopId, Optimization optimization);
@@ -130,12 +162,14 @@ class RaptorQueryProcessor {
 
         void initializeRaptors();
         void processRaptorQueryUntilFirstResult();
+        void processRaptorQueryUntilNumberOfResults(int numberOfMeetingPoints, Optimization optimization, double minimumDistance = 0);
         void processRaptorQueryUntilResultDoesntImprove(Optimization optimization);
         void processRaptorQuery();
         bool processRaptorRound();
         MeetingPointQueryResult getMeetingPointQueryResult();
         vector<Journey> getJourneys(Optimization optimization);
         vector<int> getStopsWithGivenAccuracy(double accuracyBound);
+        shared_ptr<MeetingPointAggregator> getMeetingPointAggregator();
 
         double durationOfLastRound;
         int transfers;
@@ -149,6 +183,7 @@ class RaptorQueryProcessor {
     private:
         MeetingPointQuery meetingPointQuery;
         MeetingPointQueryResult meetingPointQueryResult;
+        shared_ptr<MeetingPointAggregator> meetingPointAggregator;
         int lastRoundMinSumDuration;
         int lastRoundMinMaxDuration;
 };
@@ -160,9 +195,10 @@ class RaptorBoundQueryProcessor {
         };
         ~RaptorBoundQueryProcessor(){};
 
-        void processRaptorBoundQuery(Optimization optimization);
+        void processRaptorBoundQuery(Optimization optimization, int numberOfMeetingPoints = 1, double minimumDistance = 0);
         vector<CandidateInfo> getStopsAndResultsWithSmallerRelativeDifference(double relativeDifference, Optimization optimization);
         MeetingPointQueryResult getMeetingPointQueryResult();
+        vector<CandidateInfo> getBestMeetingPoints();
         vector<Journey> getJourneys(Optimization optimization);
 
         double numberOfExpandedRoutes;
@@ -181,6 +217,8 @@ class RaptorBoundQueryProcessor {
         MeetingPointQuery meetingPointQuery;
         MeetingPointQueryResult meetingPointQueryResult;
         vector<shared_ptr<RaptorBound>> raptorBounds;
+        shared_ptr<MeetingPointAggregator> meetingPointAggregator;
+        vector<CandidateInfo> bestMeetingPoints;
 };
 
 class RaptorPQQueryProcessor {
@@ -190,8 +228,9 @@ class RaptorPQQueryProcessor {
         };
         ~RaptorPQQueryProcessor(){};
 
-        void processRaptorPQQuery(Optimization optimization);
+        void processRaptorPQQuery(Optimization optimization, bool useWorkStealing = false, int numberOfMeetingPoints = 1, double minimumDistance = 0);
         MeetingPointQueryResult getMeetingPointQueryResult();
+        vector<CandidateInfo> getBestMeetingPoints();
         vector<Journey> getJourneys(Optimization optimization);
 
         double numberOfExpandedRoutes;
@@ -221,6 +260,9 @@ class RaptorPQQueryProcessor {
         MeetingPointQuery meetingPointQuery;
         MeetingPointQueryResult meetingPointQueryResult;
         vector<shared_ptr<RaptorPQ>> raptorPQs;
+        vector<CandidateInfo> bestMeetingPoints;
+
+        void processRaptorPQsWithWorkStealing();
 };
 
 class RaptorPQParallelQueryProcessor {
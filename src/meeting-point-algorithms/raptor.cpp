@@ -2,7 +2,9 @@
 
 #include "../data-handling/importer.h"
 #include "../data-handling/converter.h"
+#include "../data-handling/calculator.h"
 #include "landmark-processor.h"
+#include "../data-structures/creator.h"
 #include "journey.h"
 #include "optimization.h"
 #include "../constants.h"
@@ -20,20 +22,600 @@
 
 #include <iostream>
 
-void Raptor::setTargetStopIds(vector<int> targetStopIds) {
+template <typename TimeLabels>
+void BasicRaptor<TimeLabels>::setTargetStopIds(vector<int> targetStopIds) {
     this->query.targetStopIds = targetStopIds;
 }
 
-void Raptor::initializeRaptor() {
+/*
+    Prepare the clique heuristic of a meeting point query. The lower bounds of the sources are taken from the
+    phast distance matrix or, if landmarks are used, from the closest landmark of each source.
+*/
+CliqueHeuristic::CliqueHeuristic(PhastDistances phastDistances, vector<int> sourceStopIds, int weekday) {
+    this->sourceStopIds = sourceStopIds;
+    this->numberOfSourceStopIds = sourceStopIds.size();
+    this->phastDistances = move(phastDistances);
+
+    closestLandmarkPerSource = vector<int>(numberOfSourceStopIds, -1);
+    if (USE_LANDMARKS) {
+        for (int i = 0; i < numberOfSourceStopIds; i++) {
+            closestLandmarkPerSource[i] = LandmarkProcessor::getClosestLandmark(sourceStopIds[i]);
+        }
+    }
+
+    // calculate basic heuristic
+    basicHeuristic = 0;
+    lowerBoundSumPerSource = vector<int>(numberOfSourceStopIds, 0);
+
+    if (numberOfSourceStopIds > 2) {
+        // the lower bounds between the sources are looked up in the phast distance matrix, which contains all stops
+        for (int i = 0; i < numberOfSourceStopIds; i++) {
+            for (int j = i+1; j < numberOfSourceStopIds; j++) {
+                int distance;
+                if (USE_LANDMARKS) {
+                    distance = LandmarkProcessor::getLowerBound(sourceStopIds[i], sourceStopIds[j], weekday);
+                } else {
+                    distance = getLowerBoundToStop(i, sourceStopIds[j]);
+                }
+                basicHeuristic += distance;
+                lowerBoundSumPerSource[i] += distance;
+                lowerBoundSumPerSource[j] += distance;
+            }
+        }
+    }
+
+    lowerBoundSumPerStopId = vector<atomic<int>>(Importer::stops.size());
+    for (int i = 0; i < lowerBoundSumPerStopId.size(); i++) {
+        lowerBoundSumPerStopId[i].store(-1, memory_order_relaxed);
+    }
+}
+
+/*
+    Returns the sum of the lower bounds between all pairs of sources that don't contain the given source.
+*/
+int CliqueHeuristic::getBaseHeuristic(int sourceIndex) {
+    return basicHeuristic - lowerBoundSumPerSource[sourceIndex];
+}
+
+/*
+    Returns the clique heuristic of a stop for the raptor of the given source. The sum of the lower bounds of all sources
+    is calculated once per stop and shared by all raptors, each raptor only subtracts its own term.
+*/
+int CliqueHeuristic::getHeuristic(int sourceIndex, int stopId) {
+    int lowerBoundSum = lowerBoundSumPerStopId[stopId].load(memory_order_relaxed);
+    if (lowerBoundSum == -1) {
+        lowerBoundSum = 0;
+        for (int i = 0; i < numberOfSourceStopIds; i++) {
+            int lowerBoundToStop = getLowerBoundToStop(i, stopId);
+            if (lowerBoundToStop == INT_MAX) {
+                continue;
+            }
+            lowerBoundSum += lowerBoundToStop;
+        }
+        lowerBoundSumPerStopId[stopId].store(lowerBoundSum, memory_order_relaxed);
+    }
+
+    int ownLowerBound = getLowerBoundToStop(sourceIndex, stopId);
+    if (ownLowerBound != INT_MAX) {
+        lowerBoundSum -= ownLowerBound;
+    }
+
+    double heuristic = (double) getBaseHeuristic(sourceIndex) + lowerBoundSum;
+    return heuristic / (numberOfSourceStopIds - 1);
+}
+
+int CliqueHeuristic::getLowerBoundToStop(int sourceIndex, int stopId) {
+    if (USE_LANDMARKS) {
+        return LandmarkProcessor::getLowerBoundUsingLandmarks(sourceStopIds[sourceIndex], stopId, {closestLandmarkPerSource[sourceIndex]});
+    }
+    return phastDistances.distances[stopId * numberOfSourceStopIds + sourceIndex];
+}
+
+/*
+    Upper bound of a meeting point query that is shared by raptors running in different threads. Each raptor publishes
+    its improved arrival times, a stop that is reached by all sources yields a new candidate for the upper bound.
+*/
+SharedUpperBound::SharedUpperBound(int numberOfSourceStopIds, int sourceTime, Optimization optimization, int upperBound) {
+    this->numberOfSourceStopIds = numberOfSourceStopIds;
+    this->sourceTime = sourceTime;
+    this->optimization = optimization;
+
+    arrivalTimesPerStopIdAndSource = vector<atomic<int>>(Importer::stops.size() * numberOfSourceStopIds);
+    for (int i = 0; i < arrivalTimesPerStopIdAndSource.size(); i++) {
+        arrivalTimesPerStopIdAndSource[i].store(INT_MAX, memory_order_relaxed);
+    }
+    currentBest.store(upperBound);
+}
+
+int SharedUpperBound::getCurrentBest() {
+    return currentBest.load(memory_order_relaxed);
+}
+
+/*
+    Stores the arrival time without updating the current best. Used to seed the arrival times of all raptors,
+    the current best is calculated once afterwards.
+*/
+void SharedUpperBound::setArrivalTime(int sourceIndex, int stopId, int arrivalTime) {
+    arrivalTimesPerStopIdAndSource[stopId * numberOfSourceStopIds + sourceIndex].store(arrivalTime, memory_order_relaxed);
+}
+
+/*
+    Calculates the current best from the stored arrival times of all stops.
+*/
+void SharedUpperBound::calculateCurrentBest() {
+    int best = currentBest.load(memory_order_relaxed);
+    for (int stopId = 0; stopId < Importer::stops.size(); stopId++) {
+        int index = stopId * numberOfSourceStopIds;
+        int sum = 0;
+        int max = 0;
+        bool isReachedByAllSources = true;
+        for (int i = 0; i < numberOfSourceStopIds; i++) {
+            int earliestArrivalTime = arrivalTimesPerStopIdAndSource[index + i].load(memory_order_relaxed);
+            if (earliestArrivalTime == INT_MAX) {
+                isReachedByAllSources = false;
+                break;
+            }
+            int duration = earliestArrivalTime - sourceTime;
+            sum += duration;
+            if (duration > max) {
+                max = duration;
+            }
+        }
+        if (!isReachedByAllSources) {
+            continue;
+        }
+
+        int candidate = sum;
+        if (optimization == min_max) {
+            candidate = max;
+        }
+        if (candidate < best) {
+            best = candidate;
+        }
+    }
+    currentBest.store(best, memory_order_relaxed);
+}
+
+void SharedUpperBound::updateArrivalTime(int sourceIndex, int stopId, int arrivalTime) {
+    int index = stopId * numberOfSourceStopIds;
+    arrivalTimesPerStopIdAndSource[index + sourceIndex].store(arrivalTime, memory_order_relaxed);
+
+    int sum = 0;
+    int max = 0;
+    for (int i = 0; i < numberOfSourceStopIds; i++) {
+        int earliestArrivalTime = arrivalTimesPerStopIdAndSource[index + i].load(memory_order_relaxed);
+        if (earliestArrivalTime == INT_MAX) {
+            return;
+        }
+        int duration = earliestArrivalTime - sourceTime;
+        sum += duration;
+        if (duration > max) {
+            max = duration;
+        }
+    }
+
+    int candidate = sum;
+    if (optimization == min_max) {
+        candidate = max;
+    }
+
+    int best = currentBest.load(memory_order_relaxed);
+    while (candidate < best && !currentBest.compare_exchange_weak(best, candidate, memory_order_relaxed)) {}
+}
+
+/*
+    Objective of a meeting point query with weights, deadlines and candidate stops. The duration of a source is multiplied
+    with its weight, a source has to arrive at the meeting point until its latest arrival time and only the candidate stops
+    are valid meeting points. Empty vectors mean that all weights are one, that there are no deadlines or that all stops are candidates.
+*/
+MeetingPointObjective::MeetingPointObjective(vector<double> weightPerSource, vector<int> latestArrivalTimePerSource, vector<int> candidateStopIds) {
+    // the durations are divided by the weights to get the arrival time limits, so only positive weights are valid
+    for (int i = 0; i < weightPerSource.size(); i++) {
+        if (weightPerSource[i] <= 0) {
+            cout << "Invalid weight " << weightPerSource[i] << " for source " << i << ". The weights must be positive, the weight is set to 1." << endl;
+            weightPerSource[i] = 1;
+        }
+    }
+
+    this->weightPerSource = weightPerSource;
+    this->latestArrivalTimePerSource = latestArrivalTimePerSource;
+
+    minimumWeight = 1;
+    if (weightPerSource.size() > 0) {
+        minimumWeight = *min_element(weightPerSource.begin(), weightPerSource.end());
+    }
+
+    isCandidatePerStopId = vector<bool>(Importer::stops.size(), candidateStopIds.size() == 0);
+    for (int i = 0; i < candidateStopIds.size(); i++) {
+        isCandidatePerStopId[candidateStopIds[i]] = true;
+    }
+}
+
+double MeetingPointObjective::getWeight(int sourceIndex) {
+    if (weightPerSource.size() == 0) {
+        return 1;
+    }
+    return weightPerSource[sourceIndex];
+}
+
+int MeetingPointObjective::getLatestArrivalTime(int sourceIndex) {
+    if (latestArrivalTimePerSource.size() == 0) {
+        return INT_MAX;
+    }
+    return latestArrivalTimePerSource[sourceIndex];
+}
+
+bool MeetingPointObjective::isCandidate(int stopId) {
+    return isCandidatePerStopId[stopId];
+}
+
+/*
+    Returns the weighted duration of a source. It is rounded up, so the bounds derived from it stay valid.
+*/
+int MeetingPointObjective::getDuration(int sourceIndex, int duration) {
+    if (weightPerSource.size() == 0) {
+        return duration;
+    }
+    return ceil(weightPerSource[sourceIndex] * duration);
+}
+
+/*
+    Returns the lower bound of the objective for a stop that is reached by the given source. The clique heuristic bounds the
+    durations of the other sources, they are weighted with the smallest weight. Stops that are reached after the deadline
+    of the source can't lead to a valid meeting point.
+*/
+double MeetingPointObjective::getLowerBound(int sourceIndex, int arrivalTime, int sourceTime, double heuristic, int numberOfSourceStopIds, Optimization optimization) {
+    if (arrivalTime > getLatestArrivalTime(sourceIndex)) {
+        return DBL_MAX;
+    }
+
+    double lowerBound = getWeight(sourceIndex) * (arrivalTime - sourceTime);
+    double otherSources = minimumWeight * heuristic;
+
+    if (optimization == min_max) {
+        double secondPart = (lowerBound + otherSources) / numberOfSourceStopIds;
+        return max(lowerBound, secondPart);
+    }
+    return lowerBound + otherSources;
+}
+
+/*
+    Returns the arrival time from which on a label of the source can't improve the upper bound or misses the deadline.
+    The weighted duration of a source is never greater than the sum or the maximum of all weighted durations.
+*/
+int MeetingPointObjective::getArrivalTimeLimit(int sourceIndex, int sourceTime, int upperBound) {
+    int arrivalTimeLimit = getLatestArrivalTime(sourceIndex);
+    if (arrivalTimeLimit != INT_MAX) {
+        arrivalTimeLimit++;
+    }
+
+    if (upperBound != INT_MAX) {
+        double weightedLimit = ceil(sourceTime + upperBound / getWeight(sourceIndex));
+        if (weightedLimit < arrivalTimeLimit) {
+            arrivalTimeLimit = weightedLimit;
+        }
+    }
+    return arrivalTimeLimit;
+}
+
+FullTimeLabels::FullTimeLabels(int numberOfLabels, int baseTime) {
+    labels = vector<int>(numberOfLabels, INT_MAX);
+}
+
+int& FullTimeLabels::operator[](int index) {
+    return labels[index];
+}
+
+vector<int> FullTimeLabels::getTimes() {
+    return labels;
+}
+
+/*
+    Returns the memory of the labels in bytes.
+*/
+size_t FullTimeLabels::getMemoryUsage() {
+    return labels.size() * sizeof(int);
+}
+
+CompactTimeLabels::CompactTimeLabels(int numberOfLabels, int baseTime) {
+    this->baseTime = baseTime;
+    labels = vector<unsigned char>(3 * (size_t) numberOfLabels, 0xFF);
+}
+
+CompactTimeLabels::Reference CompactTimeLabels::operator[](int index) {
+    return Reference(this, index);
+}
+
+CompactTimeLabels::Reference::operator int() const {
+    return timeLabels->get(index);
+}
+
+CompactTimeLabels::Reference& CompactTimeLabels::Reference::operator=(int time) {
+    timeLabels->set(index, time);
+    return *this;
+}
+
+CompactTimeLabels::Reference& CompactTimeLabels::Reference::operator=(const Reference& other) {
+    timeLabels->set(index, other.timeLabels->get(other.index));
+    return *this;
+}
+
+vector<int> CompactTimeLabels::getTimes() {
+    int numberOfLabels = labels.size() / 3;
+    vector<int> times = vector<int>(numberOfLabels);
+    for (int i = 0; i < numberOfLabels; i++) {
+        times[i] = get(i);
+    }
+    return times;
+}
+
+/*
+    Returns the memory of the labels in bytes.
+*/
+size_t CompactTimeLabels::getMemoryUsage() {
+    return labels.size();
+}
+
+int CompactTimeLabels::get(int index) {
+    size_t position = 3 * (size_t) index;
+    int relativeTime = labels[position] | (labels[position + 1] << 8) | (labels[position + 2] << 16);
+    if (relativeTime == COMPACT_LABEL_UNREACHED) {
+        return INT_MAX;
+    }
+    return baseTime + relativeTime;
+}
+
+void CompactTimeLabels::set(int index, int time) {
+    int relativeTime = COMPACT_LABEL_UNREACHED;
+    if (time != INT_MAX) {
+        relativeTime = min(time - baseTime, COMPACT_LABEL_UNREACHED - 1);
+    }
+    size_t position = 3 * (size_t) index;
+    labels[position] = relativeTime & 0xFF;
+    labels[position + 1] = (relativeTime >> 8) & 0xFF;
+    labels[position + 2] = (relativeTime >> 16) & 0xFF;
+}
+
+/*
+    Maintains the sum and the maximum of the durations per stop while the labels of the raptors improve. The best meeting
+    points are updated with every improved label, so no scan over all stops and sources is needed to get the result.
+    If an objective is given, the durations are weighted and only the candidate stops that are reached before the deadlines are meeting points.
+*/
+MeetingPointAggregator::MeetingPointAggregator(int numberOfSourceStopIds, int sourceTime, shared_ptr<MeetingPointObjective> objective) {
+    this->numberOfSourceStopIds = numberOfSourceStopIds;
+    this->sourceTime = sourceTime;
+    this->objective = objective;
+
+    arrivalTimesPerStopIdAndSource = ArrivalTimeLabels(Importer::stops.size() * numberOfSourceStopIds, sourceTime);
+    reachedCounterPerStopId = vector<int>(Importer::stops.size(), 0);
+    sumPerStopId = vector<int>(Importer::stops.size(), 0);
+    maxPerStopId = vector<int>(Importer::stops.size(), 0);
+
+    minSumStopId = -1;
+    minSumDuration = INT_MAX;
+    numberOfMinSumStops = 0;
+    minMaxStopId = -1;
+    minMaxDuration = INT_MAX;
+    numberOfMinMaxStops = 0;
+}
+
+void MeetingPointAggregator::updateArrivalTime(int sourceIndex, int stopId, int arrivalTime) {
+    if (objective != nullptr && (!objective->isCandidate(stopId) || arrivalTime > objective->getLatestArrivalTime(sourceIndex))) {
+        return;
+    }
+
+    int index = stopId * numberOfSourceStopIds;
+    int previousArrivalTime = arrivalTimesPerStopIdAndSource[index + sourceIndex];
+    if (arrivalTime >= previousArrivalTime) {
+        return;
+    }
+    arrivalTimesPerStopIdAndSource[index + sourceIndex] = arrivalTime;
+
+    bool wasReachedByAllSources = reachedCounterPerStopId[stopId] == numberOfSourceStopIds;
+    int previousSum = sumPerStopId[stopId];
+    int previousMax = maxPerStopId[stopId];
+
+    int duration = getDurationOfSource(sourceIndex, arrivalTime);
+    if (previousArrivalTime == INT_MAX) {
+        reachedCounterPerStopId[stopId]++;
+        sumPerStopId[stopId] += duration;
+        if (duration > maxPerStopId[stopId]) {
+            maxPerStopId[stopId] = duration;
+        }
+    } else {
+        int previousDuration = getDurationOfSource(sourceIndex, previousArrivalTime);
+        sumPerStopId[stopId] -= previousDuration - duration;
+        if (previousDuration == maxPerStopId[stopId]) {
+            // the maximum may belong to the improved source, so it has to be recalculated
+            int max = 0;
+            for (int i = 0; i < numberOfSourceStopIds; i++) {
+                int earliestArrivalTime = arrivalTimesPerStopIdAndSource[index + i];
+                if (earliestArrivalTime != INT_MAX && getDurationOfSource(i, earliestArrivalTime) > max) {
+                    max = getDurationOfSource(i, earliestArrivalTime);
+                }
+            }
+            maxPerStopId[stopId] = max;
+        }
+    }
+
+    if (reachedCounterPerStopId[stopId] < numberOfSourceStopIds) {
+        return;
+    }
+
+    // a stop whose duration did not change is already counted and ordered
+    if (!wasReachedByAllSources || sumPerStopId[stopId] != previousSum) {
+        if (wasReachedByAllSources) {
+            minSumCandidates.erase(make_pair(previousSum, stopId));
+        }
+        minSumCandidates.insert(make_pair(sumPerStopId[stopId], stopId));
+        updateBest(stopId, sumPerStopId[stopId], minSumStopId, minSumDuration, numberOfMinSumStops);
+    }
+    if (!wasReachedByAllSources || maxPerStopId[stopId] != previousMax) {
+        if (wasReachedByAllSources) {
+            minMaxCandidates.erase(make_pair(previousMax, stopId));
+        }
+        minMaxCandidates.insert(make_pair(maxPerStopId[stopId], stopId));
+        updateBest(stopId, maxPerStopId[stopId], minMaxStopId, minMaxDuration, numberOfMinMaxStops);
+    }
+}
+
+/*
+    The durations of a stop only decrease, so the best duration is a running minimum. Ties are resolved by the smallest
+    stop id like a scan over all stops would do. A stop must only be passed again if its duration decreased, otherwise
+    it would be counted twice.
+*/
+void MeetingPointAggregator::updateBest(int stopId, int duration, int &bestStopId, int &bestDuration, int &numberOfBestStops) {
+    if (duration < bestDuration) {
+        bestStopId = stopId;
+        bestDuration = duration;
+        numberOfBestStops = 1;
+    } else if (duration == bestDuration) {
+        if (stopId < bestStopId) {
+            bestStopId = stopId;
+        }
+        numberOfBestStops++;
+    }
+}
+
+int MeetingPointAggregator::getMinSumStopId() {
+    return minSumStopId;
+}
+
+int MeetingPointAggregator::getMinSumDuration() {
+    return minSumDuration;
+}
+
+int MeetingPointAggregator::getNumberOfMinSumStops() {
+    return numberOfMinSumStops;
+}
+
+int MeetingPointAggregator::getMinMaxStopId() {
+    return minMaxStopId;
+}
+
+int MeetingPointAggregator::getMinMaxDuration() {
+    return minMaxDuration;
+}
+
+int MeetingPointAggregator::getNumberOfMinMaxStops() {
+    return numberOfMinMaxStops;
+}
+
+/*
+    Returns the arrival time of the last source at the stop.
+*/
+int MeetingPointAggregator::getMeetingTime(int stopId) {
+    if (reachedCounterPerStopId[stopId] < numberOfSourceStopIds) {
+        return INT_MAX;
+    }
+    if (objective == nullptr) {
+        return maxPerStopId[stopId] + sourceTime;
+    }
+
+    // the maximum is weighted, so the latest arrival time is taken from the labels
+    int meetingTime = 0;
+    for (int i = 0; i < numberOfSourceStopIds; i++) {
+        int arrivalTime = arrivalTimesPerStopIdAndSource[stopId * numberOfSourceStopIds + i];
+        meetingTime = max(meetingTime, arrivalTime);
+    }
+    return meetingTime;
+}
+
+int MeetingPointAggregator::getDurationOfSource(int sourceIndex, int arrivalTime) {
+    if (objective == nullptr) {
+        return arrivalTime - sourceTime;
+    }
+    return objective->getDuration(sourceIndex, arrivalTime - sourceTime);
+}
+
+int MeetingPointAggregator::getDuration(int stopId, Optimization optimization) {
+    if (reachedCounterPerStopId[stopId] < numberOfSourceStopIds) {
+        return INT_MAX;
+    }
+    if (optimization == min_max) {
+        return maxPerStopId[stopId];
+    }
+    return sumPerStopId[stopId];
+}
+
+/*
+    Returns the stops with the smallest durations in ascending order. The candidates are ordered by their current duration,
+    so only the returned stops and the skipped ones are visited. If a minimum distance (in km) is given, a stop is skipped
+    if it is closer than this distance to a stop that was already chosen.
+*/
+vector<int> MeetingPointAggregator::getBestStopIds(int numberOfStops, Optimization optimization, double minimumDistance) {
+    set<pair<int, int>>* candidates = &minSumCandidates;
+    if (optimization == min_max) {
+        candidates = &minMaxCandidates;
+    }
+
+    vector<int> bestStopIds;
+    for (auto it = candidates->begin(); it != candidates->end() && bestStopIds.size() < numberOfStops; it++) {
+        pair<int, int> candidate = *it;
+
+        bool isSeparated = true;
+        if (minimumDistance > 0) {
+            Stop stop = Importer::stops[candidate.second];
+            for (int i = 0; i < bestStopIds.size(); i++) {
+                Stop bestStop = Importer::stops[bestStopIds[i]];
+                if (DistanceCalculator::calculateDistance(stop.lat, stop.lon, bestStop.lat, bestStop.lon) < minimumDistance) {
+                    isSeparated = false;
+                    break;
+                }
+            }
+        }
+        if (isSeparated) {
+            bestStopIds.push_back(candidate.second);
+        }
+    }
+
+    return bestStopIds;
+}
+
+/*
+    Returns the duration of the k-th best meeting point or INT_MAX if less than k meeting points are known.
+    It is used as upper bound if the k best meeting points are requested. If a minimum distance (in km) is given, the bound is 
+    the duration of the k-th stop that is chosen with twice this distance. A meeting point of the result is closer than the 
+    minimum distance to at most one of these stops, so the result always contains k meeting points within the bound.
+*/
+int MeetingPointAggregator::getKthBestDuration(int k, Optimization optimization, double minimumDistance) {
+    if (minimumDistance > 0 && k > 1) {
+        vector<int> separatedStopIds = getBestStopIds(k, optimization, 2 * minimumDistance);
+        if (separatedStopIds.size() < k) {
+            return INT_MAX;
+        }
+        return getDuration(separatedStopIds[k - 1], optimization);
+    }
+
+    if (k == 1) {
+        if (optimization == min_max) {
+            return minMaxDuration;
+        }
+        return minSumDuration;
+    }
+
+    set<pair<int, int>>* candidates = &minSumCandidates;
+    if (optimization == min_max) {
+        candidates = &minMaxCandidates;
+    }
+    if (candidates->size() < k) {
+        return INT_MAX;
+    }
+    return next(candidates->begin(), k - 1)->first;
+}
+
+template <typename TimeLabels>
+void BasicRaptor<TimeLabels>::initializeRaptor() {
     currentRound = 0;
 
-    previousEarliestArrivalTimes = vector<int>(Importer::stops.size(), INT_MAX);
-    currentEarliestArrivalTimes = vector<int>(Importer::stops.size(), INT_MAX);
+    previousEarliestArrivalTimes = TimeLabels(Importer::stops.size(), query.sourceTime);
+    currentEarliestArrivalTimes = TimeLabels(Importer::stops.size(), query.sourceTime);
     previousMarkedStops = vector<bool>(Importer::stops.size(), false);
     currentMarkedStops = vector<bool>(Importer::stops.size(), false);
 
     extendedSourceStopIds = vector<int>();
     journeyPointers = vector<JourneyPointerRaptor>(Importer::stops.size(), JourneyPointerRaptor());
+    improvedStopIds = vector<int>();
 
     int indexOfFirstFootpathOfSourceStop = Importer::indexOfFirstFootPathOfAStop[query.sourceStopId];
     for (int i = indexOfFirstFootpathOfSourceStop; i < Importer::footPaths.size(); i++) {
@@ -43,6 +625,7 @@ void Raptor::initializeRaptor() {
         currentEarliestArrivalTimes[Importer::footPaths[i].arrivalStopId] = query.sourceTime + Importer::footPaths[i].duration;
         currentMarkedStops[Importer::footPaths[i].arrivalStopId] = true;
         extendedSourceStopIds.push_back(Importer::footPaths[i].arrivalStopId);
+        improvedStopIds.push_back(Importer::footPaths[i].arrivalStopId);
     }
 
     q = vector<pair<int, int>>();
@@ -51,7 +634,8 @@ void Raptor::initializeRaptor() {
     numberOfExpandedRoutes = 0;
 }
 
-void Raptor::processRaptor() {
+template <typename TimeLabels>
+void BasicRaptor<TimeLabels>::processRaptor() {
     while (true) {
         processRaptorRound();
         if (isFinishedFlag) {
@@ -60,22 +644,26 @@ void Raptor::processRaptor() {
     }
 }
 
-void Raptor::processRaptorRound() {
+template <typename TimeLabels>
+void BasicRaptor<TimeLabels>::processRaptorRound() {
     isFinishedFlag = true;
     currentRound++;
     previousEarliestArrivalTimes = currentEarliestArrivalTimes;
     previousMarkedStops = currentMarkedStops;
     currentMarkedStops = vector<bool>(Importer::stops.size(), false);
+    improvedStopIds.clear();
 
     fillQ();
     traverseRoutes();
 }
 
-bool Raptor::isFinished() {
+template <typename TimeLabels>
+bool BasicRaptor<TimeLabels>::isFinished() {
     return isFinishedFlag;
 }
 
-void Raptor::fillQ() {
+template <typename TimeLabels>
+void BasicRaptor<TimeLabels>::fillQ() {
     q.clear();
     minStopSequencePerRoute = vector<int>(Importer::routes.size(), INT_MAX);
     vector<pair<int, int>> qTemp = vector<pair<int, int>>();
@@ -100,7 +688,8 @@ void Raptor::fillQ() {
     }
 }
 
-void Raptor::traverseRoutes() {
+template <typename TimeLabels>
+void BasicRaptor<TimeLabels>::traverseRoutes() {
     for (int i = 0; i < q.size(); i++) {
         numberOfExpandedRoutes++;
 
@@ -142,6 +731,9 @@ void Raptor::traverseRoutes() {
                     }
                     if (newArrivalTime < currentEarliestArrivalTimes[Importer::footPaths[k].arrivalStopId] && !pruneTarget) {
                         currentEarliestArrivalTimes[Importer::footPaths[k].arrivalStopId] = newArrivalTime;
+                        if (!currentMarkedStops[Importer::footPaths[k].arrivalStopId]) {
+                            improvedStopIds.push_back(Importer::footPaths[k].arrivalStopId);
+                        }
                         currentMarkedStops[Importer::footPaths[k].arrivalStopId] = true;
                         isFinishedFlag = false;
                         journeyPointers[Importer::footPaths[k].arrivalStopId] = JourneyPointerRaptor{enterTripAtStop, stopId, currentTripDepartureTime, newArrivalTime, currentTripId};
@@ -162,7 +754,8 @@ void Raptor::traverseRoutes() {
     }
 }
 
-TripInfo Raptor::getEarliestTripWithDayOffset(int routeId, int stopId, int stopSequence) {
+template <typename TimeLabels>
+TripInfo BasicRaptor<TimeLabels>::getEarliestTripWithDayOffset(int routeId, int stopId, int stopSequence) {
     vector<int>* trips = &Importer::tripsOfARoute[routeId];
 
     int earliestDepartureTime = previousEarliestArrivalTimes[stopId];
@@ -198,15 +791,26 @@ TripInfo Raptor::getEarliestTripWithDayOffset(int routeId, int stopId, int stopS
     return {-1, -1, -1};
 }
 
-vector<int>* Raptor::getEarliestArrivalTimes() {
-    return &currentEarliestArrivalTimes;
+template <typename TimeLabels>
+vector<int> BasicRaptor<TimeLabels>::getEarliestArrivalTimes() {
+    return currentEarliestArrivalTimes.getTimes();
 }
 
-int Raptor::getEarliestArrivalTime(int stopId) {
+template <typename TimeLabels>
+int BasicRaptor<TimeLabels>::getEarliestArrivalTime(int stopId) {
     return currentEarliestArrivalTimes[stopId];
 }
 
-Journey Raptor::createJourney(int targetStopId) {
+/*
+    Returns the memory of the arrival time labels in bytes.
+*/
+template <typename TimeLabels>
+size_t BasicRaptor<TimeLabels>::getMemoryUsageOfLabels() {
+    return currentEarliestArrivalTimes.getMemoryUsage() + previousEarliestArrivalTimes.getMemoryUsage();
+}
+
+template <typename TimeLabels>
+Journey BasicRaptor<TimeLabels>::createJourney(int targetStopId) {
     Journey journey;
     journey.duration = currentEarliestArrivalTimes[targetStopId] - query.sourceTime;
 
@@ -457,28 +1061,35 @@ Journey RaptorBackward::createJourney(int sourceStopId) {
     return journey;
 }
 
-void RaptorBound::setCurrentBest(int currentBest) {
+template <typename TimeLabels>
+void BasicRaptorBound<TimeLabels>::setCurrentBest(int currentBest) {
     this->currentBest = currentBest;
 }
 
-void RaptorBound::initializeHeuristic(map<int, vector<int>> sourceStopIdsToAllStops, vector<int> sourceStopIds, int baseHeuristic, vector<int> closestLandmarkIndices) {
-    this->sourceStopIdsToAllStops = sourceStopIdsToAllStops;
-    this->sourceStopIds = sourceStopIds;
-    this->numberOfSourceStopIds = sourceStopIds.size();
-    this->baseHeuristic = (double) baseHeuristic;
-    this->closestLandmarkIndices = closestLandmarkIndices;
+template <typename TimeLabels>
+void BasicRaptorBound<TimeLabels>::setObjective(shared_ptr<MeetingPointObjective> objective) {
+    this->objective = objective;
 }
 
-void RaptorBound::initializeRaptorBound() {
+template <typename TimeLabels>
+void BasicRaptorBound<TimeLabels>::initializeHeuristic(shared_ptr<CliqueHeuristic> cliqueHeuristic, int sourceIndex, int numberOfSourceStopIds) {
+    this->cliqueHeuristic = cliqueHeuristic;
+    this->sourceIndex = sourceIndex;
+    this->numberOfSourceStopIds = numberOfSourceStopIds;
+}
+
+template <typename TimeLabels>
+void BasicRaptorBound<TimeLabels>::initializeRaptorBound() {
     currentRound = 0;
 
-    previousEarliestArrivalTimes = vector<int>(Importer::stops.size(), INT_MAX);
-    currentEarliestArrivalTimes = vector<int>(Importer::stops.size(), INT_MAX);
+    previousEarliestArrivalTimes = TimeLabels(Importer::stops.size(), query.sourceTime);
+    currentEarliestArrivalTimes = TimeLabels(Importer::stops.size(), query.sourceTime);
     previousMarkedStops = vector<bool>(Importer::stops.size(), false);
     currentMarkedStops = vector<bool>(Importer::stops.size(), false);
 
     extendedSourceStopIds = vector<int>();
     journeyPointers = vector<JourneyPointerRaptor>(Importer::stops.size(), JourneyPointerRaptor());
+    improvedStopIds = vector<int>();
 
     int indexOfFirstFootpathOfSourceStop = Importer::indexOfFirstFootPathOfAStop[query.sourceStopId];
     for (int i = indexOfFirstFootpathOfSourceStop; i < Importer::footPaths.size(); i++) {
@@ -488,6 +1099,7 @@ void RaptorBound::initializeRaptorBound() {
         currentEarliestArrivalTimes[Importer::footPaths[i].arrivalStopId] = query.sourceTime + Importer::footPaths[i].duration;
         currentMarkedStops[Importer::footPaths[i].arrivalStopId] = true;
         extendedSourceStopIds.push_back(Importer::footPaths[i].arrivalStopId);
+        improvedStopIds.push_back(Importer::footPaths[i].arrivalStopId);
     }
 
     q = vector<pair<int, int>>();
@@ -496,7 +1108,7 @@ void RaptorBound::initializeRaptorBound() {
     numberOfExpandedRoutes = 0;
     currentBest = INT_MAX;
 
-    heuristicPerStopId = vector<int>(Importer::stops.size(), -1);
+    heuristicPerStopId = TimeLabels(Importer::stops.size(), 0);
 
     lowerBoundSmallerCounter = 0;
     lowerBoundGreaterCounter = 0;
@@ -504,22 +1116,26 @@ void RaptorBound::initializeRaptorBound() {
     lowerBoundRelDifference = 0;
 }
 
-void RaptorBound::processRaptorRound() {
+template <typename TimeLabels>
+void BasicRaptorBound<TimeLabels>::processRaptorRound() {
     isFinishedFlag = true;
     currentRound++;
     previousEarliestArrivalTimes = currentEarliestArrivalTimes;
     previousMarkedStops = currentMarkedStops;
     currentMarkedStops = vector<bool>(Importer::stops.size(), false);
+    improvedStopIds.clear();
 
     fillQ();
     traverseRoutes();
 }
 
-bool RaptorBound::isFinished() {
+template <typename TimeLabels>
+bool BasicRaptorBound<TimeLabels>::isFinished() {
     return isFinishedFlag;
 }
 
-void RaptorBound::fillQ() {
+template <typename TimeLabels>
+void BasicRaptorBound<TimeLabels>::fillQ() {
     q.clear();
     minStopSequencePerRoute = vector<int>(Importer::routes.size(), INT_MAX);
     vector<pair<int, int>> qTemp = vector<pair<int, int>>();
@@ -527,37 +1143,16 @@ void RaptorBound::fillQ() {
         if (previousMarkedStops[stopId]) {
             double lowerBound = currentEarliestArrivalTimes[stopId] - query.sourceTime;
 
-            if (heuristicPerStopId[stopId] == -1) {
+            if (heuristicPerStopId[stopId] == INT_MAX) {
                 // calculate clique heuristic
-                double heuristic = baseHeuristic;
-                double maxDist = 0;
-                for (int j = 0; j < sourceStopIds.size(); j++) {
-                    int s1 = sourceStopIds[j];
-                    if (s1 == query.sourceStopId) {
-                        continue;
-                    }
-                    double lowerBoundToStop = 0;
-                    if (USE_LANDMARKS) {
-                        lowerBoundToStop = LandmarkProcessor::getLowerBoundUsingLandmarks(s1, stopId, closestLandmarkIndices);
-                    } else {
-                        lowerBoundToStop = sourceStopIdsToAllStops[s1][stopId];
-                    }
-                    if (lowerBoundToStop == INT_MAX) {
-                        continue;
-                    }
-                    heuristic += lowerBoundToStop;
-                    // if (sourceStopIdsToAllStops[s1][stopId] > maxDist) {
-                    //     maxDist = sourceStopIdsToAllStops[s1][stopId];
-                    // }
-                }
-                heuristic = heuristic / (numberOfSourceStopIds - 1);
-
-                heuristicPerStopId[stopId] = heuristic;
+                heuristicPerStopId[stopId] = cliqueHeuristic->getHeuristic(sourceIndex, stopId);
             }
 
             double heuristic = heuristicPerStopId[stopId];            
 
-            if (optimization == min_sum || optimization == both) {
+            if (objective != nullptr) {
+                lowerBound = objective->getLowerBound(sourceIndex, currentEarliestArrivalTimes[stopId], query.sourceTime, heuristic, numberOfSourceStopIds, optimization);
+            } else if (optimization == min_sum || optimization == both) {
                 lowerBound += heuristic;
             } else if (optimization == min_max) {
                 double secondPart = (double) lowerBound + heuristic;
@@ -605,7 +1200,8 @@ void RaptorBound::fillQ() {
     }
 }
 
-void RaptorBound::traverseRoutes() {
+template <typename TimeLabels>
+void BasicRaptorBound<TimeLabels>::traverseRoutes() {
     for (int i = 0; i < q.size(); i++) {
         numberOfExpandedRoutes++;
 
@@ -636,13 +1232,18 @@ void RaptorBound::traverseRoutes() {
                     }
 
                     int upperBound = currentBest;
-                    if (upperBound < INT_MAX) {
+                    if (objective != nullptr) {
+                        upperBound = objective->getArrivalTimeLimit(sourceIndex, query.sourceTime, currentBest);
+                    } else if (upperBound < INT_MAX) {
                         upperBound += query.sourceTime;
                     }
                     int newArrivalTime = arrivalTime + Importer::footPaths[k].duration;
 
                     if (newArrivalTime < currentEarliestArrivalTimes[Importer::footPaths[k].arrivalStopId] && newArrivalTime < upperBound) {
                         currentEarliestArrivalTimes[Importer::footPaths[k].arrivalStopId] = newArrivalTime;
+                        if (!currentMarkedStops[Importer::footPaths[k].arrivalStopId]) {
+                            improvedStopIds.push_back(Importer::footPaths[k].arrivalStopId);
+                        }
                         currentMarkedStops[Importer::footPaths[k].arrivalStopId] = true;
                         isFinishedFlag = false;
                         journeyPointers[Importer::footPaths[k].arrivalStopId] = JourneyPointerRaptor{enterTripAtStop, stopId, currentTripDepartureTime, newArrivalTime, currentTripId};
@@ -663,7 +1264,8 @@ void RaptorBound::traverseRoutes() {
     }
 }
 
-TripInfo RaptorBound::getEarliestTripWithDayOffset(int routeId, int stopId, int stopSequence) {
+template <typename TimeLabels>
+TripInfo BasicRaptorBound<TimeLabels>::getEarliestTripWithDayOffset(int routeId, int stopId, int stopSequence) {
     vector<int>* trips = &Importer::tripsOfARoute[routeId];
 
     int earliestDepartureTime = previousEarliestArrivalTimes[stopId];
@@ -699,15 +1301,26 @@ TripInfo RaptorBound::getEarliestTripWithDayOffset(int routeId, int stopId, int
     return {-1, -1, -1};
 }
 
-vector<int>* RaptorBound::getEarliestArrivalTimes() {
-    return &currentEarliestArrivalTimes;
+template <typename TimeLabels>
+vector<int> BasicRaptorBound<TimeLabels>::getEarliestArrivalTimes() {
+    return currentEarliestArrivalTimes.getTimes();
 }
 
-int RaptorBound::getEarliestArrivalTime(int stopId) {
+template <typename TimeLabels>
+int BasicRaptorBound<TimeLabels>::getEarliestArrivalTime(int stopId) {
     return currentEarliestArrivalTimes[stopId];
 }
 
-Journey RaptorBound::createJourney(int targetStopId) {
+/*
+    Returns the memory of the arrival time and heuristic labels in bytes.
+*/
+template <typename TimeLabels>
+size_t BasicRaptorBound<TimeLabels>::getMemoryUsageOfLabels() {
+    return currentEarliestArrivalTimes.getMemoryUsage() + previousEarliestArrivalTimes.getMemoryUsage() + heuristicPerStopId.getMemoryUsage();
+}
+
+template <typename TimeLabels>
+Journey BasicRaptorBound<TimeLabels>::createJourney(int targetStopId) {
     Journey journey;
     journey.duration = currentEarliestArrivalTimes[targetStopId] - query.sourceTime;
 
@@ -735,37 +1348,129 @@ Journey RaptorBound::createJourney(int targetStopId) {
     return journey;
 }
 
-void RaptorPQ::processRaptorPQ() {
+template <typename TimeLabels>
+void BasicRaptorPQ<TimeLabels>::processRaptorPQ() {
     while (!pq.empty() && !isFinishedFlag) {
         traverseRoute();
     }
 }
 
-void RaptorPQ::setCurrentBest(int currentBest) {
+/*
+    Takes at most the given number of routes with the lowest lower bounds out of the queue and returns them with the
+    stop sequence to start from. Used by the work stealing query processor, several threads can take and traverse
+    batches of the same raptor at the same time.
+*/
+template <typename TimeLabels>
+vector<pair<int, int>> BasicRaptorPQ<TimeLabels>::takeRouteBatch(int numberOfRoutes) {
+    lock_guard<mutex> lock(engineLock);
+    if (sharedUpperBound != nullptr) {
+        currentBest = sharedUpperBound->getCurrentBest();
+    }
+
+    vector<pair<int, int>> routes;
+    while (routes.size() < numberOfRoutes && !pq.empty() && pq.top().first <= currentBest) {
+        double lowerBound = pq.top().first;
+        int routeId = pq.top().second;
+        pq.pop();
+
+        if (lowerBound != lowestLowerBoundPerRoute[routeId] || firstStopSequencePerRoute[routeId] == INT_MAX) {
+            continue;
+        }
+
+        // reset the route before it is traversed, so that an improvement by another thread queues it again
+        routes.push_back(make_pair(routeId, firstStopSequencePerRoute[routeId]));
+        firstStopSequencePerRoute[routeId] = INT_MAX;
+        lowestLowerBoundPerRoute[routeId] = INT_MAX;
+        numberOfExpandedRoutes++;
+    }
+    return routes;
+}
+
+/*
+    Traverses a batch of routes taken with takeRouteBatch. The labels are only accessed under the lock of the raptor,
+    the search for the earliest trip runs without it.
+*/
+template <typename TimeLabels>
+void BasicRaptorPQ<TimeLabels>::traverseRouteBatch(vector<pair<int, int>> routes) {
+    for (int i = 0; i < routes.size(); i++) {
+        auto start = chrono::high_resolution_clock::now();
+        int arrivalTimeLimit;
+        {
+            lock_guard<mutex> lock(engineLock);
+            arrivalTimeLimit = getArrivalTimeLimit();
+        }
+
+        set<int> arrivalStops = scanRoute(routes[i].first, routes[i].second, arrivalTimeLimit, true);
+
+        lock_guard<mutex> lock(engineLock);
+        addRoutesToQueue(arrivalStops, routes[i].first);
+        auto end = chrono::high_resolution_clock::now();
+        durationTraverseRoute += chrono::duration_cast<chrono::microseconds>(end - start).count();
+    }
+}
+
+/*
+    Returns the lowest lower bound of a queued route that can still improve the current best, DBL_MAX if there is none.
+*/
+template <typename TimeLabels>
+double BasicRaptorPQ<TimeLabels>::getLowestLowerBound() {
+    lock_guard<mutex> lock(engineLock);
+    if (sharedUpperBound != nullptr) {
+        currentBest = sharedUpperBound->getCurrentBest();
+    }
+    if (pq.empty() || isFinishedFlag || pq.top().first > currentBest) {
+        return DBL_MAX;
+    }
+    return pq.top().first;
+}
+
+template <typename TimeLabels>
+void BasicRaptorPQ<TimeLabels>::setCurrentBest(int currentBest) {
     this->currentBest = currentBest;
 }
 
-void RaptorPQ::initializeHeuristic(map<int, vector<int>> sourceStopIdsToAllStops, vector<int> sourceStopIds, int baseHeuristic, vector<int> closestLandmarkIndices) {
-    this->sourceStopIdsToAllStops = sourceStopIdsToAllStops;
-    this->sourceStopIds = sourceStopIds;
-    this->numberOfSourceStopIds = sourceStopIds.size();
-    this->baseHeuristic = (double) baseHeuristic;
-    this->closestLandmarkIndices = closestLandmarkIndices;
+template <typename TimeLabels>
+void BasicRaptorPQ<TimeLabels>::setSharedUpperBound(shared_ptr<SharedUpperBound> sharedUpperBound) {
+    this->sharedUpperBound = sharedUpperBound;
+}
+
+template <typename TimeLabels>
+void BasicRaptorPQ<TimeLabels>::setObjective(shared_ptr<MeetingPointObjective> objective) {
+    this->objective = objective;
 }
 
-bool RaptorPQ::isFinished() {
+template <typename TimeLabels>
+void BasicRaptorPQ<TimeLabels>::initializeHeuristic(shared_ptr<CliqueHeuristic> cliqueHeuristic, int sourceIndex, int numberOfSourceStopIds) {
+    this->cliqueHeuristic = cliqueHeuristic;
+    this->sourceIndex = sourceIndex;
+    this->numberOfSourceStopIds = numberOfSourceStopIds;
+}
+
+template <typename TimeLabels>
+bool BasicRaptorPQ<TimeLabels>::isFinished() {
     return isFinishedFlag;
 }
 
-vector<int>* RaptorPQ::getEarliestArrivalTimes() {
-    return &earliestArrivalTimes;
+template <typename TimeLabels>
+vector<int> BasicRaptorPQ<TimeLabels>::getEarliestArrivalTimes() {
+    return earliestArrivalTimes.getTimes();
 }
 
-int RaptorPQ::getEarliestArrivalTime(int stopId) {
+template <typename TimeLabels>
+int BasicRaptorPQ<TimeLabels>::getEarliestArrivalTime(int stopId) {
     return earliestArrivalTimes[stopId];
 }
 
-Journey RaptorPQ::createJourney(int targetStopId) {
+/*
+    Returns the memory of the arrival time and heuristic labels in bytes.
+*/
+template <typename TimeLabels>
+size_t BasicRaptorPQ<TimeLabels>::getMemoryUsageOfLabels() {
+    return earliestArrivalTimes.getMemoryUsage() + heuristicPerStopId.getMemoryUsage();
+}
+
+template <typename TimeLabels>
+Journey BasicRaptorPQ<TimeLabels>::createJourney(int targetStopId) {
     Journey journey;
     journey.duration = earliestArrivalTimes[targetStopId] - query.sourceTime;
 
@@ -793,7 +1498,8 @@ Journey RaptorPQ::createJourney(int targetStopId) {
     return journey;
 }
 
-void RaptorPQ::transformRaptorToRaptorPQ(shared_ptr<Raptor> raptor) {
+template <typename TimeLabels>
+void BasicRaptorPQ<TimeLabels>::transformRaptorToRaptorPQ(shared_ptr<BasicRaptor<TimeLabels>> raptor) {
     auto start = chrono::high_resolution_clock::now();
     earliestArrivalTimes = raptor->currentEarliestArrivalTimes;
     journeyPointers = raptor->journeyPointers;
@@ -803,14 +1509,18 @@ void RaptorPQ::transformRaptorToRaptorPQ(shared_ptr<Raptor> raptor) {
     lowestLowerBoundPerRoute = vector<double>(Importer::routes.size(), DBL_MAX);
     markedStopsPerRoute = vector<set<int>>(Importer::routes.size(), set<int>());
 
-    heuristicPerStopId = vector<int>(Importer::stops.size(), -1);
+    heuristicPerStopId = TimeLabels(Importer::stops.size(), 0);
 
     set<int> arrivalStops;
+    reachedStopIds = vector<int>();
     
     for (int i = 0; i < raptor->currentMarkedStops.size(); i++) {
         if (raptor->currentMarkedStops[i]) {
             arrivalStops.insert(i);
         }
+        if (earliestArrivalTimes[i] != INT_MAX) {
+            reachedStopIds.push_back(i);
+        }
     }
     addRoutesToQueue(arrivalStops, -1);
 
@@ -820,17 +1530,19 @@ void RaptorPQ::transformRaptorToRaptorPQ(shared_ptr<Raptor> raptor) {
     durationTransformRaptorToRaptorPQ = chrono::duration_cast<chrono::microseconds>(end - start).count();
 }
 
-void RaptorPQ::initializeRaptorPQ() {
-    earliestArrivalTimes = vector<int>(Importer::stops.size(), INT_MAX);
+template <typename TimeLabels>
+void BasicRaptorPQ<TimeLabels>::initializeRaptorPQ() {
+    earliestArrivalTimes = TimeLabels(Importer::stops.size(), query.sourceTime);
 
     firstStopSequencePerRoute = vector<int>(Importer::routes.size(), INT_MAX);
     lowestLowerBoundPerRoute = vector<double>(Importer::routes.size(), DBL_MAX);
     markedStopsPerRoute = vector<set<int>>(Importer::routes.size(), set<int>());
 
-    heuristicPerStopId = vector<int>(Importer::stops.size(), -1);
+    heuristicPerStopId = TimeLabels(Importer::stops.size(), 0);
 
     extendedSourceStopIds = vector<int>();
     journeyPointers = vector<JourneyPointerRaptor>(Importer::stops.size(), JourneyPointerRaptor());
+    reachedStopIds = vector<int>();
 
     set<int> arrivalStops;
 
@@ -842,6 +1554,7 @@ void RaptorPQ::initializeRaptorPQ() {
         earliestArrivalTimes[Importer::footPaths[i].arrivalStopId] = query.sourceTime + Importer::footPaths[i].duration;
         extendedSourceStopIds.push_back(Importer::footPaths[i].arrivalStopId);
         arrivalStops.insert(Importer::footPaths[i].arrivalStopId);
+        reachedStopIds.push_back(Importer::footPaths[i].arrivalStopId);
     }
 
     addRoutesToQueue(arrivalStops, -1);
@@ -850,7 +1563,8 @@ void RaptorPQ::initializeRaptorPQ() {
     numberOfExpandedRoutes = 0;
 }
 
-void RaptorPQ::addRoutesToQueue(set<int> stopIds, int excludeRouteId) {
+template <typename TimeLabels>
+void BasicRaptorPQ<TimeLabels>::addRoutesToQueue(set<int> stopIds, int excludeRouteId) {
     auto start = chrono::high_resolution_clock::now();
     set<int> newRoutes;
 
@@ -859,37 +1573,15 @@ void RaptorPQ::addRoutesToQueue(set<int> stopIds, int excludeRouteId) {
         double lowerBound = earliestArrivalTimes[stopId] - query.sourceTime;
 
         // calculate clique heuristic
-        if(heuristicPerStopId[stopId] == -1) {
-            double heuristic = baseHeuristic;
-            double maxDist = 0;
-            for (int j = 0; j < sourceStopIds.size(); j++) {
-                int s1 = sourceStopIds[j];
-                if (s1 == query.sourceStopId) {
-                    continue;
-                }
-                double lowerBoundToStop = 0;
-                if (USE_LANDMARKS) {
-                    lowerBoundToStop = LandmarkProcessor::getLowerBoundUsingLandmarks(s1, stopId, closestLandmarkIndices);
-                } else {
-                    lowerBoundToStop = sourceStopIdsToAllStops[s1][stopId];
-                
-                }
-                if (lowerBoundToStop == INT_MAX) {
-                    continue;
-                }
-                heuristic += lowerBoundToStop;
-                // if (sourceStopIdsToAllStops[s1][stopId] > maxDist) {
-                //     maxDist = sourceStopIdsToAllStops[s1][stopId];
-                // }
-            }
-            heuristic = heuristic / (numberOfSourceStopIds - 1);
-
-            heuristicPerStopId[stopId] = heuristic;
+        if(heuristicPerStopId[stopId] == INT_MAX) {
+            heuristicPerStopId[stopId] = cliqueHeuristic->getHeuristic(sourceIndex, stopId);
         }
 
         double heuristic = heuristicPerStopId[stopId];
 
-        if (optimization == min_sum || optimization == both) {
+        if (objective != nullptr) {
+            lowerBound = objective->getLowerBound(sourceIndex, earliestArrivalTimes[stopId], query.sourceTime, heuristic, numberOfSourceStopIds, optimization);
+        } else if (optimization == min_sum || optimization == both) {
             lowerBound += heuristic;
         } else if (optimization == min_max) {
             double secondPart = (double) lowerBound + heuristic;
@@ -949,8 +1641,13 @@ void RaptorPQ::addRoutesToQueue(set<int> stopIds, int excludeRouteId) {
     durationAddRoutesToQueue += chrono::duration_cast<chrono::microseconds>(end - start).count();
 }
 
-void RaptorPQ::traverseRoute() {
+template <typename TimeLabels>
+void BasicRaptorPQ<TimeLabels>::traverseRoute() {
     auto start = chrono::high_resolution_clock::now();
+    if (sharedUpperBound != nullptr) {
+        currentBest = sharedUpperBound->getCurrentBest();
+    }
+
     double lowerBound = pq.top().first;
 
     if (lowerBound > currentBest) {
@@ -967,19 +1664,51 @@ void RaptorPQ::traverseRoute() {
 
     numberOfExpandedRoutes++;
 
+    set<int> arrivalStops = scanRoute(routeId, firstStopSequencePerRoute[routeId], getArrivalTimeLimit(), false);
+
+    addRoutesToQueue(arrivalStops, routeId);
+
+    firstStopSequencePerRoute[routeId] = INT_MAX;
+    lowestLowerBoundPerRoute[routeId] = INT_MAX;
+    // markedStopsPerRoute[routeId] = set<int>();
+    auto end = chrono::high_resolution_clock::now();
+    durationTraverseRoute += chrono::duration_cast<chrono::microseconds>(end - start).count();
+}
+
+template <typename TimeLabels>
+int BasicRaptorPQ<TimeLabels>::getArrivalTimeLimit() {
+    if (objective != nullptr) {
+        return objective->getArrivalTimeLimit(sourceIndex, query.sourceTime, currentBest);
+    }
+    return currentBest + query.sourceTime;
+}
+
+/*
+    Scans the route from the given stop sequence and returns the stops whose arrival time improved. With lockLabels
+    the labels of a stop are only accessed under the lock of the raptor, so that several threads can scan routes of
+    the same raptor at once.
+*/
+template <typename TimeLabels>
+set<int> BasicRaptorPQ<TimeLabels>::scanRoute(int routeId, int firstStopSequence, int arrivalTimeLimit, bool lockLabels) {
     vector<int>* stops = &Importer::stopsOfARoute[routeId];
     int currentTripId = -1;
     int currentDayOffset = 0;
 
-    int enterTripAtStop = (*stops)[firstStopSequencePerRoute[routeId]];
+    int enterTripAtStop = (*stops)[firstStopSequence];
     int currentTripDepartureTime = 0;
+    double durationGetEarliestTrip = 0;
 
     set<int> arrivalStops;
 
-    for (int i = firstStopSequencePerRoute[routeId]; i < stops->size(); i++) {
+    for (int i = firstStopSequence; i < stops->size(); i++) {
         int stopId = (*stops)[i];
         StopTime stopTime;
 
+        unique_lock<mutex> labelLock(engineLock, defer_lock);
+        if (lockLabels) {
+            labelLock.lock();
+        }
+
         int previousEarliestArrivalTime = earliestArrivalTimes[stopId];
 
         if (currentTripId != -1) {
@@ -998,20 +1727,33 @@ void RaptorPQ::traverseRoute() {
                 int arrivalStopId = Importer::footPaths[j].arrivalStopId;
                 int newArrivalTime = arrivalTime + Importer::footPaths[j].duration;
 
-                if (newArrivalTime < earliestArrivalTimes[arrivalStopId] && newArrivalTime < currentBest + query.sourceTime) {
+                if (newArrivalTime < earliestArrivalTimes[arrivalStopId] && newArrivalTime < arrivalTimeLimit) {
+                    if (earliestArrivalTimes[arrivalStopId] == INT_MAX) {
+                        reachedStopIds.push_back(arrivalStopId);
+                    }
                     earliestArrivalTimes[arrivalStopId] = newArrivalTime;
                     journeyPointers[arrivalStopId] = JourneyPointerRaptor{enterTripAtStop, stopId, currentTripDepartureTime, newArrivalTime, currentTripId};
                     arrivalStops.insert(arrivalStopId);
+                    if (sharedUpperBound != nullptr) {
+                        sharedUpperBound->updateArrivalTime(sourceIndex, arrivalStopId, newArrivalTime);
+                    }
                 }
             }
         }
 
+        if (lockLabels) {
+            labelLock.unlock();
+        }
+
         // check if stop is in markedStops set of route
         // bool stopIsMarked = markedStopsPerRoute[routeId].find(stopId) != markedStopsPerRoute[routeId].end();
 
         // if (stopIsMarked && (currentTripId == -1 || previousEarliestArrivalTime < stopTime.departureTime + currentDayOffset)) {
         if (currentTripId == -1 || previousEarliestArrivalTime < stopTime.departureTime + currentDayOffset) {
+            auto start = chrono::high_resolution_clock::now();
             TripInfo tripInfo = getEarliestTripWithDayOffset(routeId, stopId, i, previousEarliestArrivalTime);
+            auto end = chrono::high_resolution_clock::now();
+            durationGetEarliestTrip += chrono::duration_cast<chrono::microseconds>(end - start).count();
             if (tripInfo.tripId != -1) {
                 currentTripId = tripInfo.tripId;
                 currentDayOffset = tripInfo.dayOffset;
@@ -1021,17 +1763,17 @@ void RaptorPQ::traverseRoute() {
         }
     }
 
-    addRoutesToQueue(arrivalStops, routeId);
+    unique_lock<mutex> durationLock(engineLock, defer_lock);
+    if (lockLabels) {
+        durationLock.lock();
+    }
+    durationGetEarliestTripWithDayOffset += durationGetEarliestTrip;
 
-    firstStopSequencePerRoute[routeId] = INT_MAX;
-    lowestLowerBoundPerRoute[routeId] = INT_MAX;
-    // markedStopsPerRoute[routeId] = set<int>();
-    auto end = chrono::high_resolution_clock::now();
-    durationTraverseRoute += chrono::duration_cast<chrono::microseconds>(end - start).count();
+    return arrivalStops;
 }
 
-TripInfo RaptorPQ::getEarliestTripWithDayOffset(int routeId, int stopId, int stopSequence, int previousEarliestArrivalTime) {
-    auto start = chrono::high_resolution_clock::now();
+template <typename TimeLabels>
+TripInfo BasicRaptorPQ<TimeLabels>::getEarliestTripWithDayOffset(int routeId, int stopId, int stopSequence, int previousEarliestArrivalTime) {
     vector<int>* trips = &Importer::tripsOfARoute[routeId];
 
     int earliestDepartureTime = previousEarliestArrivalTime;
@@ -1057,8 +1799,6 @@ TripInfo RaptorPQ::getEarliestTripWithDayOffset(int routeId, int stopId, int sto
 
             if (stopTime.departureTime + dayOffset >= earliestDepartureTime) {
                 TripInfo tripInfo = {tripId, dayOffset, stopTime.departureTime + dayOffset};
-                auto end = chrono::high_resolution_clock::now();
-                durationGetEarliestTripWithDayOffset += chrono::duration_cast<chrono::microseconds>(end - start).count();
                 return tripInfo;
             }
         }
@@ -1066,9 +1806,6 @@ TripInfo RaptorPQ::getEarliestTripWithDayOffset(int routeId, int stopId, int sto
         weekday = (weekday + 1) % 7;
     }
 
-    auto end = chrono::high_resolution_clock::now();
-    durationGetEarliestTripWithDayOffset += chrono::duration_cast<chrono::microseconds>(end - start).count();
-
     return {-1, -1, -1};
 } 
 
@@ -1090,7 +1827,7 @@ void RaptorPQParallel::transformRaptorsToRaptorPQs(vector<shared_ptr<Raptor>> ra
     #pragma omp parallel for
     for (int i = 0; i < raptors.size(); i++) {
         shared_ptr<Raptor> raptor = raptors[i];
-        earliestArrivalTimes[i] = raptor->currentEarliestArrivalTimes;
+        earliestArrivalTimes[i] = raptor->currentEarliestArrivalTimes.getTimes();
         journeyPointers[i] = raptor->journeyPointers;
         extendedSourceStopIds[i] = raptor->extendedSourceStopIds;
 
@@ -1106,9 +1843,16 @@ void RaptorPQParallel::transformRaptorsToRaptorPQs(vector<shared_ptr<Raptor>> ra
         routesPerRatorIndex[i] = getNewRoutes(arrivalStops, -1, i);
     }
 
+    meetingPointAggregator = make_shared<MeetingPointAggregator>(raptors.size(), queries[0].sourceTime);
     for (int i = 0; i < raptors.size(); i++) {
         addRoutesToQueue(routesPerRatorIndex[i], i);
+        for (int j = 0; j < earliestArrivalTimes[i].size(); j++) {
+            if (earliestArrivalTimes[i][j] != INT_MAX) {
+                meetingPointAggregator->updateArrivalTime(i, j, earliestArrivalTimes[i][j]);
+            }
+        }
     }
+    updateCurrentBest();
     auto end = chrono::high_resolution_clock::now();
     durationTransformRaptorToRaptorPQ = chrono::duration_cast<chrono::microseconds>(end - start).count();
 }
@@ -1248,6 +1992,7 @@ void RaptorPQParallel::traverseRoute() {
 
                 if (newArrivalTime < earliestArrivalTimes[raptorIndex][arrivalStopId] && newArrivalTime < currentBest + queries[raptorIndex].sourceTime) {
                     earliestArrivalTimes[raptorIndex][arrivalStopId] = newArrivalTime;
+                    meetingPointAggregator->updateArrivalTime(raptorIndex, arrivalStopId, newArrivalTime);
                     journeyPointers[raptorIndex][arrivalStopId] = JourneyPointerRaptor{enterTripAtStop, stopId, currentTripDepartureTime, newArrivalTime, currentTripId};
                     arrivalStops.insert(arrivalStopId);
                 }
@@ -1270,7 +2015,7 @@ void RaptorPQParallel::traverseRoute() {
     addRoutesToQueue(newRoutes, raptorIndex);
     auto endAddRoutes = chrono::high_resolution_clock::now();
     durationAddRoutesToQueue += chrono::duration_cast<chrono::microseconds>(endAddRoutes - startAddRoutes).count();
-    updateCurrentBest(arrivalStops);
+    updateCurrentBest();
 
     firstStopSequencePerRoute[raptorIndex][routeId] = INT_MAX;
     lowestLowerBoundPerRoute[raptorIndex][routeId] = INT_MAX;
@@ -1394,35 +2139,13 @@ TripInfo RaptorPQParallel::getEarliestTripWithDayOffset(int routeId, int stopId,
     return {-1, -1, -1};
 } 
 
-void RaptorPQParallel::updateCurrentBest(set<int> stopIds) {
-    for (set<int>::iterator it = stopIds.begin(); it != stopIds.end(); it++) {
-        int stopId = *it;
-        int sum = 0;
-        int max = 0;
-        for (int j = 0; j < earliestArrivalTimes.size(); j++) {
-            if (earliestArrivalTimes[j][stopId] == INT_MAX) {
-                sum = INT_MAX;
-                break;
-            }
-            int duration = earliestArrivalTimes[j][stopId] - queries[j].sourceTime;
-            sum += duration;
-            if (duration > max) {
-                max = duration;
-            }
-        }
-        if (sum == INT_MAX) {
-            continue;
-        }
-        
-        if (optimization == min_sum || optimization == both) {
-            if (sum < currentBest) {
-                currentBest = sum;
-            }
-        } else if (optimization == min_max) {
-            if (max < currentBest) {
-                currentBest = max;
-            }
-        }
+void RaptorPQParallel::updateCurrentBest() {
+    int best = meetingPointAggregator->getMinSumDuration();
+    if (optimization == min_max) {
+        best = meetingPointAggregator->getMinMaxDuration();
+    }
+    if (best < currentBest) {
+        currentBest = best;
     }
 }
 
@@ -1890,4 +2613,12 @@ TripInfo RaptorPQStar::getEarliestTripWithDayOffset(int routeId, int stopId, int
     }
 
     return {-1, -1, -1};
-} 
\ No newline at end of file
+} 
+
+// the engines are instantiated with both label types
+template class BasicRaptor<FullTimeLabels>;
+template class BasicRaptor<CompactTimeLabels>;
+template class BasicRaptorBound<FullTimeLabels>;
+template class BasicRaptorBound<CompactTimeLabels>;
+template class BasicRaptorPQ<FullTimeLabels>;
+template class BasicRaptorPQ<CompactTimeLabels>;
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define CMAKE_RAPTOR_H
 
 #include <../data-handling/importer.h>
+#include <../data-structures/graph.h>
 #include "optimization.h"
 #include <journey.h>
 #include <vector>
@@ -9,6 +10,12 @@
 #include <queue>
 #include <limits.h>
 #include <memory>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+
+#include "../constants.h"
 
 struct RaptorQuery {
     int sourceStopId;
@@ -60,13 +67,139 @@ struct PQEntry {
     }
 };
 
-class Raptor {
+class MeetingPointObjective {
+    public:
+        explicit MeetingPointObjective(vector<double> weightPerSource, vector<int> latestArrivalTimePerSource, vector<int> candidateStopIds);
+        ~MeetingPointObjective(){};
+
+        double getWeight(int sourceIndex);
+        int getLatestArrivalTime(int sourceIndex);
+        bool isCandidate(int stopId);
+
+        int getDuration(int sourceIndex, int duration);
+        double getLowerBound(int sourceIndex, int arrivalTime, int sourceTime, double heuristic, int numberOfSourceStopIds, Optimization optimization);
+        int getArrivalTimeLimit(int sourceIndex, int sourceTime, int upperBound);
+
+    private:
+        vector<double> weightPerSource;
+        vector<int> latestArrivalTimePerSource;
+        vector<bool> isCandidatePerStopId;
+        double minimumWeight;
+};
+
+/*
+    Time labels that are stored as int. Unset labels are INT_MAX.
+*/
+class FullTimeLabels {
     public:
-        explicit Raptor(RaptorQuery query){
+        explicit FullTimeLabels() {};
+        explicit FullTimeLabels(int numberOfLabels, int baseTime);
+        ~FullTimeLabels(){};
+
+        int& operator[](int index);
+        vector<int> getTimes();
+        size_t getMemoryUsage();
+
+    private:
+        vector<int> labels;
+};
+
+/*
+    Time labels that are stored relative to a base time in 24 bit fields, which needs 3 instead of 4 bytes per label. Unset labels 
+    are INT_MAX, later times saturate at the largest field value. The labels are accessed through a reference that converts the 
+    field from and to the absolute time, so the engines can use both label types in the same way.
+*/
+class CompactTimeLabels {
+    public:
+        class Reference {
+            public:
+                explicit Reference(CompactTimeLabels* timeLabels, int index) {
+                    this->timeLabels = timeLabels;
+                    this->index = index;
+                };
+
+                operator int() const;
+                Reference& operator=(int time);
+                Reference& operator=(const Reference& other);
+
+            private:
+                CompactTimeLabels* timeLabels;
+                int index;
+        };
+
+        explicit CompactTimeLabels() {};
+        explicit CompactTimeLabels(int numberOfLabels, int baseTime);
+        ~CompactTimeLabels(){};
+
+        Reference operator[](int index);
+        vector<int> getTimes();
+        size_t getMemoryUsage();
+
+    private:
+        int baseTime;
+        vector<unsigned char> labels;
+
+        int get(int index);
+        void set(int index, int time);
+};
+
+// the label type of the engines that are used by the query processors, the engines can be instantiated with both types
+typedef conditional<USE_COMPACT_LABELS, CompactTimeLabels, FullTimeLabels>::type ArrivalTimeLabels;
+
+class MeetingPointAggregator {
+    public:
+        explicit MeetingPointAggregator(int numberOfSourceStopIds, int sourceTime, shared_ptr<MeetingPointObjective> objective = nullptr);
+        ~MeetingPointAggregator(){};
+
+        void updateArrivalTime(int sourceIndex, int stopId, int arrivalTime);
+
+        int getMinSumStopId();
+        int getMinSumDuration();
+        int getNumberOfMinSumStops();
+        int getMinMaxStopId();
+        int getMinMaxDuration();
+        int getNumberOfMinMaxStops();
+
+        int getMeetingTime(int stopId);
+        int getDuration(int stopId, Optimization optimization);
+        vector<int> getBestStopIds(int numberOfStops, Optimization optimization, double minimumDistance = 0);
+        int getKthBestDuration(int k, Optimization optimization, double minimumDistance = 0);
+
+    private:
+        int numberOfSourceStopIds;
+        int sourceTime;
+        shared_ptr<MeetingPointObjective> objective;
+
+        ArrivalTimeLabels arrivalTimesPerStopIdAndSource;
+        vector<int> reachedCounterPerStopId;
+        vector<int> sumPerStopId;
+        vector<int> maxPerStopId;
+
+        int minSumStopId;
+        int minSumDuration;
+        int numberOfMinSumStops;
+        int minMaxStopId;
+        int minMaxDuration;
+        int numberOfMinMaxStops;
+
+        set<pair<int, int>> minSumCandidates;
+        set<pair<int, int>> minMaxCandidates;
+
+        void updateBest(int stopId, int duration, int &bestStopId, int &bestDuration, int &numberOfBestStops);
+        int getDurationOfSource(int sourceIndex, int arrivalTime);
+};
+
+/*
+    The raptor algorithm. The template parameter is the type of the arrival time labels.
+*/
+template <typename TimeLabels>
+class BasicRaptor {
+    public:
+        explicit BasicRaptor(RaptorQuery query){
             this->query = query;
             this->initializeRaptor();
         };
-        ~Raptor(){};
+        ~BasicRaptor(){};
 
         void setTargetStopIds(vector<int> targetStopIds);
         void processRaptor();
@@ -74,22 +207,24 @@ class Raptor {
 
         bool isFinished();
 
-        vector<int>* getEarliestArrivalTimes();
+        vector<int> getEarliestArrivalTimes();
         int getEarliestArrivalTime(int stopId);
+        size_t getMemoryUsageOfLabels();
 
         Journey createJourney(int targetStopId);
 
         vector<JourneyPointerRaptor> journeyPointers;
         vector<int> extendedSourceStopIds;
-        vector<int> currentEarliestArrivalTimes;
+        TimeLabels currentEarliestArrivalTimes;
         vector<bool> currentMarkedStops;
+        vector<int> improvedStopIds;
 
         double numberOfExpandedRoutes;
 
     private:
         RaptorQuery query;
         int currentRound;
-        vector<int> previousEarliestArrivalTimes;
+        TimeLabels previousEarliestArrivalTimes;
         vector<bool> previousMarkedStops;
         
         vector<int> minStopSequencePerRoute;
@@ -102,6 +237,8 @@ class Raptor {
         TripInfo getEarliestTripWithDayOffset(int routeId, int stopId, int stopSequence);
 };
 
+typedef BasicRaptor<ArrivalTimeLabels> Raptor;
+
 class RaptorBackward {
     public:
         explicit RaptorBackward(RaptorBackwardQuery query){
@@ -144,29 +281,78 @@ class RaptorBackward {
         TripInfoBackward getLatestTripWithDayOffset(int routeId, int stopId, int stopSequence);
 };
 
-class RaptorBound {
+class CliqueHeuristic {
     public:
-        explicit RaptorBound(RaptorQuery query, Optimization optimization){
+        explicit CliqueHeuristic(PhastDistances phastDistances, vector<int> sourceStopIds, int weekday);
+        ~CliqueHeuristic(){};
+
+        int getBaseHeuristic(int sourceIndex);
+        int getHeuristic(int sourceIndex, int stopId);
+
+    private:
+        vector<int> sourceStopIds;
+        int numberOfSourceStopIds;
+        PhastDistances phastDistances;
+        vector<int> closestLandmarkPerSource;
+
+        int basicHeuristic;
+        vector<int> lowerBoundSumPerSource;
+
+        vector<atomic<int>> lowerBoundSumPerStopId;
+
+        int getLowerBoundToStop(int sourceIndex, int stopId);
+};
+
+class SharedUpperBound {
+    public:
+        explicit SharedUpperBound(int numberOfSourceStopIds, int sourceTime, Optimization optimization, int upperBound);
+        ~SharedUpperBound(){};
+
+        int getCurrentBest();
+        void setArrivalTime(int sourceIndex, int stopId, int arrivalTime);
+        void calculateCurrentBest();
+        void updateArrivalTime(int sourceIndex, int stopId, int arrivalTime);
+
+    private:
+        int numberOfSourceStopIds;
+        int sourceTime;
+        Optimization optimization;
+
+        vector<atomic<int>> arrivalTimesPerStopIdAndSource;
+        atomic<int> currentBest;
+};
+
+/*
+    The raptor algorithm that prunes with the clique heuristic and the current best meeting point. The template parameter is 
+    the type of the arrival time and heuristic labels.
+*/
+template <typename TimeLabels>
+class BasicRaptorBound {
+    public:
+        explicit BasicRaptorBound(RaptorQuery query, Optimization optimization){
             this->query = query;
             this->optimization = optimization;
             this->initializeRaptorBound();
         };
-        ~RaptorBound(){};
+        ~BasicRaptorBound(){};
 
         void processRaptorRound();
         void setCurrentBest(int currentBest);
-        void initializeHeuristic(map<int, vector<int>> sourceStopIdsToAllStops, vector<int> sourceStopIds, int baseHeuristic, vector<int> closestLandmarkIndices);
+        void initializeHeuristic(shared_ptr<CliqueHeuristic> cliqueHeuristic, int sourceIndex, int numberOfSourceStopIds);
+        void setObjective(shared_ptr<MeetingPointObjective> objective);
 
         bool isFinished();
 
-        vector<int>* getEarliestArrivalTimes();
+        vector<int> getEarliestArrivalTimes();
         int getEarliestArrivalTime(int stopId);
+        size_t getMemoryUsageOfLabels();
         Journey createJourney(int targetStopId);
 
         vector<JourneyPointerRaptor> journeyPointers;
         vector<int> extendedSourceStopIds;
-        vector<int> currentEarliestArrivalTimes;
+        TimeLabels currentEarliestArrivalTimes;
         vector<bool> currentMarkedStops;
+        vector<int> improvedStopIds;
 
         double numberOfExpandedRoutes;
         double lowerBoundSmallerCounter;
@@ -177,7 +363,7 @@ class RaptorBound {
     private:
         RaptorQuery query;
         int currentRound;
-        vector<int> previousEarliestArrivalTimes;
+        TimeLabels previousEarliestArrivalTimes;
         vector<bool> previousMarkedStops;
         
         vector<int> minStopSequencePerRoute;
@@ -186,14 +372,14 @@ class RaptorBound {
 
         int currentBest;
         Optimization optimization;
+        shared_ptr<MeetingPointObjective> objective;
 
-        map<int, vector<int>> sourceStopIdsToAllStops;
-        vector<int> sourceStopIds;
+        shared_ptr<CliqueHeuristic> cliqueHeuristic;
+        int sourceIndex;
         int numberOfSourceStopIds;
-        double baseHeuristic;
-        vector<int> closestLandmarkIndices;
 
-        vector<int> heuristicPerStopId;
+        // the heuristics are calculated on demand, INT_MAX if they aren't calculated yet
+        TimeLabels heuristicPerStopId;
 
         void initializeRaptorBound();
         void fillQ();
@@ -201,9 +387,16 @@ class RaptorBound {
         TripInfo getEarliestTripWithDayOffset(int routeId, int stopId, int stopSequence);
 };
 
-class RaptorPQ {
+typedef BasicRaptorBound<ArrivalTimeLabels> RaptorBound;
+
+/*
+    The raptor algorithm that expands the routes in the order of their lower bounds. The template parameter is the type of the 
+    arrival time and heuristic labels.
+*/
+template <typename TimeLabels>
+class BasicRaptorPQ {
     public:
-        explicit RaptorPQ(RaptorQuery query, Optimization optimization){
+        explicit BasicRaptorPQ(RaptorQuery query, Optimization optimization){
             this->query = query;
             this->optimization = optimization;
             this->currentBest = INT_MAX;
@@ -217,19 +410,27 @@ class RaptorPQ {
             this->lowerBoundAbsDifference = 0;
             this->lowerBoundRelDifference = 0;
         };
-        ~RaptorPQ(){};
+        ~BasicRaptorPQ(){};
 
         void initializeRaptorPQ();
-        void transformRaptorToRaptorPQ(shared_ptr<Raptor> raptor);
+        void transformRaptorToRaptorPQ(shared_ptr<BasicRaptor<TimeLabels>> raptor);
         void setCurrentBest(int currentBest);
-        void initializeHeuristic(map<int, vector<int>> sourceStopIdsToAllStops, vector<int> sourceStopIds, int baseHeuristic, vector<int> closestLandmarkIndices);
+        void setSharedUpperBound(shared_ptr<SharedUpperBound> sharedUpperBound);
+        void initializeHeuristic(shared_ptr<CliqueHeuristic> cliqueHeuristic, int sourceIndex, int numberOfSourceStopIds);
+        void setObjective(shared_ptr<MeetingPointObjective> objective);
         void processRaptorPQ();
+        vector<pair<int, int>> takeRouteBatch(int numberOfRoutes);
+        void traverseRouteBatch(vector<pair<int, int>> routes);
+        double getLowestLowerBound();
         bool isFinished();
 
-        vector<int>* getEarliestArrivalTimes();
+        vector<int> getEarliestArrivalTimes();
         int getEarliestArrivalTime(int stopId);
+        size_t getMemoryUsageOfLabels();
         Journey createJourney(int targetStopId);
 
+        vector<int> reachedStopIds;
+
         double numberOfExpandedRoutes;
         double lowerBoundSmallerCounter;
         double lowerBoundGreaterCounter;
@@ -254,28 +455,36 @@ class RaptorPQ {
         vector<set<int>> markedStopsPerRoute;
 
         int currentBest;
+        shared_ptr<SharedUpperBound> sharedUpperBound;
         Optimization optimization;
+        shared_ptr<MeetingPointObjective> objective;
 
-        vector<int> earliestArrivalTimes;
+        TimeLabels earliestArrivalTimes;
 
         bool isFinishedFlag;
 
         vector<JourneyPointerRaptor> journeyPointers;
         vector<int> extendedSourceStopIds;
 
-        map<int, vector<int>> sourceStopIdsToAllStops;
-        vector<int> sourceStopIds;
+        shared_ptr<CliqueHeuristic> cliqueHeuristic;
+        int sourceIndex;
         int numberOfSourceStopIds;
-        double baseHeuristic;
-        vector<int> closestLandmarkIndices;
 
-        vector<int> heuristicPerStopId;
+        // the heuristics are calculated on demand, INT_MAX if they aren't calculated yet
+        TimeLabels heuristicPerStopId;
+
+        // guards the queue and the labels while several threads traverse route batches of this raptor
+        mutex engineLock;
         
         void traverseRoute();
+        set<int> scanRoute(int routeId, int firstStopSequence, int arrivalTimeLimit, bool lockLabels);
+        int getArrivalTimeLimit();
         void addRoutesToQueue(set<int> stopIds, int excludeRouteId);
         TripInfo getEarliestTripWithDayOffset(int routeId, int stopId, int stopSequence, int previousEarliestArrivalTime);
 };
 
+typedef BasicRaptorPQ<ArrivalTimeLabels> RaptorPQ;
+
 class RaptorPQParallel {
     public:
         explicit RaptorPQParallel(vector<RaptorQuery> queries, Optimization optimization){
@@ -300,6 +509,8 @@ class RaptorPQParallel {
         vector<int> getEarliestArrivalTimes(int stopId);
         vector<Journey> createJourneys(int targetStopId);
 
+        shared_ptr<MeetingPointAggregator> meetingPointAggregator;
+
         double numberOfExpandedRoutes;
 
         double durationInitHeuristic;
@@ -337,7 +548,7 @@ class RaptorPQParallel {
         set<int> getNewRoutes(set<int> stopIds, int excludeRouteId, int raptorIndex);
         void addRoutesToQueue(set<int> routes, int raptorIndex);
         TripInfo getEarliestTripWithDayOffset(int routeId, int stopId, int stopSequence, int previousEarliestArrivalTime);
-        void updateCurrentBest(set<int> stopIds);
+        void updateCurrentBest();
 };
 
 class RaptorBoundStar {